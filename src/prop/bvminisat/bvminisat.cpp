@@ -45,6 +45,11 @@ void BVMinisatSatSolver::setNotify(Notify* notify) {
   d_minisat->setNotify(d_minisatNotify);
 }
 
+/**
+ * All the clauses are permanent, removable is ignored: the bit-blasted
+ * definitions are guarded by the marker literals of their atoms, so they
+ * stay valid (and are reused) across user context pops.
+ */
 void BVMinisatSatSolver::addClause(SatClause& clause, bool removable) {
   Debug("sat::minisat") << "Add clause " << clause <<"\n";
   BVMinisat::vec<BVMinisat::Lit> minisat_clause;
@@ -88,6 +93,14 @@ void BVMinisatSatSolver::popAssumption() {
   d_minisat->popAssumption();
 }
 
+SatValue BVMinisatSatSolver::solveAssumptions(const SatClause& assumptions, unsigned conflictBudget) {
+  BVMinisat::vec<BVMinisat::Lit> minisat_assumptions;
+  for (unsigned i = 0; i < assumptions.size(); ++i) {
+    minisat_assumptions.push(toMinisatLit(assumptions[i]));
+  }
+  return toSatLiteralValue(d_minisat->solveAssumptions(minisat_assumptions, conflictBudget));
+}
+
 SatVariable BVMinisatSatSolver::newVar(bool freeze){
   return d_minisat->newVar(true, true, freeze);
 }
@@ -120,6 +120,8 @@ public:
   
   void popAssumption();
 
+  SatValue solveAssumptions(const SatClause& assumptions, unsigned conflictBudget);
+
   class Statistics {
   public:
     ReferenceStat<uint64_t> d_statStarts, d_statDecisions;
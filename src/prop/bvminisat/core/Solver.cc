@@ -111,6 +111,7 @@ Solver::Solver(CVC4::context::Context* c) :
 
   , need_to_propagate(false)
   , only_bcp(false)
+  , solving_subset(false)
   , clause_added(false)
   , ok                 (true)
   , cla_inc            (1)
@@ -509,7 +510,7 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
     assigns[var(p)] = lbool(!sign(p));
     vardata[var(p)] = mkVarData(from, decisionLevel());
     trail.push_(p);
-    if (decisionLevel() <= assumptions.size() && marker[var(p)] == 1) {
+    if (decisionLevel() <= assumptions.size() && marker[var(p)] == 1 && !solving_subset) {
       if (notify) {
         Debug("bvminisat::explain") << OUTPUT_TAG << "propagating " << p << std::endl;
         notify->notify(p);
@@ -529,6 +530,44 @@ lbool Solver::propagateAssumptions() {
   return search(-1);
 }
 
+lbool Solver::solveAssumptions(const vec<Lit>& assumps, int64_t confBudget) {
+  vec<Lit> asserted;
+  assumptions.copyTo(asserted);
+
+  cancelUntil(0);
+  assumps.copyTo(assumptions);
+  only_bcp = false;
+  solving_subset = true;
+  setConfBudget(confBudget);
+
+  lbool result = l_Undef;
+  try {
+    result = solve_();
+  } catch (const CVC4::theory::Interrupted& e) {
+    solving_subset = false;
+    budgetOff();
+    cancelUntil(0);
+    asserted.copyTo(assumptions);
+    throw;
+  }
+
+  solving_subset = false;
+  budgetOff();
+
+  // put the asserted assumptions back on the trail, as the explanations of
+  // the literals propagated so far are computed from it
+  vec<Lit> subsetConflict;
+  conflict.copyTo(subsetConflict);
+  cancelUntil(0);
+  asserted.copyTo(assumptions);
+  if (ok && assumptions.size() > 0) {
+    propagateAssumptions();
+  }
+  subsetConflict.copyTo(conflict);
+
+  return result;
+}
+
 lbool Solver::assertAssumption(Lit p, bool propagate) {
   
   // assert(marker[var(p)] == 1);
@@ -108,6 +108,8 @@ public:
     lbool   assertAssumption(Lit p, bool propagate);  // Assert a new assumption, start BCP if propagate = true
     lbool   propagateAssumptions();                   // Do BCP over asserted assumptions
     void    popAssumption();                          // Pop an assumption
+    lbool   solveAssumptions(const vec<Lit>& assumps, int64_t confBudget); // Search under the given assumptions instead of the
+                                                                            // asserted ones, within the given number of conflicts
 
     void    toDimacs     (FILE* f, const vec<Lit>& assumps);            // Write CNF to file in DIMACS-format.
     void    toDimacs     (const char *file, const vec<Lit>& assumps);
@@ -194,6 +196,7 @@ public:
 
     bool need_to_propagate;             // true if we added new clauses, set to true in propagation 
     bool only_bcp;                      // solving mode in which only boolean constraint propagation is done
+    bool solving_subset;                // solving under assumptions other than the asserted ones, no theory propagation
     void setOnlyBCP (bool val) { only_bcp = val;}
     void explain(Lit l, std::vector<Lit>& explanation);
 
@@ -109,6 +109,14 @@ public:
 
   virtual void popAssumption() = 0;
 
+  /**
+   * Solves under the given assumptions instead of the asserted ones, giving
+   * up after conflictBudget conflicts. The asserted assumptions are kept,
+   * and on SAT_VALUE_FALSE getUnsatCore() returns a subset of the given
+   * ones. Used to minimize unsat cores.
+   */
+  virtual SatValue solveAssumptions(const SatClause& assumptions, unsigned conflictBudget) = 0;
+
 };/* class BVSatSolverInterface */
 
 
@@ -114,6 +114,10 @@ struct SmtEngineStatistics {
   IntStat d_numConstantProps;
   /** time spent in static learning */
   TimerStat d_staticLearningTime;
+  /** time spent in quantifiers macro expansion */
+  TimerStat d_quantMacrosTime;
+  /** Num of quantifiers eliminated by macro expansion */
+  IntStat d_numQuantMacrosEliminated;
   /** time spent in simplifying ITEs */
   TimerStat d_simpITETime;
   /** time spent in simplifying ITEs */
@@ -137,6 +141,8 @@ struct SmtEngineStatistics {
     d_nonclausalSimplificationTime("smt::SmtEngine::nonclausalSimplificationTime"),
     d_numConstantProps("smt::SmtEngine::numConstantProps", 0),
     d_staticLearningTime("smt::SmtEngine::staticLearningTime"),
+    d_quantMacrosTime("smt::SmtEngine::quantMacrosTime"),
+    d_numQuantMacrosEliminated("smt::SmtEngine::numQuantMacrosEliminated", 0),
     d_simpITETime("smt::SmtEngine::simpITETime"),
     d_unconstrainedSimpTime("smt::SmtEngine::unconstrainedSimpTime"),
     d_iteRemovalTime("smt::SmtEngine::iteRemovalTime"),
@@ -151,6 +157,8 @@ struct SmtEngineStatistics {
     StatisticsRegistry::registerStat(&d_nonclausalSimplificationTime);
     StatisticsRegistry::registerStat(&d_numConstantProps);
     StatisticsRegistry::registerStat(&d_staticLearningTime);
+    StatisticsRegistry::registerStat(&d_quantMacrosTime);
+    StatisticsRegistry::registerStat(&d_numQuantMacrosEliminated);
     StatisticsRegistry::registerStat(&d_simpITETime);
     StatisticsRegistry::registerStat(&d_unconstrainedSimpTime);
     StatisticsRegistry::registerStat(&d_iteRemovalTime);
@@ -167,6 +175,8 @@ struct SmtEngineStatistics {
     StatisticsRegistry::unregisterStat(&d_nonclausalSimplificationTime);
     StatisticsRegistry::unregisterStat(&d_numConstantProps);
     StatisticsRegistry::unregisterStat(&d_staticLearningTime);
+    StatisticsRegistry::unregisterStat(&d_quantMacrosTime);
+    StatisticsRegistry::unregisterStat(&d_numQuantMacrosEliminated);
     StatisticsRegistry::unregisterStat(&d_simpITETime);
     StatisticsRegistry::unregisterStat(&d_unconstrainedSimpTime);
     StatisticsRegistry::unregisterStat(&d_iteRemovalTime);
@@ -860,6 +870,11 @@ void SmtEngine::setLogicInternal() throw() {
     Trace("smt") << "setting arith arithPivotThreshold  " << pivotThreshold << std::endl;
     options::arithPivotThreshold.set(pivotThreshold);
   }
+  if(! options::arithDifferenceLogic.wasSetByUser()){
+    bool differenceLogic = d_logic.isPure(THEORY_ARITH) && d_logic.isDifferenceLogic() && !d_logic.isQuantified();
+    Trace("smt") << "setting arith difference logic solver " << differenceLogic << std::endl;
+    options::arithDifferenceLogic.set(differenceLogic);
+  }
   if(! options::arithStandardCheckVarOrderPivots.wasSetByUser()){
     int16_t varOrderPivots = -1;
     if(d_logic.isPure(THEORY_ARITH) && !d_logic.isQuantified()){
@@ -2186,11 +2201,14 @@ void SmtEnginePrivate::processAssertions() {
   dumpAssertions("post-skolem-quant", d_assertionsToPreprocess);
 
   if( options::macrosQuant() ){
-    //quantifiers macro expansion
+    //quantifiers macro expansion, nested macros are expanded in one pass,
+    //another pass is needed only if new definitions appear
+    TimerStat::CodeTimer codeTimer(d_smt.d_stats->d_quantMacrosTime);
     bool success;
     do{
       QuantifierMacros qm;
       success = qm.simplify( d_assertionsToPreprocess, true );
+      d_smt.d_stats->d_numQuantMacrosEliminated += qm.getNumEliminated();
     }while( success );
   }
 
@@ -0,0 +1,213 @@
+/*********************                                                        */
+/*! \file approx_simplex.cpp
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief A floating point simplex used to guess a feasible basis.
+ **/
+
+#include "theory/arith/approx_simplex.h"
+
+#include <cmath>
+
+using namespace std;
+
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::arith;
+
+/** Coefficients smaller than this are treated as cancelled out. */
+static const double ZERO_TOLERANCE = 1e-11;
+
+/** Bounds are considered satisfied up to this relative tolerance. */
+static const double FEASIBILITY_TOLERANCE = 1e-9;
+
+static inline double tolerance(double bound){
+  return FEASIBILITY_TOLERANCE * max(1.0, fabs(bound));
+}
+
+static inline double toDouble(const DeltaRational& d){
+  return d.getNoninfinitesimalPart().getDouble();
+}
+
+ApproximateSimplex::ApproximateSimplex(const ArithPartialModel& pm, const Tableau& tab) :
+  d_rows(),
+  d_rowBasic(),
+  d_basicRow(tab.getNumColumns(), -1),
+  d_columns(tab.getNumColumns()),
+  d_values(tab.getNumColumns(), 0.0),
+  d_lower(tab.getNumColumns(), 0.0),
+  d_upper(tab.getNumColumns(), 0.0),
+  d_hasLower(tab.getNumColumns(), false),
+  d_hasUpper(tab.getNumColumns(), false),
+  d_pivots(0)
+{
+  for(ArithVar x = 0; x < tab.getNumColumns(); ++x){
+    d_values[x] = toDouble(pm.getAssignment(x));
+    if(pm.hasLowerBound(x)){
+      d_hasLower[x] = true;
+      d_lower[x] = toDouble(pm.getLowerBound(x));
+    }
+    if(pm.hasUpperBound(x)){
+      d_hasUpper[x] = true;
+      d_upper[x] = toDouble(pm.getUpperBound(x));
+    }
+  }
+
+  for(Tableau::BasicIterator i = tab.beginBasic(), i_end = tab.endBasic(); i != i_end; ++i){
+    ArithVar basic = *i;
+    uint32_t r = d_rows.size();
+    d_rows.push_back(ApproxRow());
+    d_rowBasic.push_back(basic);
+    d_basicRow[basic] = r;
+
+    // the tableau row is -basic + sum coeff_i * x_i = 0
+    ApproxRow& row = d_rows.back();
+    for(Tableau::RowIterator j = tab.basicRowIterator(basic); !j.atEnd(); ++j){
+      const Tableau::Entry& entry = *j;
+      ArithVar x = entry.getColVar();
+      if(x == basic) continue;
+      row[x] = entry.getCoefficient().getDouble();
+      d_columns[x].insert(r);
+    }
+  }
+}
+
+bool ApproximateSimplex::belowLower(ArithVar x) const{
+  return d_hasLower[x] && d_values[x] < d_lower[x] - tolerance(d_lower[x]);
+}
+
+bool ApproximateSimplex::aboveUpper(ArithVar x) const{
+  return d_hasUpper[x] && d_values[x] > d_upper[x] + tolerance(d_upper[x]);
+}
+
+bool ApproximateSimplex::canIncrease(ArithVar x) const{
+  return !d_hasUpper[x] || d_values[x] < d_upper[x] - tolerance(d_upper[x]);
+}
+
+bool ApproximateSimplex::canDecrease(ArithVar x) const{
+  return !d_hasLower[x] || d_values[x] > d_lower[x] + tolerance(d_lower[x]);
+}
+
+ArithVar ApproximateSimplex::selectInconsistent() const{
+  ArithVar best = ARITHVAR_SENTINEL;
+  for(uint32_t r = 0; r < d_rows.size(); ++r){
+    ArithVar basic = d_rowBasic[r];
+    if(basic < best && (belowLower(basic) || aboveUpper(basic))){
+      best = basic;
+    }
+  }
+  return best;
+}
+
+ArithVar ApproximateSimplex::selectSlack(ArithVar basic, bool increase) const{
+  const ApproxRow& row = d_rows[d_basicRow[basic]];
+  // the row is ordered by variable, so the first acceptable entry is Bland's choice
+  for(ApproxRow::const_iterator i = row.begin(), i_end = row.end(); i != i_end; ++i){
+    ArithVar x = (*i).first;
+    bool positive = (*i).second > 0;
+    if(positive == increase ? canIncrease(x) : canDecrease(x)){
+      return x;
+    }
+  }
+  return ARITHVAR_SENTINEL;
+}
+
+void ApproximateSimplex::pivotAndUpdate(ArithVar basic, ArithVar nonbasic, double value){
+  uint32_t r = d_basicRow[basic];
+  ApproxRow& row = d_rows[r];
+  Assert(row.find(nonbasic) != row.end());
+  double a = row[nonbasic];
+
+  double theta = (value - d_values[basic]) / a;
+  d_values[basic] = value;
+  d_values[nonbasic] += theta;
+  for(set<uint32_t>::const_iterator i = d_columns[nonbasic].begin(),
+        i_end = d_columns[nonbasic].end(); i != i_end; ++i){
+    if(*i != r){
+      d_values[d_rowBasic[*i]] += d_rows[*i][nonbasic] * theta;
+    }
+  }
+
+  // solve the row for nonbasic
+  ApproxRow pivotRow;
+  pivotRow[basic] = 1.0 / a;
+  for(ApproxRow::const_iterator i = row.begin(), i_end = row.end(); i != i_end; ++i){
+    d_columns[(*i).first].erase(r);
+    if((*i).first != nonbasic){
+      pivotRow[(*i).first] = -(*i).second / a;
+    }
+  }
+
+  // substitute it into the other rows
+  const set<uint32_t> occurrences = d_columns[nonbasic];
+  for(set<uint32_t>::const_iterator k = occurrences.begin(); k != occurrences.end(); ++k){
+    ApproxRow& other = d_rows[*k];
+    double c = other[nonbasic];
+    other.erase(nonbasic);
+    for(ApproxRow::const_iterator i = pivotRow.begin(), i_end = pivotRow.end(); i != i_end; ++i){
+      ArithVar x = (*i).first;
+      double delta = c * (*i).second;
+      ApproxRow::iterator f = other.find(x);
+      if(f == other.end()){
+        if(fabs(delta) > ZERO_TOLERANCE){
+          other[x] = delta;
+          d_columns[x].insert(*k);
+        }
+      }else{
+        (*f).second += delta;
+        if(fabs((*f).second) <= ZERO_TOLERANCE){
+          other.erase(f);
+          d_columns[x].erase(*k);
+        }
+      }
+    }
+  }
+  d_columns[nonbasic].clear();
+
+  row.swap(pivotRow);
+  for(ApproxRow::const_iterator i = row.begin(), i_end = row.end(); i != i_end; ++i){
+    d_columns[(*i).first].insert(r);
+  }
+  d_rowBasic[r] = nonbasic;
+  d_basicRow[nonbasic] = r;
+  d_basicRow[basic] = -1;
+  ++d_pivots;
+}
+
+bool ApproximateSimplex::findFeasibleBasis(uint32_t maxPivots){
+  while(d_pivots < maxPivots){
+    ArithVar basic = selectInconsistent();
+    if(basic == ARITHVAR_SENTINEL){
+      return true;
+    }
+
+    bool increase = belowLower(basic);
+    ArithVar nonbasic = selectSlack(basic, increase);
+    if(nonbasic == ARITHVAR_SENTINEL){
+      // infeasible up to the precision used, the exact search has to find the conflict
+      Debug("arith::approx") << "approx: row of " << basic << " looks infeasible" << endl;
+      return false;
+    }
+    pivotAndUpdate(basic, nonbasic, increase ? d_lower[basic] : d_upper[basic]);
+  }
+  return selectInconsistent() == ARITHVAR_SENTINEL;
+}
+
+ApproximateSimplex::VarState ApproximateSimplex::getState(ArithVar x) const{
+  if(d_basicRow[x] >= 0){
+    return Basic;
+  }else if(d_hasLower[x] && fabs(d_values[x] - d_lower[x]) <= tolerance(d_lower[x])){
+    return AtLower;
+  }else if(d_hasUpper[x] && fabs(d_values[x] - d_upper[x]) <= tolerance(d_upper[x])){
+    return AtUpper;
+  }else{
+    return Between;
+  }
+}
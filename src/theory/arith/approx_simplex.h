@@ -0,0 +1,101 @@
+/*********************                                                        */
+/*! \file approx_simplex.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief A floating point simplex used to guess a feasible basis.
+ **
+ ** A floating point simplex used to guess a feasible basis.
+ ** The tableau and the bounds of the exact simplex are copied into a
+ ** double precision shadow, and a feasibility search using Bland's rule is
+ ** run on the shadow. The result is only a guess: the final basis and the
+ ** bound each nonbasic variable sits at are handed back to the exact
+ ** SimplexDecisionProcedure, which re-establishes them with exact pivots
+ ** and then checks (and if needed repairs) the assignment in rationals.
+ **/
+
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__ARITH__APPROX_SIMPLEX_H
+#define __CVC4__THEORY__ARITH__APPROX_SIMPLEX_H
+
+#include "theory/arith/arithvar.h"
+#include "theory/arith/matrix.h"
+#include "theory/arith/partial_model.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace CVC4 {
+namespace theory {
+namespace arith {
+
+class ApproximateSimplex {
+public:
+  /** Where a variable ended up in the approximate solution. */
+  enum VarState { Basic, AtLower, AtUpper, Between };
+
+private:
+  /** Row of a basic variable: basic = \f$\sum_i\f$ coeff_i * nonbasic_i. */
+  typedef std::map<ArithVar, double> ApproxRow;
+
+  std::vector<ApproxRow> d_rows;
+  std::vector<ArithVar> d_rowBasic;
+
+  /** ArithVar |-> the row it is basic in, or -1 */
+  std::vector<int> d_basicRow;
+
+  /** ArithVar |-> the rows the nonbasic variable occurs in */
+  std::vector< std::set<uint32_t> > d_columns;
+
+  std::vector<double> d_values;
+  std::vector<double> d_lower, d_upper;
+  std::vector<bool> d_hasLower, d_hasUpper;
+
+  uint32_t d_pivots;
+
+  bool belowLower(ArithVar x) const;
+  bool aboveUpper(ArithVar x) const;
+  bool canIncrease(ArithVar x) const;
+  bool canDecrease(ArithVar x) const;
+
+  /** Returns the smallest basic variable violating a bound by more than the tolerance. */
+  ArithVar selectInconsistent() const;
+
+  /**
+   * Returns the smallest nonbasic variable in the row of basic that can be
+   * moved to increase (or decrease) basic, or ARITHVAR_SENTINEL.
+   */
+  ArithVar selectSlack(ArithVar basic, bool increase) const;
+
+  /** Sets basic to value and makes nonbasic basic in its row. */
+  void pivotAndUpdate(ArithVar basic, ArithVar nonbasic, double value);
+
+public:
+  ApproximateSimplex(const ArithPartialModel& pm, const Tableau& tab);
+
+  /**
+   * Runs the double precision feasibility search for at most maxPivots pivots.
+   * Returns true if every variable is within its bounds up to the tolerance.
+   */
+  bool findFeasibleBasis(uint32_t maxPivots);
+
+  /** Returns where x ended up after findFeasibleBasis(). */
+  VarState getState(ArithVar x) const;
+
+  uint32_t getPivots() const { return d_pivots; }
+};/* class ApproximateSimplex */
+
+}/* CVC4::theory::arith namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__ARITH__APPROX_SIMPLEX_H */
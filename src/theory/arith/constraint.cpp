@@ -76,7 +76,7 @@ ConstraintValue::ConstraintValue(ArithVar x,  ConstraintType t, const DeltaRatio
     d_witness(TNode::null()),
     d_proof(ProofIdSentinel),
     d_split(false),
-    d_variablePosition()
+    d_valueCollection(NULL)
 {
   Assert(!initialized());
 }
@@ -304,14 +304,67 @@ Constraint ValueCollection::nonNull() const{
   }
 }
 
+SortedConstraintMap::~SortedConstraintMap(){
+  for(iterator i = begin(), i_end = end(); i != i_end; ++i){
+    delete i->second;
+  }
+}
+
+void SortedConstraintMap::flush() const{
+  if(d_sorted < d_entries.size()){
+    iterator mid = d_entries.begin() + d_sorted;
+    std::sort(mid, d_entries.end(), EntryLessThanValue());
+    std::inplace_merge(d_entries.begin(), mid, d_entries.end(), EntryLessThanValue());
+    d_sorted = d_entries.size();
+  }
+}
+
+std::pair<ValueCollection*, bool> SortedConstraintMap::insert(const DeltaRational& r){
+  if(d_sorted == d_entries.size() &&
+     (d_entries.empty() || d_entries.back().first < r)){
+    ValueCollection* vc = new ValueCollection();
+    d_entries.push_back(Entry(r, vc));
+    d_sorted = d_entries.size();
+    return make_pair(vc, true);
+  }
+
+  iterator sortedEnd = d_entries.begin() + d_sorted;
+  iterator pos = std::lower_bound(d_entries.begin(), sortedEnd, r, EntryLessThanValue());
+  if(pos != sortedEnd && pos->first == r){
+    return make_pair(pos->second, false);
+  }
+  for(iterator i = sortedEnd, i_end = d_entries.end(); i != i_end; ++i){
+    if(i->first == r){
+      return make_pair(i->second, false);
+    }
+  }
+
+  ValueCollection* vc = new ValueCollection();
+  d_entries.push_back(Entry(r, vc));
+  if(d_entries.size() - d_sorted > s_maxPending){
+    flush();
+  }
+  return make_pair(vc, true);
+}
+
+void SortedConstraintMap::erase(const DeltaRational& r){
+  flush();
+  iterator pos = std::lower_bound(d_entries.begin(), d_entries.end(), r, EntryLessThanValue());
+  Assert(pos != d_entries.end() && pos->first == r);
+  Assert(pos->second->empty());
+  delete pos->second;
+  d_entries.erase(pos);
+  d_sorted = d_entries.size();
+}
+
 bool ConstraintValue::initialized() const {
   return d_database != NULL;
 }
 
-void ConstraintValue::initialize(ConstraintDatabase* db, SortedConstraintMapIterator v, Constraint negation){
+void ConstraintValue::initialize(ConstraintDatabase* db, ValueCollection* vc, Constraint negation){
   Assert(!initialized());
   d_database = db;
-  d_variablePosition = v;
+  d_valueCollection = vc;
   d_negation = negation;
 }
 
@@ -319,7 +372,7 @@ ConstraintValue::~ConstraintValue() {
   Assert(safeToGarbageCollect());
 
   if(initialized()){
-    ValueCollection& vc =  d_variablePosition->second;
+    ValueCollection& vc = *d_valueCollection;
     Debug("arith::constraint") << "removing" << vc << endl;
 
     vc.remove(getType());
@@ -327,7 +380,7 @@ ConstraintValue::~ConstraintValue() {
     if(vc.empty()){
       Debug("arith::constraint") << "erasing" << vc << endl;
       SortedConstraintMap& perVariable = d_database->getVariableSCM(getVariable());
-      perVariable.erase(d_variablePosition);
+      perVariable.erase(getValue());
     }
 
     if(hasLiteral()){
@@ -337,7 +390,7 @@ ConstraintValue::~ConstraintValue() {
 }
 
 const ValueCollection& ConstraintValue::getValueCollection() const{
-  return d_variablePosition->second;
+  return *d_valueCollection;
 }
 
 Constraint ConstraintValue::getCeiling() {
@@ -494,33 +547,28 @@ Constraint ConstraintDatabase::getConstraint(ArithVar v, ConstraintType t, const
   //This must always return a constraint.
 
   SortedConstraintMap& scm = getVariableSCM(v);
-  pair<SortedConstraintMapIterator, bool> insertAttempt;
-  insertAttempt = scm.insert(make_pair(r, ValueCollection()));
-
-  SortedConstraintMapIterator pos = insertAttempt.first;
-  ValueCollection& vc = pos->second;
-  if(vc.hasConstraintOfType(t)){
-    return vc.getConstraintOfType(t);
+  ValueCollection* vc = scm.insert(r).first;
+  if(vc->hasConstraintOfType(t)){
+    return vc->getConstraintOfType(t);
   }else{
     Constraint c = new ConstraintValue(v, t, r);
     Constraint negC = ConstraintValue::makeNegation(v, t, r);
 
-    SortedConstraintMapIterator negPos;
+    ValueCollection* negVC;
     if(t == Equality || t == Disequality){
-      negPos = pos;
+      negVC = vc;
     }else{
-      pair<SortedConstraintMapIterator, bool> negInsertAttempt;
-      negInsertAttempt = scm.insert(make_pair(negC->getValue(), ValueCollection()));
+      pair<ValueCollection*, bool> negInsertAttempt = scm.insert(negC->getValue());
       Assert(negInsertAttempt.second
-             || ! negInsertAttempt.first->second.hasConstraintOfType(negC->getType()));
-      negPos = negInsertAttempt.first;
+             || ! negInsertAttempt.first->hasConstraintOfType(negC->getType()));
+      negVC = negInsertAttempt.first;
     }
 
-    c->initialize(this, pos, negC);
-    negC->initialize(this, negPos, c);
+    c->initialize(this, vc, negC);
+    negC->initialize(this, negVC, c);
 
-    vc.add(c);
-    negPos->second.add(negC);
+    vc->add(c);
+    negVC->add(negC);
 
     return c;
   }
@@ -544,7 +592,7 @@ ConstraintDatabase::~ConstraintDatabase(){
     SortedConstraintMap& scm = back->d_constraints;
     SortedConstraintMapIterator i = scm.begin(), i_end = scm.end();
     for(; i != i_end; ++i){
-      (i->second).push_into(constraintList);
+      (i->second)->push_into(constraintList);
     }
     while(!constraintList.empty()){
       Constraint c = constraintList.back();
@@ -579,7 +627,7 @@ void ConstraintDatabase::addVariable(ArithVar v){
     std::vector<Constraint> constraintList;
 
     for(SortedConstraintMapIterator i = scm.begin(), end = scm.end(); i != end; ++i){
-      (i->second).push_into(constraintList);
+      (i->second)->push_into(constraintList);
     }
     while(!constraintList.empty()){
       Constraint c = constraintList.back();
@@ -680,17 +728,14 @@ Constraint ConstraintDatabase::addLiteral(TNode literal){
   Debug("arith::constraint") << "addliteral( posC ->" << posC << ")" << endl;
 
   SortedConstraintMap& scm = getVariableSCM(posC->getVariable());
-  pair<SortedConstraintMapIterator, bool> insertAttempt;
-  insertAttempt = scm.insert(make_pair(posC->getValue(), ValueCollection()));
-
-  SortedConstraintMapIterator posI = insertAttempt.first;
-  // If the attempt succeeds, i points to a new empty ValueCollection
-  // If the attempt fails, i points to a pre-existing ValueCollection
+  ValueCollection* posVC = scm.insert(posC->getValue()).first;
+  // If the insertion succeeds, posVC is a new empty ValueCollection
+  // If the insertion fails, posVC is a pre-existing ValueCollection
 
-  if(posI->second.hasConstraintOfType(posC->getType())){
+  if(posVC->hasConstraintOfType(posC->getType())){
     //This is the situation where the Constraint exists, but
     //the literal has not been  associated with it.
-    Constraint hit = posI->second.getConstraintOfType(posC->getType());
+    Constraint hit = posVC->getConstraintOfType(posC->getType());
     Debug("arith::constraint") << "hit " << hit << endl;
     Debug("arith::constraint") << "posC " << posC << endl;
 
@@ -707,15 +752,14 @@ Constraint ConstraintDatabase::addLiteral(TNode literal){
 
     Constraint negC = new ConstraintValue(v, negType, negDR);
 
-    SortedConstraintMapIterator negI;
+    ValueCollection* negVC;
 
     if(posC->isEquality()){
-      negI = posI;
+      negVC = posVC;
     }else{
       Assert(posC->isLowerBound() || posC->isUpperBound());
 
-      pair<SortedConstraintMapIterator, bool> negInsertAttempt;
-      negInsertAttempt = scm.insert(make_pair(negC->getValue(), ValueCollection()));
+      pair<ValueCollection*, bool> negInsertAttempt = scm.insert(negC->getValue());
 
       Debug("nf::tmp") << "sdhjfgdhjkldfgljkhdfg" << endl;
       Debug("nf::tmp") << negC << endl;
@@ -724,14 +768,14 @@ Constraint ConstraintDatabase::addLiteral(TNode literal){
       //This should always succeed as the DeltaRational for the negation is unique!
       Assert(negInsertAttempt.second);
 
-      negI = negInsertAttempt.first;
+      negVC = negInsertAttempt.first;
     }
 
-    (posI->second).add(posC);
-    (negI->second).add(negC);
+    posVC->add(posC);
+    negVC->add(negC);
 
-    posC->initialize(this, posI, negC);
-    negC->initialize(this, negI, posC);
+    posC->initialize(this, posVC, negC);
+    negC->initialize(this, negVC, posC);
 
     posC->setLiteral(atomNode);
     negC->setLiteral(negationNode);
@@ -900,6 +944,13 @@ SortedConstraintMap& ConstraintValue::constraintSet() const{
   return (d_database->d_varDatabases[d_variable])->d_constraints;
 }
 
+SortedConstraintMapConstIterator ConstraintValue::variablePosition() const{
+  const SortedConstraintMap& scm = constraintSet();
+  SortedConstraintMapConstIterator i = scm.find(d_value);
+  Assert(i != scm.end() && i->second == d_valueCollection);
+  return i;
+}
+
 bool ConstraintValue::proofIsEmpty() const{
   Assert(hasProof());
   bool result = d_database->d_proofs[d_proof] == NullConstraint;
@@ -973,12 +1024,12 @@ Constraint ConstraintValue::getStrictlyWeakerLowerBound(bool hasLiteral, bool as
   Assert(initialized());
   Assert(!asserted || hasLiteral);
 
-  SortedConstraintMapConstIterator i = d_variablePosition;
+  SortedConstraintMapConstIterator i = variablePosition();
   const SortedConstraintMap& scm = constraintSet();
   SortedConstraintMapConstIterator i_begin = scm.begin();
   while(i != i_begin){
     --i;
-    const ValueCollection& vc = i->second;
+    const ValueCollection& vc = *(i->second);
     if(vc.hasLowerBound()){
       Constraint weaker = vc.getLowerBound();
 
@@ -995,13 +1046,13 @@ Constraint ConstraintValue::getStrictlyWeakerLowerBound(bool hasLiteral, bool as
 }
 
 Constraint ConstraintValue::getStrictlyWeakerUpperBound(bool hasLiteral, bool asserted) const {
-  SortedConstraintMapConstIterator i = d_variablePosition;
+  SortedConstraintMapConstIterator i = variablePosition();
   const SortedConstraintMap& scm = constraintSet();
   SortedConstraintMapConstIterator i_end = scm.end();
 
   ++i;
   for(; i != i_end; ++i){
-    const ValueCollection& vc = i->second;
+    const ValueCollection& vc = *(i->second);
     if(vc.hasUpperBound()){
       Constraint weaker = vc.getUpperBound();
       if((!hasLiteral || (weaker->hasLiteral())) &&
@@ -1025,7 +1076,7 @@ Constraint ConstraintDatabase::getBestImpliedBound(ArithVar v, ConstraintType t,
     Assert(i == i_end || r <= i->first);
     for(; i != i_end; i++){
       Assert(r <= i->first);
-      const ValueCollection& vc = i->second;
+      const ValueCollection& vc = *(i->second);
       if(vc.hasUpperBound()){
         return vc.getUpperBound();
       }
@@ -1058,7 +1109,7 @@ Constraint ConstraintDatabase::getBestImpliedBound(ArithVar v, ConstraintType t,
       do{
         Debug("getBestImpliedBound") << fdj++ << " " << r << " " << i->first << endl;
         Assert(r >= i->first);
-        const ValueCollection& vc = i->second;
+        const ValueCollection& vc = *(i->second);
 
         if(vc.hasLowerBound()){
           return vc.getLowerBound();
@@ -1137,7 +1188,7 @@ void ConstraintDatabase::outputUnateInequalityLemmas(std::vector<Node>& out, Ari
   //get transitive unates
   //Only lower bounds or upperbounds should be done.
   for(; scm_iter != scm_end; ++scm_iter){
-    const ValueCollection& vc = scm_iter->second;
+    const ValueCollection& vc = *(scm_iter->second);
     if(vc.hasUpperBound()){
       Constraint ub = vc.getUpperBound();
       if(ub->hasLiteral()){
@@ -1159,7 +1210,7 @@ void ConstraintDatabase::outputUnateEqualityLemmas(std::vector<Node>& out, Arith
   SortedConstraintMapConstIterator scm_end = scm.end();
 
   for(; scm_iter != scm_end; ++scm_iter){
-    const ValueCollection& vc = scm_iter->second;
+    const ValueCollection& vc = *(scm_iter->second);
     if(vc.hasEquality()){
       Constraint eq = vc.getEquality();
       if(eq->hasLiteral()){
@@ -1240,7 +1291,7 @@ void ConstraintDatabase::unatePropLowerBound(Constraint curr, Constraint prev){
 
   const SortedConstraintMap& scm = curr->constraintSet();
   const SortedConstraintMapConstIterator scm_begin = scm.begin();
-  SortedConstraintMapConstIterator scm_i = curr->d_variablePosition;
+  SortedConstraintMapConstIterator scm_i = curr->variablePosition();
 
   //Ignore the first ValueCollection
   // NOPE: (>= p c) then (= p c) NOPE
@@ -1249,7 +1300,7 @@ void ConstraintDatabase::unatePropLowerBound(Constraint curr, Constraint prev){
   while(scm_i != scm_begin){
     --scm_i; // move the iterator back
 
-    const ValueCollection& vc = scm_i->second;
+    const ValueCollection& vc = *(scm_i->second);
 
     //If it has the previous element, do nothing and stop!
     if(hasPrev &&
@@ -1298,10 +1349,10 @@ void ConstraintDatabase::unatePropUpperBound(Constraint curr, Constraint prev){
 
   const SortedConstraintMap& scm = curr->constraintSet();
   const SortedConstraintMapConstIterator scm_end = scm.end();
-  SortedConstraintMapConstIterator scm_i = curr->d_variablePosition;
+  SortedConstraintMapConstIterator scm_i = curr->variablePosition();
   ++scm_i;
   for(; scm_i != scm_end; ++scm_i){
-    const ValueCollection& vc = scm_i->second;
+    const ValueCollection& vc = *(scm_i->second);
 
     //If it has the previous element, do nothing and stop!
     if(hasPrev &&
@@ -1350,11 +1401,11 @@ void ConstraintDatabase::unatePropEquality(Constraint curr, Constraint prevLB, C
   ++d_statistics.d_unatePropagateCalls;
 
   const SortedConstraintMap& scm = curr->constraintSet();
-  SortedConstraintMapConstIterator scm_curr = curr->d_variablePosition;
-  SortedConstraintMapConstIterator scm_last = hasPrevUB ? prevUB->d_variablePosition : scm.end();
+  SortedConstraintMapConstIterator scm_curr = curr->variablePosition();
+  SortedConstraintMapConstIterator scm_last = hasPrevUB ? prevUB->variablePosition() : scm.end();
   SortedConstraintMapConstIterator scm_i;
   if(hasPrevLB){
-    scm_i = prevLB->d_variablePosition;
+    scm_i = prevLB->variablePosition();
     if(scm_i != scm_curr){ // If this does not move this past scm_curr, move it one forward
       ++scm_i;
     }
@@ -1364,7 +1415,7 @@ void ConstraintDatabase::unatePropEquality(Constraint curr, Constraint prevLB, C
 
   for(; scm_i != scm_curr; ++scm_i){
     // between the previous LB and the curr
-    const ValueCollection& vc = scm_i->second;
+    const ValueCollection& vc = *(scm_i->second);
 
     //Don't worry about implying the negation of upperbound.
     //These should all be handled by propagating the LowerBounds!
@@ -1399,7 +1450,7 @@ void ConstraintDatabase::unatePropEquality(Constraint curr, Constraint prevLB, C
 
   for(; scm_i != scm_last; ++scm_i){
     // between the curr and the previous UB imply the upperbounds and disequalities.
-    const ValueCollection& vc = scm_i->second;
+    const ValueCollection& vc = *(scm_i->second);
 
     //Don't worry about implying the negation of upperbound.
     //These should all be handled by propagating the UpperBounds!
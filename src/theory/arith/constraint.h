@@ -27,8 +27,8 @@
  **
  ** In addition, Constraints keep track of the following:
  **  - A Constrain that is the negation of the Constraint.
- **  - An iterator into a set of Constraints for the ArithVar sorted by
- **    DeltaRational value.
+ **  - The collection of Constraints for the ArithVar with the same
+ **    DeltaRational value, which is in a set sorted by DeltaRational value.
  **  - A context dependent internal proof of the node that can be used for
  **    explanations.
  **  - Whether an equality/disequality has been split in the user context via a
@@ -39,21 +39,25 @@
  **  - All of the Constraints with associated nodes in the ConstraintDatabase can
  **    be accessed via a single hashtable lookup until the Constraint is removed.
  **  - Nodes that have not been associated to a constraints can be
- **    inserted/associated to existing nodes in O(log n) time.
+ **    inserted/associated to existing nodes in O(log n + k) time, where k is
+ **    the number of constraints whose insertion is still pending.
  **
  ** Implications:
  **  - A Constraint can be used to find unate implications.
  **  - A unate implication is an implication based purely on the ArithVar matching
  **    and the DeltaRational value.
  **    (implies (<= x c) (<= x d)) given c <= d
- **  - This is done using the iterator into the sorted set of constraints.
+ **  - This is done by a binary search for the value in the sorted set of
+ **    constraints.
  **  - Given a tight constraint and previous tightest constraint, this will
  **    efficiently propagate internally.
  **
  ** Additing and Removing Constraints
- **  - Adding Constraints takes O(log n) time where n is the number of
- **    constraints associated with the ArithVar.
- **  - Removing Constraints takes O(1) time.
+ **  - Adding Constraints takes O(log n + k) time where n is the number of
+ **    constraints associated with the ArithVar and k is bounded by a small
+ **    constant. Constraints out of order are buffered and merged in batches,
+ **    which costs O(n + k log k) per batch.
+ **  - Removing Constraints takes O(n) time, this is rare.
  **
  ** Internals:
  **  - Constraints are pointers to ConstraintValues.
@@ -79,6 +83,7 @@
 
 #include "theory/arith/constraint_forward.h"
 
+#include <algorithm>
 #include <vector>
 #include <list>
 #include <set>
@@ -189,16 +194,86 @@ public:
 /**
  * A Map of ValueCollections sorted by the associated DeltaRational values.
  *
- * Discussion:
- * While it is more natural to consider this a set, this cannot be a set as in
- * sets the type of both iterator and const_iterator in sets are
- * "constant iterators".  We require iterators that dereference to
- * ValueCollection&.
+ * The values are kept in a vector sorted by value and are found by binary
+ * search, so walking from a value to its neighbours touches contiguous
+ * memory. The ValueCollections are allocated separately, and references to
+ * them stay valid while other values are added and removed.
+ * Iterators are invalidated by insert() and erase().
  *
- * See:
- * http://gcc.gnu.org/onlinedocs/libstdc++/ext/lwg-defects.html#103
+ * A value larger than every value in the map is appended. This is the
+ * common case when the atoms of a variable are registered in order.
+ * Other values are appended to an unsorted tail that is merged into the
+ * sorted prefix when it grows too large or when the map is next walked,
+ * so that registering many atoms costs one merge per batch instead of
+ * shifting the vector on every insertion.
  */
-typedef std::map<DeltaRational, ValueCollection> SortedConstraintMap;
+class SortedConstraintMap {
+public:
+  typedef std::pair<DeltaRational, ValueCollection*> Entry;
+  typedef std::vector<Entry>::iterator iterator;
+  typedef std::vector<Entry>::const_iterator const_iterator;
+
+private:
+  /**
+   * The entries in [0, d_sorted) are sorted by value. The entries after
+   * that are pending insertions in arrival order.
+   * Both are mutable as walking the map merges the pending entries.
+   */
+  mutable std::vector<Entry> d_entries;
+  mutable size_t d_sorted;
+
+  /** The number of pending entries that triggers a merge in insert(). */
+  static const size_t s_maxPending = 32;
+
+  struct EntryLessThanValue {
+    bool operator()(const Entry& e, const DeltaRational& r) const {
+      return e.first < r;
+    }
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.first < b.first;
+    }
+  };
+
+  /** Merges the pending entries into the sorted prefix. */
+  void flush() const;
+
+  /* Not copyable: the map owns its ValueCollections. */
+  SortedConstraintMap(const SortedConstraintMap&);
+  SortedConstraintMap& operator=(const SortedConstraintMap&);
+
+public:
+  SortedConstraintMap() : d_entries(), d_sorted(0) {}
+  ~SortedConstraintMap();
+
+  bool empty() const { return d_entries.empty(); }
+  size_t size() const { return d_entries.size(); }
+
+  iterator begin() { flush(); return d_entries.begin(); }
+  iterator end() { flush(); return d_entries.end(); }
+  const_iterator begin() const { flush(); return d_entries.begin(); }
+  const_iterator end() const { flush(); return d_entries.end(); }
+
+  /** Returns the first entry with a value >= r. */
+  const_iterator lower_bound(const DeltaRational& r) const {
+    flush();
+    return std::lower_bound(d_entries.begin(), d_entries.end(), r, EntryLessThanValue());
+  }
+
+  /** Returns the entry with the value r, or end(). */
+  const_iterator find(const DeltaRational& r) const {
+    const_iterator i = lower_bound(r);
+    return (i != end() && i->first == r) ? i : end();
+  }
+
+  /**
+   * Returns the ValueCollection for r, adding an empty one if there was none.
+   * The second element is true if the ValueCollection was added.
+   */
+  std::pair<ValueCollection*, bool> insert(const DeltaRational& r);
+
+  /** Removes and deallocates the ValueCollection for r, which must be empty. */
+  void erase(const DeltaRational& r);
+};
 typedef SortedConstraintMap::iterator SortedConstraintMapIterator;
 typedef SortedConstraintMap::const_iterator SortedConstraintMapConstIterator;
 
@@ -296,10 +371,10 @@ private:
   bool d_split;
 
   /**
-   * Position in sorted constraint set for the variable.
-   * Unset if d_type is Disequality.
+   * The collection of constraints on the variable with the same value.
+   * The collection is owned by the sorted constraint set for the variable.
    */
-  SortedConstraintMapIterator d_variablePosition;
+  ValueCollection* d_valueCollection;
 
   friend class ConstraintDatabase;
 
@@ -325,7 +400,7 @@ private:
    * This initializes the fields that cannot be set in the constructor due to
    * circular dependencies.
    */
-  void initialize(ConstraintDatabase* db, SortedConstraintMapIterator v, Constraint negation);
+  void initialize(ConstraintDatabase* db, ValueCollection* vc, Constraint negation);
 
   class ProofCleanup {
   public:
@@ -377,6 +452,9 @@ private:
   /** Returns a reference to the map for d_variable. */
   SortedConstraintMap& constraintSet() const;
 
+  /** Returns the position of d_value in constraintSet(). */
+  SortedConstraintMapConstIterator variablePosition() const;
+
 public:
 
   ConstraintType getType() const {
@@ -0,0 +1,284 @@
+/*********************                                                        */
+/*! \file difference_logic.cpp
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief A constraint graph for the difference constraints asserted to arithmetic.
+ **/
+
+#include "theory/arith/difference_logic.h"
+
+using namespace std;
+
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::arith;
+
+DifferenceLogicSolver::DifferenceLogicSolver(context::Context* c) :
+  d_edges(),
+  d_activeEdges(c, 0),
+  d_out(),
+  d_in(),
+  d_potential(),
+  d_integral(),
+  d_vertexOf(),
+  d_difference(),
+  d_differenceOf(),
+  d_gamma(),
+  d_hasGamma(),
+  d_relaxed(),
+  d_parent(),
+  d_touched(),
+  d_statistics()
+{
+  Vertex zero CVC4_UNUSED = newVertex(true);
+  Assert(zero == ZERO_VERTEX);
+}
+
+DifferenceLogicSolver::Statistics::Statistics() :
+  d_edges("theory::arith::dl::edges", 0),
+  d_conflicts("theory::arith::dl::conflicts", 0),
+  d_relaxations("theory::arith::dl::relaxations", 0),
+  d_implications("theory::arith::dl::implications", 0)
+{
+  StatisticsRegistry::registerStat(&d_edges);
+  StatisticsRegistry::registerStat(&d_conflicts);
+  StatisticsRegistry::registerStat(&d_relaxations);
+  StatisticsRegistry::registerStat(&d_implications);
+}
+
+DifferenceLogicSolver::Statistics::~Statistics(){
+  StatisticsRegistry::unregisterStat(&d_edges);
+  StatisticsRegistry::unregisterStat(&d_conflicts);
+  StatisticsRegistry::unregisterStat(&d_relaxations);
+  StatisticsRegistry::unregisterStat(&d_implications);
+}
+
+DifferenceLogicSolver::Vertex DifferenceLogicSolver::newVertex(bool integral){
+  Vertex v = d_potential.size();
+  d_out.push_back(vector<EdgeId>());
+  d_in.push_back(vector<EdgeId>());
+  d_potential.push_back(DeltaRational(0));
+  d_integral.push_back(integral);
+
+  d_gamma.push_back(DeltaRational(0));
+  d_hasGamma.push_back(false);
+  d_relaxed.push_back(false);
+  d_parent.push_back(NO_EDGE);
+  return v;
+}
+
+void DifferenceLogicSolver::ensureVariable(ArithVar v){
+  if(v >= d_difference.size()){
+    d_vertexOf.resize(v + 1, NO_VERTEX);
+    d_difference.resize(v + 1, make_pair(NO_VERTEX, NO_VERTEX));
+  }
+}
+
+void DifferenceLogicSolver::addVariable(ArithVar x, bool integral){
+  ensureVariable(x);
+  // ArithVars are reused, the old vertex (if any) is simply abandoned
+  Vertex vx = newVertex(integral);
+  d_vertexOf[x] = vx;
+  d_difference[x] = make_pair(vx, ZERO_VERTEX);
+  d_differenceOf[make_pair(vx, ZERO_VERTEX)] = x;
+}
+
+void DifferenceLogicSolver::addDifference(ArithVar s, ArithVar x, ArithVar y){
+  ensureVariable(s);
+  Assert(x < d_vertexOf.size() && d_vertexOf[x] != NO_VERTEX);
+  Assert(y < d_vertexOf.size() && d_vertexOf[y] != NO_VERTEX);
+  pair<Vertex, Vertex> xy = make_pair(d_vertexOf[x], d_vertexOf[y]);
+  d_vertexOf[s] = NO_VERTEX;
+  d_difference[s] = xy;
+  d_differenceOf[xy] = s;
+}
+
+void DifferenceLogicSolver::removeVariable(ArithVar v){
+  if(v < d_difference.size()){
+    d_vertexOf[v] = NO_VERTEX;
+    d_difference[v] = make_pair(NO_VERTEX, NO_VERTEX);
+  }
+}
+
+void DifferenceLogicSolver::restore(){
+  while(d_edges.size() > d_activeEdges){
+    const Edge& e = d_edges.back();
+    Assert(d_out[e.d_from].back() == d_edges.size() - 1);
+    Assert(d_in[e.d_to].back() == d_edges.size() - 1);
+    d_out[e.d_from].pop_back();
+    d_in[e.d_to].pop_back();
+    d_edges.pop_back();
+  }
+}
+
+void DifferenceLogicSolver::clearScratch(){
+  for(vector<Vertex>::const_iterator i = d_touched.begin(); i != d_touched.end(); ++i){
+    d_hasGamma[*i] = false;
+    d_relaxed[*i] = false;
+    d_parent[*i] = NO_EDGE;
+  }
+  d_touched.clear();
+}
+
+bool DifferenceLogicSolver::addEdge(Vertex from, Vertex to, const DeltaRational& w,
+                                    Constraint reason, std::vector<Constraint>& conflict){
+  EdgeId id = d_edges.size();
+
+  if(d_potential[from] + w < d_potential[to]){
+    // The potential of to has to decrease by at least gamma(to).
+    // The decreases are propagated forward in the order of the largest
+    // decrease first. If the potential of from has to decrease,
+    // the new edge closes a negative cycle.
+    RelaxQueue queue;
+    d_gamma[to] = d_potential[from] + w - d_potential[to];
+    d_hasGamma[to] = true;
+    d_parent[to] = id;
+    d_touched.push_back(to);
+    queue.push(QueueEntry(d_gamma[to], to));
+
+    while(!queue.empty()){
+      Vertex s = queue.top().second;
+      DeltaRational g = queue.top().first;
+      queue.pop();
+      if(d_relaxed[s] || g != d_gamma[s]){ continue; }
+
+      d_relaxed[s] = true;
+      ++(d_statistics.d_relaxations);
+      DeltaRational relaxed = d_potential[s] + g;
+
+      const vector<EdgeId>& out = d_out[s];
+      for(vector<EdgeId>::const_iterator i = out.begin(); i != out.end(); ++i){
+        const Edge& e = d_edges[*i];
+        Vertex t = e.d_to;
+        if(d_relaxed[t]){ continue; }
+        DeltaRational gt = relaxed + e.d_weight - d_potential[t];
+        if(gt.sgn() < 0 && (!d_hasGamma[t] || gt < d_gamma[t])){
+          if(!d_hasGamma[t]){
+            d_touched.push_back(t);
+            d_hasGamma[t] = true;
+          }
+          d_gamma[t] = gt;
+          d_parent[t] = *i;
+
+          if(t == from){
+            // from -> to ~> from is a negative cycle
+            ++(d_statistics.d_conflicts);
+            conflict.push_back(reason);
+            for(Vertex v = from; d_parent[v] != id; v = d_edges[d_parent[v]].d_from){
+              conflict.push_back(d_edges[d_parent[v]].d_reason);
+            }
+            Debug("arith::dl") << "dl: negative cycle of length " << conflict.size() << endl;
+            clearScratch();
+            return false;
+          }
+          queue.push(QueueEntry(gt, t));
+        }
+      }
+    }
+
+    for(vector<Vertex>::const_iterator i = d_touched.begin(); i != d_touched.end(); ++i){
+      if(d_relaxed[*i]){
+        d_potential[*i] = d_potential[*i] + d_gamma[*i];
+      }
+    }
+    clearScratch();
+  }
+
+  Edge e;
+  e.d_from = from;
+  e.d_to = to;
+  e.d_weight = w;
+  e.d_reason = reason;
+  d_edges.push_back(e);
+  d_out[from].push_back(id);
+  d_in[to].push_back(id);
+  d_activeEdges = d_edges.size();
+  ++(d_statistics.d_edges);
+  return true;
+}
+
+void DifferenceLogicSolver::implyPath(Vertex from, Vertex to, const DeltaRational& w,
+                                      Constraint first, Constraint second,
+                                      std::vector<DifferenceImplication>& out) const{
+  // to - from <= w
+  typedef map< pair<Vertex, Vertex>, ArithVar >::const_iterator DiffIter;
+  pair<Vertex, Vertex> toFrom = make_pair(to, from);
+  DiffIter upper = d_differenceOf.find(toFrom);
+  if(upper != d_differenceOf.end() && d_difference[(*upper).second] == toFrom){
+    out.push_back(DifferenceImplication((*upper).second, UpperBound, w, first, second));
+  }
+  pair<Vertex, Vertex> fromTo = make_pair(from, to);
+  DiffIter lower = d_differenceOf.find(fromTo);
+  if(lower != d_differenceOf.end() && d_difference[(*lower).second] == fromTo){
+    out.push_back(DifferenceImplication((*lower).second, LowerBound, -w, first, second));
+  }
+}
+
+void DifferenceLogicSolver::implications(EdgeId id, std::vector<DifferenceImplication>& out) const{
+  const Edge& e = d_edges[id];
+  // a -> from -> to
+  const vector<EdgeId>& in = d_in[e.d_from];
+  for(vector<EdgeId>::const_iterator i = in.begin(); i != in.end(); ++i){
+    const Edge& prev = d_edges[*i];
+    if(prev.d_from != e.d_to){
+      implyPath(prev.d_from, e.d_to, prev.d_weight + e.d_weight, prev.d_reason, e.d_reason, out);
+    }
+  }
+  // from -> to -> b
+  const vector<EdgeId>& outEdges = d_out[e.d_to];
+  for(vector<EdgeId>::const_iterator i = outEdges.begin(); i != outEdges.end(); ++i){
+    const Edge& next = d_edges[*i];
+    if(next.d_to != e.d_from){
+      implyPath(e.d_from, next.d_to, e.d_weight + next.d_weight, e.d_reason, next.d_reason, out);
+    }
+  }
+}
+
+bool DifferenceLogicSolver::assertConstraint(Constraint c, std::vector<Constraint>& conflict,
+                                             std::vector<DifferenceImplication>& implied){
+  ArithVar v = c->getVariable();
+  Assert(isDifference(v));
+  restore();
+
+  Vertex plus = d_difference[v].first;
+  Vertex minus = d_difference[v].second;
+  bool integral = d_integral[plus] && d_integral[minus];
+
+  // v <= c is plus - minus <= c, the edge minus -> plus
+  // v >= c is minus - plus <= -c, the edge plus -> minus
+  bool upper = c->getType() == UpperBound || c->getType() == Equality;
+  bool lower = c->getType() == LowerBound || c->getType() == Equality;
+  Assert(upper || lower);
+
+  size_t before = implied.size();
+  if(upper){
+    DeltaRational w = integral ? DeltaRational(Rational(c->getValue().floor())) : c->getValue();
+    if(!addEdge(minus, plus, w, c, conflict)){
+      return false;
+    }
+    implications(d_edges.size() - 1, implied);
+  }
+  if(lower){
+    DeltaRational negated = -c->getValue();
+    DeltaRational w = integral ? DeltaRational(Rational(negated.floor())) : negated;
+    if(!addEdge(plus, minus, w, c, conflict)){
+      return false;
+    }
+    implications(d_edges.size() - 1, implied);
+  }
+  d_statistics.d_implications += implied.size() - before;
+  return true;
+}
+
+DeltaRational DifferenceLogicSolver::getValue(ArithVar v) const{
+  Assert(isDifference(v));
+  const pair<Vertex, Vertex>& d = d_difference[v];
+  return d_potential[d.first] - d_potential[d.second];
+}
@@ -0,0 +1,194 @@
+/*********************                                                        */
+/*! \file difference_logic.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief A constraint graph for the difference constraints asserted to arithmetic.
+ **
+ ** A bound on a variable x or on a slack variable s = x - y is an edge of
+ ** a constraint graph: x - y <= c is the edge y -> x of weight c and the
+ ** bounds of x are edges to and from a distinguished zero vertex.
+ ** The asserted bounds are satisfiable iff the graph has no negative cycle.
+ **
+ ** The graph keeps a feasible potential for the asserted edges, and each
+ ** new edge is checked for a negative cycle with the incremental algorithm
+ ** of Cotton and Maler ("Fast and Flexible Difference Constraint
+ ** Propagation for DPLL(T)", SAT 2006), which only visits the vertices
+ ** whose potential must decrease. The potential gives a model: the value
+ ** of x is potential(x) - potential(zero).
+ **
+ ** Edges between integer vertices have their weights rounded down, which
+ ** keeps the potentials of those vertices integral.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__ARITH__DIFFERENCE_LOGIC_H
+#define __CVC4__THEORY__ARITH__DIFFERENCE_LOGIC_H
+
+#include "context/context.h"
+#include "context/cdo.h"
+#include "theory/arith/arithvar.h"
+#include "theory/arith/constraint.h"
+#include "theory/arith/delta_rational.h"
+#include "util/statistics_registry.h"
+
+#include <map>
+#include <queue>
+#include <vector>
+
+namespace CVC4 {
+namespace theory {
+namespace arith {
+
+/**
+ * A bound implied by a path of two edges in the constraint graph.
+ * This is not yet a constraint: the theory looks up the best constraint
+ * on d_var it implies.
+ */
+struct DifferenceImplication {
+  ArithVar d_var;
+  ConstraintType d_type;
+  DeltaRational d_value;
+  Constraint d_first, d_second;
+
+  DifferenceImplication(ArithVar v, ConstraintType t, const DeltaRational& value,
+                        Constraint first, Constraint second) :
+    d_var(v), d_type(t), d_value(value), d_first(first), d_second(second)
+  {}
+};/* struct DifferenceImplication */
+
+class DifferenceLogicSolver {
+private:
+  typedef uint32_t Vertex;
+  typedef uint32_t EdgeId;
+
+  static const Vertex ZERO_VERTEX = 0;
+  static const Vertex NO_VERTEX = (Vertex)-1;
+  static const EdgeId NO_EDGE = (EdgeId)-1;
+
+  /** The edge d_from -> d_to of weight d_weight: d_to - d_from <= d_weight */
+  struct Edge {
+    Vertex d_from, d_to;
+    DeltaRational d_weight;
+    Constraint d_reason;
+  };
+
+  /** The asserted edges in the order they were asserted. */
+  std::vector<Edge> d_edges;
+
+  /**
+   * The edges d_edges[0, d_activeEdges) are asserted in the current context.
+   * The inactive edges are removed lazily by restore().
+   */
+  context::CDO<uint32_t> d_activeEdges;
+
+  /** Vertex |-> the ids of its outgoing (incoming) edges, in increasing order */
+  std::vector< std::vector<EdgeId> > d_out, d_in;
+
+  /** A potential satisfying every edge in d_edges. */
+  std::vector<DeltaRational> d_potential;
+  std::vector<bool> d_integral;
+
+  /** ArithVar |-> its vertex for original variables, or NO_VERTEX */
+  std::vector<Vertex> d_vertexOf;
+
+  /** ArithVar |-> (plus, minus) when the variable is plus - minus */
+  std::vector< std::pair<Vertex, Vertex> > d_difference;
+
+  /** (plus, minus) |-> the variable equal to plus - minus */
+  std::map< std::pair<Vertex, Vertex>, ArithVar > d_differenceOf;
+
+  /* Scratch space for the incremental check, indexed by vertex. */
+  std::vector<DeltaRational> d_gamma;
+  std::vector<bool> d_hasGamma, d_relaxed;
+  std::vector<EdgeId> d_parent;
+  std::vector<Vertex> d_touched;
+
+  typedef std::pair<DeltaRational, Vertex> QueueEntry;
+  struct QueueEntryGreater {
+    bool operator()(const QueueEntry& a, const QueueEntry& b) const {
+      return b.first < a.first;
+    }
+  };
+  typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueEntryGreater> RelaxQueue;
+
+  Vertex newVertex(bool integral);
+  void ensureVariable(ArithVar v);
+
+  /** Drops the edges that are no longer asserted. */
+  void restore();
+
+  /**
+   * Adds the edge from -> to of weight w.
+   * If this closes a negative cycle, the edge is not added, the reasons of
+   * the cycle are appended to conflict and false is returned.
+   */
+  bool addEdge(Vertex from, Vertex to, const DeltaRational& w, Constraint reason,
+               std::vector<Constraint>& conflict);
+
+  void clearScratch();
+
+  /** Appends the implications of the paths of two edges through e. */
+  void implications(EdgeId e, std::vector<DifferenceImplication>& out) const;
+  void implyPath(Vertex from, Vertex to, const DeltaRational& w,
+                 Constraint first, Constraint second,
+                 std::vector<DifferenceImplication>& out) const;
+
+  class Statistics {
+  public:
+    IntStat d_edges;
+    IntStat d_conflicts;
+    IntStat d_relaxations;
+    IntStat d_implications;
+
+    Statistics();
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+
+public:
+  DifferenceLogicSolver(context::Context* c);
+
+  /** Registers an original (non-slack) variable. */
+  void addVariable(ArithVar x, bool integral);
+
+  /**
+   * Registers the slack variable s = x - y.
+   * x and y must already be registered.
+   */
+  void addDifference(ArithVar s, ArithVar x, ArithVar y);
+
+  /** Returns true if the bounds of v are edges of the graph. */
+  bool isDifference(ArithVar v) const {
+    return v < d_difference.size() && d_difference[v].first != NO_VERTEX;
+  }
+
+  /** Forgets the variable v, which is about to be released. */
+  void removeVariable(ArithVar v);
+
+  /**
+   * Adds the edges of a bound (or equality) constraint on a variable with
+   * isDifference(). Returns false if this closes a negative cycle and fills
+   * conflict with the constraints of the cycle.
+   * The implications of the new edges are appended to implied.
+   */
+  bool assertConstraint(Constraint c, std::vector<Constraint>& conflict,
+                        std::vector<DifferenceImplication>& implied);
+
+  /** The value of v under the current potential, requires isDifference(v). */
+  DeltaRational getValue(ArithVar v) const;
+};/* class DifferenceLogicSolver */
+
+}/* CVC4::theory::arith namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__ARITH__DIFFERENCE_LOGIC_H */
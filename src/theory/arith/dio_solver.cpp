@@ -35,6 +35,7 @@ DioSolver::DioSolver(context::Context* ctxt) :
   d_nextInputConstraintToEnqueue(ctxt, 0),
   d_trail(ctxt),
   d_subs(ctxt),
+  d_eliminatedBy(ctxt),
   d_currentF(),
   d_savedQueue(ctxt),
   d_savedQueueIndex(ctxt, 0),
@@ -565,11 +566,32 @@ void DioSolver::printQueue(){
   }
 }
 
+DioSolver::SubIndex DioSolver::firstApplicableSubstitution(DioSolver::TrailIndex ti) const{
+  SubIndex first = d_subs.size();
+  const Polynomial& p = d_trail[ti].d_eq.getPolynomial();
+  if(p.isConstant()){
+    // A linearly dependent row can reduce to 0 = c, which has no variables.
+    return first;
+  }
+  for(Polynomial::iterator i = p.begin(), end = p.end(); i != end; ++i){
+    VarList vl = (*i).getVarList();
+    Assert(vl.singleton());
+    EliminatedMap::const_iterator e = d_eliminatedBy.find(vl.getHead().getNode());
+    if(e != d_eliminatedBy.end() && (*e).second < first){
+      first = (*e).second;
+    }
+  }
+  return first;
+}
+
 DioSolver::TrailIndex DioSolver::applyAllSubstitutionsToIndex(DioSolver::TrailIndex trailIndex){
   TrailIndex currentIndex = trailIndex;
-  for(SubIndex subIter = 0, siEnd = d_subs.size(); subIter < siEnd; ++subIter){
+  for(SubIndex subIter = firstApplicableSubstitution(currentIndex);
+      subIter < d_subs.size();
+      subIter = firstApplicableSubstitution(currentIndex)){
     currentIndex = applySubstitution(subIter, currentIndex);
   }
+  Assert(!debugAnySubstitionApplies(currentIndex));
   return currentIndex;
 }
 
@@ -618,6 +640,7 @@ std::pair<DioSolver::SubIndex, DioSolver::TrailIndex> DioSolver::solveIndex(DioS
 
   SubIndex subBy = d_subs.size();
   d_subs.push_back(Substitution(Node::null(), var, ci));
+  d_eliminatedBy.insert(var.getNode(), subBy);
 
   Debug("arith::dio") << "after solveIndex " <<  d_trail[ci].d_eq.getNode() << " for " << av.getNode() << endl;
   Assert(d_trail[ci].d_eq.getPolynomial().getCoefficient(vl) == Constant::mkConstant(-1));
@@ -685,6 +708,7 @@ std::pair<DioSolver::SubIndex, DioSolver::TrailIndex> DioSolver::decomposeIndex(
 
   SubIndex subBy = d_subs.size();
   d_subs.push_back(Substitution(freshNode, var, ci));
+  d_eliminatedBy.insert(var.getNode(), subBy);
 
   Debug("arith::dio") << "Decompose nextIndex " <<  d_trail[nextIndex].d_eq.getNode() << endl;
   return make_pair(subBy, nextIndex);
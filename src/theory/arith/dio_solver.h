@@ -20,6 +20,7 @@
 #define __CVC4__THEORY__ARITH__DIO_SOLVER_H
 
 #include "context/context.h"
+#include "context/cdhashmap.h"
 
 #include "theory/arith/matrix.h"
 #include "theory/arith/partial_model.h"
@@ -130,6 +131,15 @@ private:
   };
   context::CDList<Substitution> d_subs;
 
+  /**
+   * Maps the variable eliminated by d_subs[i] to i.
+   * The equality of d_subs[i] only contains variables eliminated by later
+   * substitutions, so applying the earliest substitution whose variable
+   * occurs in an equality until none applies eliminates every variable.
+   */
+  typedef context::CDHashMap<Node, SubIndex, NodeHashFunction> EliminatedMap;
+  EliminatedMap d_eliminatedBy;
+
   /**
    * This is the queue of constraints to be processed in the current context level.
    * This is to be empty upon entering solver and cleared upon leaving the solver.
@@ -296,6 +306,12 @@ private:
    */
   TrailIndex applyAllSubstitutionsToIndex(TrailIndex i);
 
+  /**
+   * Returns the earliest substitution that applies to the i'th element of the
+   * trail, or d_subs.size() if none applies.
+   */
+  SubIndex firstApplicableSubstitution(TrailIndex i) const;
+
   /**
    * Applies a substitution to an element in the trail.
    */
@@ -17,6 +17,12 @@
 
 #include "theory/arith/linear_equality.h"
 
+#ifdef CVC4_PORTFOLIO
+#  include <algorithm>
+#  include <boost/bind.hpp>
+#  include <boost/thread/thread.hpp>
+#endif /* CVC4_PORTFOLIO */
+
 using namespace std;
 
 namespace CVC4 {
@@ -226,6 +232,41 @@ DeltaRational LinearEqualityModule::computeBound(ArithVar basic, bool upperBound
   return sum;
 }
 
+void LinearEqualityModule::computeRowBoundsStrided(std::vector<RowBounds>& rows, size_t i, size_t stride){
+  for(; i < rows.size(); i += stride){
+    RowBounds& rb = rows[i];
+    ArithVar basic = rb.d_basic;
+    Assert(d_tableau.isBasic(basic));
+    if(d_partialModel.strictlyAboveLowerBound(basic) && hasLowerBounds(basic)){
+      rb.d_lower = computeLowerBound(basic);
+      rb.d_hasLower = true;
+    }
+    if(d_partialModel.strictlyBelowUpperBound(basic) && hasUpperBounds(basic)){
+      rb.d_upper = computeUpperBound(basic);
+      rb.d_hasUpper = true;
+    }
+  }
+}
+
+void LinearEqualityModule::computeRowBounds(std::vector<RowBounds>& rows, unsigned threads){
+#ifdef CVC4_PORTFOLIO
+  // Starting a thread costs about as much as a few short rows.
+  static const size_t MIN_ROWS_PER_THREAD = 16;
+  size_t stride = std::min<size_t>(threads, rows.size() / MIN_ROWS_PER_THREAD);
+  if(stride > 1){
+    boost::thread_group workers;
+    for(size_t i = 1; i < stride; ++i){
+      workers.create_thread(boost::bind(&LinearEqualityModule::computeRowBoundsStrided,
+                                        this, boost::ref(rows), i, stride));
+    }
+    computeRowBoundsStrided(rows, 0, stride);
+    workers.join_all();
+    return;
+  }
+#endif /* CVC4_PORTFOLIO */
+  computeRowBoundsStrided(rows, 0, 1);
+}
+
 /**
  * Computes the value of a basic variable using the current assignment.
  */
@@ -38,10 +38,28 @@
 
 #include "util/statistics_registry.h"
 
+#include <vector>
+
 namespace CVC4 {
 namespace theory {
 namespace arith {
 
+/**
+ * The bounds implied on a basic variable by the bounds of the
+ * nonbasic variables in its row.
+ */
+struct RowBounds {
+  ArithVar d_basic;
+
+  /** Whether d_lower (d_upper) was computed. */
+  bool d_hasLower, d_hasUpper;
+  DeltaRational d_lower, d_upper;
+
+  RowBounds(ArithVar basic) :
+    d_basic(basic), d_hasLower(false), d_hasUpper(false), d_lower(), d_upper()
+  {}
+};/* struct RowBounds */
+
 class LinearEqualityModule {
 private:
   /**
@@ -131,6 +149,22 @@ public:
 private:
   DeltaRational computeBound(ArithVar basic, bool upperBound);
 
+  /** Computes the bounds of rows[i], rows[i+stride], rows[i+2*stride], ... */
+  void computeRowBoundsStrided(std::vector<RowBounds>& rows, size_t i, size_t stride);
+
+public:
+  /**
+   * Computes the bounds implied on each row's basic variable that could be
+   * tighter than its current bounds: a lower bound is only computed if the
+   * basic variable is strictly above its lower bound and every nonbasic
+   * variable is bounded in the needed direction (and similarly for upper).
+   *
+   * This only reads the tableau and the partial model, so the rows are
+   * independent. When the library is built with thread support and
+   * threads > 1, the rows are split over that many threads.
+   */
+  void computeRowBounds(std::vector<RowBounds>& rows, unsigned threads);
+
 public:
   /**
    * Checks to make sure the assignment is consistent with the tableau.
@@ -74,7 +74,7 @@ ReducedRowVector* Tableau::removeRow(ArithVar basic){
 void Tableau::pivot(ArithVar oldBasic, ArithVar newBasic){
   Assert(isBasic(oldBasic));
   Assert(!isBasic(newBasic));
-  Assert(d_mergeBuffer.empty());
+  Assert(d_rowInMergeBuffer == ROW_INDEX_SENTINEL);
 
   Debug("tableau") << "Tableau::pivot(" <<  oldBasic <<", " << newBasic <<")"  << endl;
 
@@ -85,24 +85,29 @@ void Tableau::pivot(ArithVar oldBasic, ArithVar newBasic){
 
   loadRowIntoBuffer(ridx);
 
-  ColIterator colIter = colIterator(newBasic);
-  while(!colIter.atEnd()){
-    EntryID id = colIter.getID();
-    Entry& entry = d_entries.get(id);
-
-    ++colIter; //needs to be incremented before the variable is removed
-    if(entry.getRowIndex() == ridx){ continue; }
+  // The column of newBasic is emptied as the other rows are updated,
+  // so the positions of its entries are copied first.
+  // Each row is only modified when it is its turn, so the copied offsets stay valid.
+  const ColumnVectorT& column = getColumn(newBasic);
+  d_pivotColumn.clear();
+  for(EntryOffset i = 0, N = column.getSize(); i < N; ++i){
+    d_pivotColumn.push_back(column[i]);
+  }
 
-    RowIndex to = entry.getRowIndex();
-    Rational coeff = entry.getCoefficient();
+  std::vector<MatrixPosition>::const_iterator i = d_pivotColumn.begin();
+  std::vector<MatrixPosition>::const_iterator i_end = d_pivotColumn.end();
+  for(; i != i_end; ++i){
+    RowIndex to = (*i).d_rowIndex;
+    if(to == ridx){ continue; }
 
+    Rational coeff = getRow(to)[(*i).d_rowOffset].getCoefficient();
     rowPlusBufferTimesConstant(to, coeff);
   }
   clearBuffer();
 
   //Clear the column for used for this variable
 
-  Assert(d_mergeBuffer.empty());
+  Assert(d_rowInMergeBuffer == ROW_INDEX_SENTINEL);
   Assert(!isBasic(oldBasic));
   Assert(isBasic(newBasic));
   Assert(getColLength(newBasic) == 1);
@@ -231,18 +236,15 @@ void Tableau::rowPivot(ArithVar basicOld, ArithVar basicNew){
 
   RowIndex rid = basicToRowIndex(basicOld);
 
-  EntryID newBasicID = findOnRow(rid, basicNew);
-
-  Assert(newBasicID != ENTRYID_SENTINEL);
+  EntryOffset newBasicOffset = findOnRow(rid, basicNew);
 
-  Tableau::Entry& newBasicEntry = d_entries.get(newBasicID);
-  Rational negInverseA_rs = -(newBasicEntry.getCoefficient().inverse());
+  Assert(newBasicOffset != ENTRY_OFFSET_SENTINEL);
 
-  for(RowIterator i = basicRowIterator(basicOld); !i.atEnd(); ++i){
-    EntryID id = i.getID();
-    Tableau::Entry& entry = d_entries.get(id);
+  RowVectorT& row = d_rows[rid];
+  Rational negInverseA_rs = -(row[newBasicOffset].getCoefficient().inverse());
 
-    entry.getCoefficient() *=  negInverseA_rs;
+  for(EntryOffset i = 0, N = row.getSize(); i < N; ++i){
+    row.get(i).getCoefficient() *=  negInverseA_rs;
   }
 
   d_basic2RowIndex.remove(basicOld);
@@ -36,23 +36,21 @@ namespace CVC4 {
 namespace theory {
 namespace arith {
 
-typedef Index EntryID;
-const EntryID ENTRYID_SENTINEL = std::numeric_limits<EntryID>::max();
-
 typedef Index RowIndex;
 const RowIndex ROW_INDEX_SENTINEL  = std::numeric_limits<RowIndex>::max();
 
+/** The offset of an entry on its row, or in the occurrence list of its column. */
+typedef uint32_t EntryOffset;
+const EntryOffset ENTRY_OFFSET_SENTINEL = std::numeric_limits<EntryOffset>::max();
+
 template<class T>
 class MatrixEntry {
 private:
   RowIndex d_rowIndex;
   ArithVar d_colVar;
 
-  EntryID d_nextRow;
-  EntryID d_nextCol;
-
-  EntryID d_prevRow;
-  EntryID d_prevCol;
+  /** Where this entry is in the occurrence list of its column. */
+  EntryOffset d_colOffset;
 
   T d_coefficient;
 
@@ -60,20 +58,14 @@ public:
   MatrixEntry():
     d_rowIndex(ROW_INDEX_SENTINEL),
     d_colVar(ARITHVAR_SENTINEL),
-    d_nextRow(ENTRYID_SENTINEL),
-    d_nextCol(ENTRYID_SENTINEL),
-    d_prevRow(ENTRYID_SENTINEL),
-    d_prevCol(ENTRYID_SENTINEL),
+    d_colOffset(ENTRY_OFFSET_SENTINEL),
     d_coefficient()
   {}
 
-  MatrixEntry(RowIndex row, ArithVar col, const T& coeff):
+  MatrixEntry(RowIndex row, ArithVar col, const T& coeff, EntryOffset colOffset):
      d_rowIndex(row),
      d_colVar(col),
-     d_nextRow(ENTRYID_SENTINEL),
-     d_nextCol(ENTRYID_SENTINEL),
-     d_prevRow(ENTRYID_SENTINEL),
-     d_prevCol(ENTRYID_SENTINEL),
+     d_colOffset(colOffset),
      d_coefficient(coeff)
   {}
 
@@ -86,32 +78,12 @@ private:
 
 public:
 
-  EntryID getNextRowEntryID() const {
-    return d_nextRow;
-  }
-
-  EntryID getNextColEntryID() const {
-    return d_nextCol;
-  }
-  EntryID getPrevRowEntryID() const {
-    return d_prevRow;
+  EntryOffset getColOffset() const {
+    return d_colOffset;
   }
 
-  EntryID getPrevColEntryID() const {
-    return d_prevCol;
-  }
-
-  void setNextRowEntryID(EntryID id) {
-    d_nextRow = id;
-  }
-  void setNextColEntryID(EntryID id) {
-    d_nextCol = id;
-  }
-  void setPrevRowEntryID(EntryID id) {
-    d_prevRow = id;
-  }
-  void setPrevColEntryID(EntryID id) {
-    d_prevCol = id;
+  void setColOffset(EntryOffset offset) {
+    d_colOffset = offset;
   }
 
   RowIndex getRowIndex() const{
@@ -146,84 +118,37 @@ public:
   }
 }; /* class MatrixEntry<T> */
 
-template<class T>
-class MatrixEntryVector {
-private:
-  typedef MatrixEntry<T> EntryType;
-  typedef std::vector<EntryType> EntryArray;
-
-  EntryArray d_entries;
-  std::queue<EntryID> d_freedEntries;
-
-  uint32_t d_size;
+/** The location of an entry: its row and its offset on that row. */
+struct MatrixPosition {
+  RowIndex d_rowIndex;
+  EntryOffset d_rowOffset;
 
-public:
-  MatrixEntryVector():
-    d_entries(), d_freedEntries(), d_size(0)
+  MatrixPosition(RowIndex row, EntryOffset offset) :
+    d_rowIndex(row), d_rowOffset(offset)
   {}
+};/* struct MatrixPosition */
 
-  const EntryType& operator[](EntryID id) const{
-    Assert(inBounds(id));
-    return d_entries[id];
-  }
-
-  EntryType& get(EntryID id){
-    Assert(inBounds(id));
-    return d_entries[id];
-  }
-
-  void freeEntry(EntryID id){
-    Assert(get(id).blank());
-    Assert(d_size > 0);
-
-    d_freedEntries.push(id);
-    --d_size;
-  }
-
-  EntryID newEntry(){
-    EntryID newId;
-    if(d_freedEntries.empty()){
-      newId = d_entries.size();
-      d_entries.push_back(MatrixEntry<T>());
-    }else{
-      newId = d_freedEntries.front();
-      d_freedEntries.pop();
-    }
-    ++d_size;
-    return newId;
-  }
-
-  uint32_t size() const{ return d_size; }
-  uint32_t capacity() const{ return d_entries.capacity(); }
-
-
-private:
-  bool inBounds(EntryID id) const{
-    return id <  d_entries.size();
-  }
-}; /* class MatrixEntryVector<T> */
-
-template <class T, bool isRow>
-class MatrixVector {
+/**
+ * A row stores its entries contiguously and in no particular order.
+ * Removing an entry moves the last entry of the row into its place.
+ */
+template <class T>
+class RowVector {
 private:
-  EntryID d_head;
-  uint32_t d_size;
-
-  MatrixEntryVector<T>* d_entries;
+  typedef std::vector< MatrixEntry<T> > EntryArray;
+  EntryArray d_entries;
 
   class Iterator {
   private:
-    EntryID d_curr;
-    const MatrixEntryVector<T>* d_entries;
+    const EntryArray* d_entries;
+    EntryOffset d_curr;
 
   public:
-    Iterator(EntryID start, const MatrixEntryVector<T>* entries) :
-      d_curr(start), d_entries(entries)
+    Iterator(const EntryArray* entries, EntryOffset start) :
+      d_entries(entries), d_curr(start)
     {}
 
-  public:
-
-    EntryID getID() const {
+    EntryOffset getOffset() const {
       return d_curr;
     }
 
@@ -234,13 +159,12 @@ private:
 
     Iterator& operator++(){
       Assert(!atEnd());
-      const MatrixEntry<T>& entry = (*d_entries)[d_curr];
-      d_curr = isRow ? entry.getNextRowEntryID() : entry.getNextColEntryID();
+      ++d_curr;
       return *this;
     }
 
     bool atEnd() const {
-      return d_curr == ENTRYID_SENTINEL;
+      return d_curr >= d_entries->size();
     }
 
     bool operator==(const Iterator& i) const{
@@ -248,105 +172,142 @@ private:
     }
 
     bool operator!=(const Iterator& i) const{
-      return !(d_curr == i.d_curr && d_entries == i.d_entries);
+      return !(*this == i);
     }
-  }; /* class MatrixVector<T, isRow>::Iterator */
+  }; /* class RowVector<T>::Iterator */
 
 public:
-  MatrixVector(MatrixEntryVector<T>* mev)
-    : d_head(ENTRYID_SENTINEL), d_size(0), d_entries(mev)
-  {}
-
-  MatrixVector(EntryID head, uint32_t size, MatrixEntryVector<T>* mev)
-    : d_head(head), d_size(size), d_entries(mev)
-  {}
+  RowVector() : d_entries() {}
 
   typedef Iterator const_iterator;
   const_iterator begin() const {
-    return Iterator(d_head, d_entries);
+    return Iterator(&d_entries, 0);
   }
   const_iterator end() const {
-    return Iterator(ENTRYID_SENTINEL, d_entries);
+    return Iterator(&d_entries, d_entries.size());
   }
 
-  EntryID getHead() const { return d_head; }
+  uint32_t getSize() const { return d_entries.size(); }
+  uint32_t getCapacity() const { return d_entries.capacity(); }
 
-  uint32_t getSize() const { return d_size; }
+  const MatrixEntry<T>& operator[](EntryOffset offset) const {
+    Assert(offset < d_entries.size());
+    return d_entries[offset];
+  }
 
-  void insert(EntryID newId){
-    if(isRow){
-      d_entries->get(newId).setNextRowEntryID(d_head);
+  MatrixEntry<T>& get(EntryOffset offset) {
+    Assert(offset < d_entries.size());
+    return d_entries[offset];
+  }
 
-      if(d_head != ENTRYID_SENTINEL){
-        d_entries->get(d_head).setPrevRowEntryID(newId);
-      }
-    }else{
-      d_entries->get(newId).setNextColEntryID(d_head);
+  /** Appends the entry and returns its offset. */
+  EntryOffset insert(const MatrixEntry<T>& entry){
+    d_entries.push_back(entry);
+    return d_entries.size() - 1;
+  }
 
-      if(d_head != ENTRYID_SENTINEL){
-        d_entries->get(d_head).setPrevColEntryID(newId);
-      }
+  /** Removes the entry at offset by moving the last entry into its place. */
+  void remove(EntryOffset offset){
+    Assert(offset < d_entries.size());
+    if(offset + 1 != d_entries.size()){
+      d_entries[offset] = d_entries.back();
     }
-
-    d_head = newId;
-    ++d_size;
+    d_entries.pop_back();
   }
-  void remove(EntryID id){
-    Assert(d_size > 0);
-    --d_size;
-    if(isRow){
-      EntryID prevRow = d_entries->get(id).getPrevRowEntryID();
-      EntryID nextRow = d_entries->get(id).getNextRowEntryID();
+};/* class RowVector<T> */
 
-      if(d_head == id){
-        d_head = nextRow;
-      }
-      if(prevRow != ENTRYID_SENTINEL){
-        d_entries->get(prevRow).setNextRowEntryID(nextRow);
-      }
-      if(nextRow != ENTRYID_SENTINEL){
-        d_entries->get(nextRow).setPrevRowEntryID(prevRow);
-      }
-    }else{
-      EntryID prevCol = d_entries->get(id).getPrevColEntryID();
-      EntryID nextCol = d_entries->get(id).getNextColEntryID();
+/**
+ * A column is the list of the positions of its entries in the rows.
+ * Removing an occurrence moves the last occurrence into its place.
+ */
+template <class T>
+class ColumnVector {
+private:
+  typedef std::vector<MatrixPosition> PositionArray;
+  typedef std::vector< RowVector<T> > RowTable;
+  PositionArray d_positions;
 
-      if(d_head == id){
-        d_head = nextCol;
-      }
+  class Iterator {
+  private:
+    const PositionArray* d_positions;
+    const RowTable* d_rows;
+    EntryOffset d_curr;
 
-      if(prevCol != ENTRYID_SENTINEL){
-        d_entries->get(prevCol).setNextColEntryID(nextCol);
-      }
-      if(nextCol != ENTRYID_SENTINEL){
-        d_entries->get(nextCol).setPrevColEntryID(prevCol);
-      }
+  public:
+    Iterator(const PositionArray* positions, const RowTable* rows, EntryOffset start) :
+      d_positions(positions), d_rows(rows), d_curr(start)
+    {}
+
+    const MatrixEntry<T>& operator*() const{
+      Assert(!atEnd());
+      const MatrixPosition& pos = (*d_positions)[d_curr];
+      return (*d_rows)[pos.d_rowIndex][pos.d_rowOffset];
     }
-  }
-}; /* class MatrixVector<T, isRow> */
 
-template <class T>
-  class RowVector : public MatrixVector<T, true>
-{
-private:
-  typedef MatrixVector<T, true> SuperT;
-public:
-  typedef typename SuperT::const_iterator const_iterator;
+    Iterator& operator++(){
+      Assert(!atEnd());
+      ++d_curr;
+      return *this;
+    }
 
-  RowVector(MatrixEntryVector<T>* mev) : SuperT(mev){}
-};/* class RowVector<T> */
+    bool atEnd() const {
+      return d_curr >= d_positions->size();
+    }
+
+    bool operator==(const Iterator& i) const{
+      return d_curr == i.d_curr && d_positions == i.d_positions;
+    }
+
+    bool operator!=(const Iterator& i) const{
+      return !(*this == i);
+    }
+  }; /* class ColumnVector<T>::Iterator */
 
-template <class T>
-  class ColumnVector : public MatrixVector<T, false>
-{
-private:
-  typedef MatrixVector<T, false> SuperT;
 public:
-  typedef typename SuperT::const_iterator const_iterator;
+  ColumnVector() : d_positions() {}
+
+  typedef Iterator const_iterator;
+  const_iterator begin(const RowTable& rows) const {
+    return Iterator(&d_positions, &rows, 0);
+  }
+  const_iterator end(const RowTable& rows) const {
+    return Iterator(&d_positions, &rows, d_positions.size());
+  }
+
+  uint32_t getSize() const { return d_positions.size(); }
 
-  ColumnVector(MatrixEntryVector<T>* mev) : SuperT(mev){}
+  const MatrixPosition& operator[](EntryOffset offset) const {
+    Assert(offset < d_positions.size());
+    return d_positions[offset];
+  }
+
+  MatrixPosition& get(EntryOffset offset) {
+    Assert(offset < d_positions.size());
+    return d_positions[offset];
+  }
+
+  /** Appends the position and returns its offset. */
+  EntryOffset insert(const MatrixPosition& pos){
+    d_positions.push_back(pos);
+    return d_positions.size() - 1;
+  }
+
+  /** Removes the occurrence at offset by moving the last one into its place. */
+  void remove(EntryOffset offset){
+    Assert(offset < d_positions.size());
+    if(offset + 1 != d_positions.size()){
+      d_positions[offset] = d_positions.back();
+    }
+    d_positions.pop_back();
+  }
 };/* class ColumnVector<T> */
 
+/**
+ * A sparse matrix with contiguous row storage and column occurrence lists.
+ * Each entry knows its offset in the occurrence list of its column, and each
+ * occurrence knows the offset of the entry on its row, so entries are added
+ * and removed in constant time.
+ */
 template <class T>
 class Matrix {
 protected:
@@ -367,16 +328,20 @@ protected:
   typedef std::vector< ColumnVectorT > ColumnTable;
   ColumnTable d_columns;
 
-  /* The merge buffer is used to store a row in order to optimize row addition. */
-  typedef std::pair<EntryID, bool> PosUsedPair;
-  typedef DenseMap< PosUsedPair > RowToPosUsedPairMap;
-  RowToPosUsedPairMap d_mergeBuffer;
+  /**
+   * The merge buffer is used to store a row in order to optimize row addition.
+   * It is a pair of dense scratch vectors indexed by ArithVar:
+   * d_bufferOffset[x] is one more than the offset of x on the buffered row
+   * (0 if x is not on it), and d_bufferUsed[x] marks the buffered entries
+   * that the current row addition has already merged.
+   */
+  std::vector<EntryOffset> d_bufferOffset;
+  std::vector<bool> d_bufferUsed;
 
   /* The row that is in the merge buffer. */
   RowIndex d_rowInMergeBuffer;
 
   uint32_t d_entriesInUse;
-  MatrixEntryVector<T> d_entries;
 
   std::vector<RowIndex> d_pool;
 
@@ -389,20 +354,20 @@ public:
   Matrix()
   : d_rows(),
     d_columns(),
-    d_mergeBuffer(),
+    d_bufferOffset(),
+    d_bufferUsed(),
     d_rowInMergeBuffer(ROW_INDEX_SENTINEL),
     d_entriesInUse(0),
-    d_entries(),
     d_zero(0)
   {}
 
   Matrix(const T& zero)
   : d_rows(),
     d_columns(),
-    d_mergeBuffer(),
+    d_bufferOffset(),
+    d_bufferUsed(),
     d_rowInMergeBuffer(ROW_INDEX_SENTINEL),
     d_entriesInUse(0),
-    d_entries(),
     d_zero(zero)
   {}
 
@@ -416,44 +381,49 @@ protected:
     Assert(row < d_rows.size());
     Assert(col < d_columns.size());
 
-    EntryID newId = d_entries.newEntry();
-    Entry& newEntry = d_entries.get(newId);
-    newEntry = Entry(row, col, coeff);
-
-    Assert(newEntry.getCoefficient() != 0);
-
+    EntryOffset colOffset = d_columns[col].getSize();
+    EntryOffset rowOffset = d_rows[row].insert(Entry(row, col, coeff, colOffset));
+    d_columns[col].insert(MatrixPosition(row, rowOffset));
 
     ++d_entriesInUse;
-
-    d_rows[row].insert(newId);
-    d_columns[col].insert(newId);
   }
 
-  void removeEntry(EntryID id){
+  void removeEntry(RowIndex row, EntryOffset rowOffset){
     Assert(d_entriesInUse > 0);
     --d_entriesInUse;
 
-    Entry& entry = d_entries.get(id);
-
-    RowIndex ridx = entry.getRowIndex();
+    RowVectorT& rowVector = d_rows[row];
+    const Entry& entry = rowVector[rowOffset];
     ArithVar col = entry.getColVar();
+    EntryOffset colOffset = entry.getColOffset();
 
-    Assert(d_rows[ridx].getSize() > 0);
-    Assert(d_columns[col].getSize() > 0);
-
-    d_rows[ridx].remove(id);
-    d_columns[col].remove(id);
+    ColumnVectorT& column = d_columns[col];
+    Assert(column.getSize() > 0);
+    Assert(rowVector.getSize() > 0);
 
-    entry.markBlank();
-
-    d_entries.freeEntry(id);
+    // The last occurrence of the column moves into the freed slot.
+    EntryOffset lastInCol = column.getSize() - 1;
+    if(colOffset != lastInCol){
+      const MatrixPosition& moved = column[lastInCol];
+      d_rows[moved.d_rowIndex].get(moved.d_rowOffset).setColOffset(colOffset);
+    }
+    column.remove(colOffset);
+
+    // The last entry of the row moves into the freed slot.
+    // It is in a different column, so its occurrence was not touched above.
+    EntryOffset lastInRow = rowVector.getSize() - 1;
+    if(rowOffset != lastInRow){
+      const Entry& moved = rowVector[lastInRow];
+      d_columns[moved.getColVar()].get(moved.getColOffset()).d_rowOffset = rowOffset;
+    }
+    rowVector.remove(rowOffset);
   }
 
  private:
   RowIndex requestRowIndex(){
     if(d_pool.empty()){
       RowIndex ridx = d_rows.size();
-      d_rows.push_back(RowVectorT(&d_entries));
+      d_rows.push_back(RowVectorT());
       return ridx;
     }else{
       RowIndex rid = d_pool.back();
@@ -477,7 +447,9 @@ public:
   }
 
   void increaseSize(){
-    d_columns.push_back(ColumnVector<T>(&d_entries));
+    d_columns.push_back(ColumnVectorT());
+    d_bufferOffset.push_back(0);
+    d_bufferUsed.push_back(false);
   }
 
   const RowVector<T>& getRow(RowIndex r) const {
@@ -490,6 +462,10 @@ public:
     return d_columns[v];
   }
 
+  ColIterator colIterator(ArithVar v) const {
+    return getColumn(v).begin(d_rows);
+  }
+
   uint32_t getRowLength(RowIndex r) const{
     return getRow(r).getSize();
   }
@@ -508,15 +484,12 @@ public:
 
     RowIndex ridx = requestRowIndex();
 
-    //RowIndex ridx = d_rows.size();
-    //d_rows.push_back(RowVectorT(&d_entries));
-
-    std::vector<Rational>::const_iterator coeffIter = coeffs.begin();
+    typename std::vector<T>::const_iterator coeffIter = coeffs.begin();
     std::vector<ArithVar>::const_iterator varsIter = variables.begin();
     std::vector<ArithVar>::const_iterator varsEnd = variables.end();
 
     for(; varsIter != varsEnd; ++coeffIter, ++varsIter){
-      const Rational& coeff = *coeffIter;
+      const T& coeff = *coeffIter;
       ArithVar var_i = *varsIter;
       Assert(var_i < getNumColumns());
       addEntry(ridx, var_i, coeff);
@@ -527,15 +500,13 @@ public:
 
 
   void loadRowIntoBuffer(RowIndex rid){
-    Assert(d_mergeBuffer.empty());
     Assert(d_rowInMergeBuffer == ROW_INDEX_SENTINEL);
 
-    RowIterator i = getRow(rid).begin(), i_end = getRow(rid).end();
-    for(; i != i_end; ++i){
-      EntryID id = i.getID();
-      const MatrixEntry<T>& entry = *i;
-      ArithVar colVar = entry.getColVar();
-      d_mergeBuffer.set(colVar, std::make_pair(id, false));
+    const RowVectorT& row = getRow(rid);
+    for(EntryOffset i = 0, N = row.getSize(); i < N; ++i){
+      ArithVar colVar = row[i].getColVar();
+      Assert(d_bufferOffset[colVar] == 0);
+      d_bufferOffset[colVar] = i + 1;
     }
 
     d_rowInMergeBuffer = rid;
@@ -544,14 +515,19 @@ public:
   void clearBuffer() {
     Assert(d_rowInMergeBuffer != ROW_INDEX_SENTINEL);
 
+    const RowVectorT& row = getRow(d_rowInMergeBuffer);
+    for(EntryOffset i = 0, N = row.getSize(); i < N; ++i){
+      d_bufferOffset[row[i].getColVar()] = 0;
+    }
+
     d_rowInMergeBuffer = ROW_INDEX_SENTINEL;
-    d_mergeBuffer.purge();
   }
 
   /**  to += mult * buffer. */
   void rowPlusBufferTimesConstant(RowIndex to, const T& mult){
     Assert(d_rowInMergeBuffer != ROW_INDEX_SENTINEL);
     Assert(to != ROW_INDEX_SENTINEL);
+    Assert(to != d_rowInMergeBuffer);
 
     Debug("tableau") << "rowPlusRowTimesConstant("
                      << to << "," << mult << "," << d_rowInMergeBuffer << ")"
@@ -562,41 +538,39 @@ public:
 
     Assert(mult != 0);
 
+    RowVectorT& toRow = d_rows[to];
+    const RowVectorT& bufferRow = d_rows[d_rowInMergeBuffer];
 
-    RowIterator i = getRow(to).begin();
-    RowIterator i_end = getRow(to).end();
-    while(i != i_end){
-      EntryID id = i.getID();
-      Entry& entry = d_entries.get(id);
+    bool cancelled = false;
+    for(EntryOffset i = 0, N = toRow.getSize(); i < N; ++i){
+      Entry& entry = toRow.get(i);
       ArithVar colVar = entry.getColVar();
+      EntryOffset inBuffer = d_bufferOffset[colVar];
+      if(inBuffer != 0){
+        Assert(!d_bufferUsed[colVar]);
+        d_bufferUsed[colVar] = true;
 
-      ++i;
-
-      if(d_mergeBuffer.isKey(colVar)){
-        EntryID bufferEntry = d_mergeBuffer[colVar].first;
-        Assert(!d_mergeBuffer[colVar].second);
-        d_mergeBuffer.get(colVar).second = true;
-
-        const Entry& other = d_entries.get(bufferEntry);
-        entry.getCoefficient() += mult * other.getCoefficient();
+        entry.getCoefficient() += mult * bufferRow[inBuffer - 1].getCoefficient();
+        cancelled = cancelled || entry.getCoefficient() == d_zero;
+      }
+    }
 
-        if(entry.getCoefficient() == d_zero){
-          removeEntry(id);
+    if(cancelled){
+      // Going backwards, the entry moved into a freed slot was already checked.
+      for(EntryOffset i = toRow.getSize(); i > 0; --i){
+        if(toRow[i - 1].getCoefficient() == d_zero){
+          removeEntry(to, i - 1);
         }
       }
     }
 
-    i = getRow(d_rowInMergeBuffer).begin();
-    i_end = getRow(d_rowInMergeBuffer).end();
-
-    for(; i != i_end; ++i){
-      const Entry& entry = *i;
+    for(EntryOffset i = 0, N = bufferRow.getSize(); i < N; ++i){
+      const Entry& entry = bufferRow[i];
       ArithVar colVar = entry.getColVar();
 
-      if(d_mergeBuffer[colVar].second){
-        d_mergeBuffer.get(colVar).second = false;
+      if(d_bufferUsed[colVar]){
+        d_bufferUsed[colVar] = false;
       }else{
-        Assert(!(d_mergeBuffer[colVar]).second);
         T newCoeff =  mult * entry.getCoefficient();
         addEntry(to, colVar, newCoeff);
       }
@@ -608,11 +582,8 @@ public:
   }
 
   bool mergeBufferIsClear() const{
-    RowToPosUsedPairMap::const_iterator i = d_mergeBuffer.begin();
-    RowToPosUsedPairMap::const_iterator i_end = d_mergeBuffer.end();
-    for(; i != i_end; ++i){
-      RowIndex rid = *i;
-      if(d_mergeBuffer[rid].second){
+    for(ArithVar v = 0, N = d_bufferUsed.size(); v < N; ++v){
+      if(d_bufferUsed[v]){
         return false;
       }
     }
@@ -621,32 +592,24 @@ public:
 
 protected:
 
-  EntryID findOnRow(RowIndex rid, ArithVar column){
-    RowIterator i = d_rows[rid].begin(), i_end = d_rows[rid].end();
-    for(; i != i_end; ++i){
-      EntryID id = i.getID();
-      const MatrixEntry<T>& entry = *i;
-      ArithVar colVar = entry.getColVar();
-
-      if(colVar == column){
-        return id;
+  EntryOffset findOnRow(RowIndex rid, ArithVar column) const{
+    const RowVectorT& row = d_rows[rid];
+    for(EntryOffset i = 0, N = row.getSize(); i < N; ++i){
+      if(row[i].getColVar() == column){
+        return i;
       }
     }
-    return ENTRYID_SENTINEL;
+    return ENTRY_OFFSET_SENTINEL;
   }
 
-  EntryID findOnCol(RowIndex rid, ArithVar column){
-    ColIterator i = d_columns[column].begin(), i_end = d_columns[column].end();
-    for(; i != i_end; ++i){
-      EntryID id = i.getID();
-      const MatrixEntry<T>& entry = *i;
-      RowIndex currRow = entry.getRowIndex();
-
-      if(currRow == rid){
-        return id;
+  EntryOffset findOnCol(RowIndex rid, ArithVar column) const{
+    const ColumnVectorT& col = d_columns[column];
+    for(EntryOffset i = 0, N = col.getSize(); i < N; ++i){
+      if(col[i].d_rowIndex == rid){
+        return col[i].d_rowOffset;
       }
     }
-    return ENTRYID_SENTINEL;
+    return ENTRY_OFFSET_SENTINEL;
   }
 
   MatrixEntry<T> d_failedFind;
@@ -655,11 +618,11 @@ public:
   /** If the find fails, isUnused is true on the entry. */
   const MatrixEntry<T>& findEntry(RowIndex rid, ArithVar col){
     bool colIsShorter = getColLength(col) < getRowLength(rid);
-    EntryID id = colIsShorter ? findOnCol(rid, col) : findOnRow(rid,col);
-    if(id == ENTRYID_SENTINEL){
+    EntryOffset offset = colIsShorter ? findOnCol(rid, col) : findOnRow(rid,col);
+    if(offset == ENTRY_OFFSET_SENTINEL){
       return d_failedFind;
     }else{
-      return d_entries.get(id);
+      return d_rows[rid][offset];
     }
   }
 
@@ -690,39 +653,24 @@ public:
     Debug("matrix") << entry.getColVar() << "*" << entry.getCoefficient();
   }
 
-
-protected:
-
-  // static bool bufferPairIsNotEmpty(const PosUsedPair& p){
-  //   return !(p.first == ENTRYID_SENTINEL && p.second == false);
-  // }
-
-  // static bool bufferPairIsEmpty(const PosUsedPair& p){
-  //   return (p.first == ENTRYID_SENTINEL && p.second == false);
-  // }
-  // bool mergeBufferIsEmpty() const {
-  //   return d_mergeBuffer.end() == std::find_if(d_mergeBuffer.begin(),
-  //                                              d_mergeBuffer.end(),
-  //                                              bufferPairIsNotEmpty);
-  // }
-
 public:
   uint32_t size() const {
     return d_entriesInUse;
   }
   uint32_t getNumEntriesInTableau() const {
-    return d_entries.size();
+    return d_entriesInUse;
   }
   uint32_t getEntryCapacity() const {
-    return d_entries.capacity();
+    uint32_t capacity = 0;
+    for(RowIndex rid = 0, N = d_rows.size(); rid < N; ++rid){
+      capacity += d_rows[rid].getCapacity();
+    }
+    return capacity;
   }
 
   void removeRow(RowIndex rid){
-    RowIterator i = getRow(rid).begin();
-    RowIterator i_end = getRow(rid).end();
-    for(; i != i_end; ++i){
-      EntryID id = i.getID();
-      removeEntry(id);
+    while(getRowLength(rid) > 0){
+      removeEntry(rid, getRowLength(rid) - 1);
     }
     releaseRowIndex(rid);
   }
@@ -804,9 +752,9 @@ protected:
   uint32_t debugCountColLength(ArithVar var){
     Debug("tableau") << var << " ";
     uint32_t count = 0;
-    for(ColIterator i=getColumn(var).begin(); !i.atEnd(); ++i){
+    for(ColIterator i=colIterator(var); !i.atEnd(); ++i){
       const Entry& entry = *i;
-      Debug("tableau") << "(" << entry.getRowIndex() << ", " << i.getID() << ") ";
+      Debug("tableau") << "(" << entry.getRowIndex() << ", " << entry.getColOffset() << ") ";
       ++count;
     }
     Debug("tableau") << std::endl;
@@ -841,6 +789,9 @@ private:
   typedef DenseMap<ArithVar> RowIndexToBasicMap;
   RowIndexToBasicMap d_rowIndex2basic;
 
+  /** Scratch copy of the column of the entering variable during a pivot. */
+  std::vector<MatrixPosition> d_pivotColumn;
+
 public:
 
   Tableau() : Matrix<Rational>(Rational(0)) {}
@@ -879,10 +830,6 @@ public:
     return d_rowIndex2basic[rid];
   }
 
-  ColIterator colIterator(ArithVar x) const {
-    return getColumn(x).begin();
-  }
-
   RowIterator basicRowIterator(ArithVar basic) const {
     return getRow(basicToRowIndex(basic)).begin();
   }
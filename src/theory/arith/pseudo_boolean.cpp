@@ -0,0 +1,182 @@
+/*********************                                                        */
+/*! \file pseudo_boolean.cpp
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Propagation of bounds on sums of 0/1 integer variables.
+ **/
+
+#include "theory/arith/pseudo_boolean.h"
+
+using namespace std;
+
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::arith;
+
+PseudoBooleanPropagator::PseudoBooleanPropagator(const ArithPartialModel& pm) :
+  d_rows(),
+  d_rowsOf(),
+  d_queue(),
+  d_queued(),
+  d_partialModel(pm),
+  d_statistics()
+{}
+
+PseudoBooleanPropagator::Statistics::Statistics() :
+  d_rows("theory::arith::pb::rows", 0),
+  d_visits("theory::arith::pb::visits", 0),
+  d_conflicts("theory::arith::pb::conflicts", 0),
+  d_implications("theory::arith::pb::implications", 0)
+{
+  StatisticsRegistry::registerStat(&d_rows);
+  StatisticsRegistry::registerStat(&d_visits);
+  StatisticsRegistry::registerStat(&d_conflicts);
+  StatisticsRegistry::registerStat(&d_implications);
+}
+
+PseudoBooleanPropagator::Statistics::~Statistics(){
+  StatisticsRegistry::unregisterStat(&d_rows);
+  StatisticsRegistry::unregisterStat(&d_visits);
+  StatisticsRegistry::unregisterStat(&d_conflicts);
+  StatisticsRegistry::unregisterStat(&d_implications);
+}
+
+void PseudoBooleanPropagator::addRow(ArithVar slack, const std::vector<ArithVar>& variables,
+                                     const std::vector<Rational>& coefficients){
+  Assert(variables.size() == coefficients.size());
+  RowId id = d_rows.size();
+  d_rows.push_back(Row());
+  Row& row = d_rows.back();
+  row.d_slack = slack;
+  row.d_variables = variables;
+  row.d_coefficients = coefficients;
+  d_queued.push_back(false);
+
+  ArithVar largest = slack;
+  for(vector<ArithVar>::const_iterator i = variables.begin(); i != variables.end(); ++i){
+    largest = std::max(largest, *i);
+  }
+  if(largest >= d_rowsOf.size()){
+    d_rowsOf.resize(largest + 1);
+  }
+  d_rowsOf[slack].push_back(id);
+  for(vector<ArithVar>::const_iterator i = variables.begin(); i != variables.end(); ++i){
+    d_rowsOf[*i].push_back(id);
+  }
+  ++(d_statistics.d_rows);
+}
+
+bool PseudoBooleanPropagator::isBoolean(ArithVar x) const{
+  return d_partialModel.hasLowerBound(x) && d_partialModel.hasUpperBound(x) &&
+    d_partialModel.getLowerBound(x).sgn() >= 0 &&
+    d_partialModel.getUpperBound(x) <= DeltaRational(1);
+}
+
+bool PseudoBooleanPropagator::propagateBound(const Row& row, bool upper,
+                                             std::vector<Constraint>& conflict,
+                                             std::vector<PseudoBooleanImplication>& implied){
+  ArithVar s = row.d_slack;
+  Constraint bound = upper ?
+    d_partialModel.getUpperBoundConstraint(s) : d_partialModel.getLowerBoundConstraint(s);
+
+  // For a lower bound on s, the largest value of s uses the upper bounds of
+  // the variables with a positive coefficient and the lower bounds of the
+  // others. For an upper bound on s, the smallest value is symmetric.
+  vector<Constraint> reasons;
+  Rational extreme(0);
+  for(size_t i = 0, N = row.d_variables.size(); i < N; ++i){
+    ArithVar x = row.d_variables[i];
+    bool useUpper = (row.d_coefficients[i].sgn() > 0) != upper;
+    const DeltaRational& b = useUpper ?
+      d_partialModel.getUpperBound(x) : d_partialModel.getLowerBound(x);
+    extreme = extreme + row.d_coefficients[i] * b.getNoninfinitesimalPart();
+    reasons.push_back(useUpper ?
+                      d_partialModel.getUpperBoundConstraint(x) :
+                      d_partialModel.getLowerBoundConstraint(x));
+  }
+
+  DeltaRational slack = upper ?
+    bound->getValue() - DeltaRational(extreme) :
+    DeltaRational(extreme) - bound->getValue();
+
+  if(slack.sgn() < 0){
+    ++(d_statistics.d_conflicts);
+    conflict.push_back(bound);
+    conflict.insert(conflict.end(), reasons.begin(), reasons.end());
+    Debug("arith::pb") << "pb conflict on " << s << endl;
+    return false;
+  }
+
+  for(size_t i = 0, N = row.d_variables.size(); i < N; ++i){
+    ArithVar x = row.d_variables[i];
+    if(!(d_partialModel.getLowerBound(x).sgn() == 0 &&
+         d_partialModel.getUpperBound(x) == DeltaRational(1))){
+      continue;
+    }
+    const Rational& a = row.d_coefficients[i];
+    if(DeltaRational(a.abs()) > slack){
+      // x has to take the value that moves s towards the bound
+      bool one = (a.sgn() > 0) != upper;
+      PseudoBooleanImplication imp(x, one ? LowerBound : UpperBound, DeltaRational(one ? 1 : 0));
+      imp.d_reasons.push_back(bound);
+      for(size_t j = 0; j < N; ++j){
+        if(j != i){
+          imp.d_reasons.push_back(reasons[j]);
+        }
+      }
+      implied.push_back(imp);
+      ++(d_statistics.d_implications);
+    }
+  }
+  return true;
+}
+
+bool PseudoBooleanPropagator::propagate(std::vector<Constraint>& conflict,
+                                        std::vector<PseudoBooleanImplication>& implied){
+  while(!d_queue.empty()){
+    RowId id = d_queue.back();
+    d_queue.pop_back();
+    d_queued[id] = false;
+
+    const Row& row = d_rows[id];
+    ArithVar s = row.d_slack;
+    bool hasLower = d_partialModel.hasLowerBound(s);
+    bool hasUpper = d_partialModel.hasUpperBound(s);
+    if(!hasLower && !hasUpper){
+      continue;
+    }
+
+    bool allBoolean = true;
+    for(vector<ArithVar>::const_iterator i = row.d_variables.begin(); i != row.d_variables.end(); ++i){
+      if(!isBoolean(*i)){
+        allBoolean = false;
+        break;
+      }
+    }
+    if(!allBoolean){
+      continue;
+    }
+
+    ++(d_statistics.d_visits);
+    if((hasLower && !propagateBound(row, false, conflict, implied)) ||
+       (hasUpper && !propagateBound(row, true, conflict, implied))){
+      clearQueue();
+      return false;
+    }
+  }
+  return true;
+}
+
+void PseudoBooleanPropagator::clearQueue(){
+  for(vector<RowId>::const_iterator i = d_queue.begin(); i != d_queue.end(); ++i){
+    d_queued[*i] = false;
+  }
+  d_queue.clear();
+}
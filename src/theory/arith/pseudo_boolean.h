@@ -0,0 +1,146 @@
+/*********************                                                        */
+/*! \file pseudo_boolean.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Propagation of bounds on sums of 0/1 integer variables.
+ **
+ ** A slack variable s = a_1 x_1 + ... + a_n x_n over integer variables
+ ** x_i whose bounds are within [0, 1] is a pseudo-Boolean (or, if every
+ ** a_i is 1, a cardinality) constraint once s is bounded.
+ ** For a lower bound s >= c the slack of the row is
+ **   max(s) - c = sum_{a_i > 0} a_i ub(x_i) + sum_{a_i < 0} a_i lb(x_i) - c.
+ ** If the slack is negative the bounds are in conflict, and every
+ ** unfixed x_i with |a_i| > slack is fixed to the value that contributes
+ ** the most to s. Upper bounds on s are symmetric.
+ **
+ ** Rows are revisited only when one of their variables gets a new bound.
+ ** The 0/1 bounds of the variables introduced for (ite b 1 0) terms are
+ ** learned by the static learner.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__ARITH__PSEUDO_BOOLEAN_H
+#define __CVC4__THEORY__ARITH__PSEUDO_BOOLEAN_H
+
+#include "theory/arith/arithvar.h"
+#include "theory/arith/constraint.h"
+#include "theory/arith/delta_rational.h"
+#include "theory/arith/partial_model.h"
+#include "util/statistics_registry.h"
+
+#include <vector>
+
+namespace CVC4 {
+namespace theory {
+namespace arith {
+
+/**
+ * A bound implied by a pseudo-Boolean row.
+ * This is not yet a constraint: the theory looks up the constraint.
+ */
+struct PseudoBooleanImplication {
+  ArithVar d_var;
+  ConstraintType d_type;
+  DeltaRational d_value;
+  std::vector<Constraint> d_reasons;
+
+  PseudoBooleanImplication(ArithVar v, ConstraintType t, const DeltaRational& value) :
+    d_var(v), d_type(t), d_value(value), d_reasons()
+  {}
+};/* struct PseudoBooleanImplication */
+
+class PseudoBooleanPropagator {
+private:
+  typedef uint32_t RowId;
+
+  /** d_slack = sum_i d_coefficients[i] * d_variables[i] */
+  struct Row {
+    ArithVar d_slack;
+    std::vector<ArithVar> d_variables;
+    std::vector<Rational> d_coefficients;
+  };
+  std::vector<Row> d_rows;
+
+  /** ArithVar |-> the rows it appears in, as the slack or as a variable. */
+  std::vector< std::vector<RowId> > d_rowsOf;
+
+  /** The rows with a new bound since the last call to propagate(). */
+  std::vector<RowId> d_queue;
+  std::vector<bool> d_queued;
+
+  const ArithPartialModel& d_partialModel;
+
+  /** Returns true if the bounds of x are within [0, 1]. */
+  bool isBoolean(ArithVar x) const;
+
+  /**
+   * Propagates the lower bound (if upper is false) or the upper bound of
+   * the slack of row. Returns false and fills conflict on a conflict.
+   */
+  bool propagateBound(const Row& row, bool upper, std::vector<Constraint>& conflict,
+                      std::vector<PseudoBooleanImplication>& implied);
+
+  class Statistics {
+  public:
+    IntStat d_rows;
+    IntStat d_visits;
+    IntStat d_conflicts;
+    IntStat d_implications;
+
+    Statistics();
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+
+public:
+  PseudoBooleanPropagator(const ArithPartialModel& pm);
+
+  /**
+   * Adds the row slack = sum_i coefficients[i] * variables[i].
+   * The caller checks that the variables are integer and the coefficients
+   * are integral.
+   */
+  void addRow(ArithVar slack, const std::vector<ArithVar>& variables,
+              const std::vector<Rational>& coefficients);
+
+  /** Notes that x has a new bound. */
+  void notifyBound(ArithVar x){
+    if(x < d_rowsOf.size()){
+      const std::vector<RowId>& rows = d_rowsOf[x];
+      for(std::vector<RowId>::const_iterator i = rows.begin(), end = rows.end(); i != end; ++i){
+        if(!d_queued[*i]){
+          d_queued[*i] = true;
+          d_queue.push_back(*i);
+        }
+      }
+    }
+  }
+
+  bool hasPendingRows() const { return !d_queue.empty(); }
+
+  /**
+   * Propagates the queued rows. Returns false if the bounds of a row are in
+   * conflict and fills conflict with the bound constraints of the row.
+   * The implications found are appended to implied.
+   */
+  bool propagate(std::vector<Constraint>& conflict,
+                 std::vector<PseudoBooleanImplication>& implied);
+
+  /** Empties the queue of rows without propagating. */
+  void clearQueue();
+};/* class PseudoBooleanPropagator */
+
+}/* CVC4::theory::arith namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__ARITH__PSEUDO_BOOLEAN_H */
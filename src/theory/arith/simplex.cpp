@@ -72,7 +72,12 @@ SimplexDecisionProcedure::Statistics::Statistics():
   d_weakeningSuccesses("theory::arith::weakening::success",0),
   d_weakenings("theory::arith::weakening::total",0),
   d_weakenTime("theory::arith::weakening::time"),
-  d_simplexConflicts("theory::arith::simplexConflicts",0)
+  d_simplexConflicts("theory::arith::simplexConflicts",0),
+  d_approxAttempts("theory::arith::approx::attempts",0),
+  d_approxFeasible("theory::arith::approx::feasible",0),
+  d_approxPivots("theory::arith::approx::pivots",0),
+  d_approxReplayPivots("theory::arith::approx::replayPivots",0),
+  d_approxTime("theory::arith::approx::time")
 {
   StatisticsRegistry::registerStat(&d_statUpdateConflicts);
 
@@ -95,6 +100,12 @@ SimplexDecisionProcedure::Statistics::Statistics():
   StatisticsRegistry::registerStat(&d_weakenTime);
 
   StatisticsRegistry::registerStat(&d_simplexConflicts);
+
+  StatisticsRegistry::registerStat(&d_approxAttempts);
+  StatisticsRegistry::registerStat(&d_approxFeasible);
+  StatisticsRegistry::registerStat(&d_approxPivots);
+  StatisticsRegistry::registerStat(&d_approxReplayPivots);
+  StatisticsRegistry::registerStat(&d_approxTime);
 }
 
 SimplexDecisionProcedure::Statistics::~Statistics(){
@@ -119,6 +130,12 @@ SimplexDecisionProcedure::Statistics::~Statistics(){
   StatisticsRegistry::unregisterStat(&d_weakenTime);
 
   StatisticsRegistry::unregisterStat(&d_simplexConflicts);
+
+  StatisticsRegistry::unregisterStat(&d_approxAttempts);
+  StatisticsRegistry::unregisterStat(&d_approxFeasible);
+  StatisticsRegistry::unregisterStat(&d_approxPivots);
+  StatisticsRegistry::unregisterStat(&d_approxReplayPivots);
+  StatisticsRegistry::unregisterStat(&d_approxTime);
 }
 
 
@@ -249,6 +266,10 @@ Result::Sat SimplexDecisionProcedure::findModel(bool exactResult){
   instance = instance + 1;
   Debug("arith::findModel") << "begin findModel()" << instance << endl;
 
+  if(options::arithApproxSimplex()){
+    replayApproximateBasis();
+  }
+
   d_queue.transitionToDifferenceMode();
 
   Result::Sat result = Result::SAT_UNKNOWN;
@@ -383,6 +404,75 @@ Result::Sat SimplexDecisionProcedure::findModel(bool exactResult){
   // return foundConflict;
 }
 
+DeltaRational SimplexDecisionProcedure::approximateValue(const ApproximateSimplex& approx, ArithVar x) const{
+  switch(approx.getState(x)){
+  case ApproximateSimplex::AtLower:
+    if(d_partialModel.hasLowerBound(x)){ return d_partialModel.getLowerBound(x); }
+    break;
+  case ApproximateSimplex::AtUpper:
+    if(d_partialModel.hasUpperBound(x)){ return d_partialModel.getUpperBound(x); }
+    break;
+  default:
+    break;
+  }
+
+  // Nonbasic variables must stay within their bounds.
+  const DeltaRational& assignment = d_partialModel.getAssignment(x);
+  if(d_partialModel.strictlyLessThanLowerBound(x, assignment)){
+    return d_partialModel.getLowerBound(x);
+  }else if(d_partialModel.strictlyGreaterThanUpperBound(x, assignment)){
+    return d_partialModel.getUpperBound(x);
+  }else{
+    return assignment;
+  }
+}
+
+void SimplexDecisionProcedure::replayApproximateBasis(){
+  TimerStat::CodeTimer codeTimer(d_statistics.d_approxTime);
+  ++(d_statistics.d_approxAttempts);
+
+  ApproximateSimplex approx(d_partialModel, d_tableau);
+  bool feasible = approx.findFeasibleBasis(options::arithApproxSimplexPivots());
+  d_statistics.d_approxPivots += approx.getPivots();
+  if(!feasible){
+    Debug("arith::approx") << "approx: no feasible basis found" << endl;
+    return;
+  }
+  ++(d_statistics.d_approxFeasible);
+
+  // The Tableau can only be changed by pivots, so the approximate basis is
+  // re-established one exact pivot at a time. Each pivot swaps a variable that
+  // is basic in the approximate solution with one that is not.
+  ArithVar numVars = d_tableau.getNumColumns();
+  for(ArithVar x = 0; x < numVars; ++x){
+    if(approx.getState(x) != ApproximateSimplex::Basic || d_tableau.isBasic(x)){
+      continue;
+    }
+    ArithVar leaving = ARITHVAR_SENTINEL;
+    for(Tableau::ColIterator i = d_tableau.colIterator(x); !i.atEnd(); ++i){
+      ArithVar basic = d_tableau.rowIndexToBasic((*i).getRowIndex());
+      if(approx.getState(basic) != ApproximateSimplex::Basic){
+        leaving = basic;
+        break;
+      }
+    }
+    if(leaving != ARITHVAR_SENTINEL){
+      d_linEq.pivotAndUpdate(leaving, x, approximateValue(approx, leaving));
+      ++(d_statistics.d_approxReplayPivots);
+    }
+  }
+
+  // Move the nonbasic variables to the bounds the approximate solution chose.
+  for(ArithVar x = 0; x < numVars; ++x){
+    if(!d_tableau.isBasic(x)){
+      DeltaRational value = approximateValue(approx, x);
+      if(value != d_partialModel.getAssignment(x)){
+        d_linEq.update(x, value);
+      }
+    }
+  }
+}
+
 Node SimplexDecisionProcedure::checkBasicForConflict(ArithVar basic){
 
   Assert(d_tableau.isBasic(basic));
@@ -54,6 +54,7 @@
 #include "theory/arith/matrix.h"
 #include "theory/arith/partial_model.h"
 #include "theory/arith/linear_equality.h"
+#include "theory/arith/approx_simplex.h"
 
 #include "context/cdlist.h"
 
@@ -173,6 +174,18 @@ private:
 
 
 private:
+  /**
+   * Runs the floating point simplex on a copy of the tableau and, if it finds
+   * a basis that looks feasible, re-establishes that basis with exact pivots
+   * and moves the nonbasic variables to the bounds it chose.
+   * The basic variables left inconsistent by the rounding errors are
+   * enqueued as usual and are repaired by the exact search.
+   */
+  void replayApproximateBasis();
+
+  /** The exact value x should take as a nonbasic variable in the approximate solution. */
+  DeltaRational approximateValue(const ApproximateSimplex& approx, ArithVar x) const;
+
   bool searchForFeasibleSolution(uint32_t maxIterations);
 
   enum SearchPeriod {BeforeDiffSearch, DuringDiffSearch, AfterDiffSearch, DuringVarOrderSearch, AfterVarOrderSearch};
@@ -288,6 +301,10 @@ private:
 
     IntStat d_simplexConflicts;
 
+    IntStat d_approxAttempts, d_approxFeasible;
+    IntStat d_approxPivots, d_approxReplayPivots;
+    TimerStat d_approxTime;
+
     Statistics();
     ~Statistics();
   };
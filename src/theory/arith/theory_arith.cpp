@@ -58,6 +58,8 @@ const uint32_t RESET_START = 2;
 TheoryArith::TheoryArith(context::Context* c, context::UserContext* u, OutputChannel& out, Valuation valuation, const LogicInfo& logicInfo, QuantifiersEngine* qe) :
   Theory(THEORY_ARITH, c, u, out, valuation, logicInfo, qe),
   d_nlIncomplete( false),
+  d_nlMonomials(),
+  d_nlLemmas(u),
   d_qflraStatus(Result::SAT_UNKNOWN),
   d_unknownsInARow(0),
   d_hasDoneWorkSinceCut(false),
@@ -68,6 +70,11 @@ TheoryArith::TheoryArith(context::Context* c, context::UserContext* u, OutputCha
   d_assertionsThatDoNotMatchTheirLiterals(c),
   d_nextIntegerCheckVar(0),
   d_constantIntegerVariables(c),
+  d_cutRoundsSinceBranch(c, 0),
+  d_cuts(u),
+  d_unateLemmasSent(u),
+  d_atomsPerVariable(),
+  d_unateAtomsCovered(u),
   d_diseqQueue(c, false),
   d_currentPropagationList(),
   d_learnedBounds(c),
@@ -75,6 +82,8 @@ TheoryArith::TheoryArith(context::Context* c, context::UserContext* u, OutputCha
   d_tableau(),
   d_linEq(d_partialModel, d_tableau, d_basicVarModelUpdateCallBack),
   d_diosolver(c),
+  d_dlSolver(c),
+  d_pbPropagator(d_partialModel),
   d_restartsCounter(0),
   d_tableauSizeHasBeenModified(false),
   d_tableauResetDensity(1.6),
@@ -157,6 +166,19 @@ TheoryArith::Statistics::Statistics():
   d_presolveTime("theory::arith::presolveTime"),
   d_newPropTime("theory::arith::newPropTimer"),
   d_externalBranchAndBounds("theory::arith::externalBranchAndBounds",0),
+  d_differenceModels("theory::arith::dl::models", 0),
+  d_differencePropagations("theory::arith::dl::propagations", 0),
+  d_gomoryCuts("theory::arith::cuts::gomory", 0),
+  d_duplicateCuts("theory::arith::cuts::duplicates", 0),
+  d_cutRowsSkipped("theory::arith::cuts::skippedRows", 0),
+  d_cutTimer("theory::arith::cuts::time"),
+  d_lazyUnateVariables("theory::arith::unate::lazyVariables", 0),
+  d_lazyUnateLemmas("theory::arith::unate::lazyLemmas", 0),
+  d_nlRefinements("theory::arith::nl::refinements", 0),
+  d_nlSignLemmas("theory::arith::nl::signLemmas", 0),
+  d_nlTangentLemmas("theory::arith::nl::tangentLemmas", 0),
+  d_nlPointLemmas("theory::arith::nl::pointLemmas", 0),
+  d_pbPropagations("theory::arith::pb::propagations", 0),
   d_initialTableauSize("theory::arith::initialTableauSize", 0),
   d_currSetToSmaller("theory::arith::currSetToSmaller", 0),
   d_smallerSetToCurr("theory::arith::smallerSetToCurr", 0),
@@ -186,6 +208,24 @@ TheoryArith::Statistics::Statistics():
 
   StatisticsRegistry::registerStat(&d_externalBranchAndBounds);
 
+  StatisticsRegistry::registerStat(&d_differenceModels);
+  StatisticsRegistry::registerStat(&d_differencePropagations);
+
+  StatisticsRegistry::registerStat(&d_gomoryCuts);
+  StatisticsRegistry::registerStat(&d_duplicateCuts);
+  StatisticsRegistry::registerStat(&d_cutRowsSkipped);
+  StatisticsRegistry::registerStat(&d_cutTimer);
+
+  StatisticsRegistry::registerStat(&d_lazyUnateVariables);
+  StatisticsRegistry::registerStat(&d_lazyUnateLemmas);
+
+  StatisticsRegistry::registerStat(&d_nlRefinements);
+  StatisticsRegistry::registerStat(&d_nlSignLemmas);
+  StatisticsRegistry::registerStat(&d_nlTangentLemmas);
+  StatisticsRegistry::registerStat(&d_nlPointLemmas);
+
+  StatisticsRegistry::registerStat(&d_pbPropagations);
+
   StatisticsRegistry::registerStat(&d_initialTableauSize);
   StatisticsRegistry::registerStat(&d_currSetToSmaller);
   StatisticsRegistry::registerStat(&d_smallerSetToCurr);
@@ -219,6 +259,24 @@ TheoryArith::Statistics::~Statistics(){
 
   StatisticsRegistry::unregisterStat(&d_externalBranchAndBounds);
 
+  StatisticsRegistry::unregisterStat(&d_differenceModels);
+  StatisticsRegistry::unregisterStat(&d_differencePropagations);
+
+  StatisticsRegistry::unregisterStat(&d_gomoryCuts);
+  StatisticsRegistry::unregisterStat(&d_duplicateCuts);
+  StatisticsRegistry::unregisterStat(&d_cutRowsSkipped);
+  StatisticsRegistry::unregisterStat(&d_cutTimer);
+
+  StatisticsRegistry::unregisterStat(&d_lazyUnateVariables);
+  StatisticsRegistry::unregisterStat(&d_lazyUnateLemmas);
+
+  StatisticsRegistry::unregisterStat(&d_nlRefinements);
+  StatisticsRegistry::unregisterStat(&d_nlSignLemmas);
+  StatisticsRegistry::unregisterStat(&d_nlTangentLemmas);
+  StatisticsRegistry::unregisterStat(&d_nlPointLemmas);
+
+  StatisticsRegistry::unregisterStat(&d_pbPropagations);
+
   StatisticsRegistry::unregisterStat(&d_initialTableauSize);
   StatisticsRegistry::unregisterStat(&d_currSetToSmaller);
   StatisticsRegistry::unregisterStat(&d_smallerSetToCurr);
@@ -344,6 +402,10 @@ bool TheoryArith::AssertLower(Constraint constraint){
     }
   }
 
+  if(assertToDifferenceGraph(constraint)){
+    return true;
+  }
+
   d_currentPropagationList.push_back(constraint);
   d_currentPropagationList.push_back(d_partialModel.getLowerBoundConstraint(x_i));
 
@@ -464,6 +526,10 @@ bool TheoryArith::AssertUpper(Constraint constraint){
     }
   }
 
+  if(assertToDifferenceGraph(constraint)){
+    return true;
+  }
+
   d_currentPropagationList.push_back(constraint);
   d_currentPropagationList.push_back(d_partialModel.getUpperBoundConstraint(x_i));
   //It is fine if this is NullConstraint
@@ -553,6 +619,10 @@ bool TheoryArith::AssertEquality(Constraint constraint){
     Debug("dio::push") << x_i << endl;
   }
 
+  if(assertToDifferenceGraph(constraint)){
+    return true;
+  }
+
   // Don't bother to check whether x_i != c_i is in d_diseq
   // The a and (not a) should never be on the fact queue
   d_currentPropagationList.push_back(constraint);
@@ -860,14 +930,22 @@ void TheoryArith::setupVariableList(const VarList& vl){
       throw LogicException("Non-linear term was asserted to arithmetic in a linear logic.");
     }
 
-    d_out->setIncomplete();
+    if(!options::arithNlLinearize()){
+      d_out->setIncomplete();
+    }
     d_nlIncomplete = true;
 
     ++(d_statistics.d_statUserVariables);
-    requestArithVar(vlNode, false);
-    //ArithVar av = requestArithVar(vlNode, false);
+    ArithVar av = requestArithVar(vlNode, false);
     //setupInitialValue(av);
 
+    NonlinearMonomial m;
+    m.d_monomial = av;
+    for(VarList::iterator i = vl.begin(), end = vl.end(); i != end; ++i){
+      m.d_factors.push_back(d_arithvarNodeMap.asArithVar((*i).getNode()));
+    }
+    d_nlMonomials.push_back(m);
+
     markSetup(vlNode);
   }
 
@@ -1075,12 +1153,27 @@ void TheoryArith::setupPolynomial(const Polynomial& poly) {
             VarList vl1 = second.getVarList();
             if(vl0.singleton() && vl1.singleton()){
               d_congruenceManager.addWatchedPair(varSlack, vl0.getNode(), vl1.getNode());
+              if(options::arithDifferenceLogic()){
+                d_dlSolver.addDifference(varSlack,
+                                         d_arithvarNodeMap.asArithVar(vl0.getNode()),
+                                         d_arithvarNodeMap.asArithVar(vl1.getNode()));
+              }
             }
           }
         }
       }
     }
 
+    if(options::arithPseudoBoolean()){
+      bool integral = true;
+      for(size_t k = 0; k < variables.size() && integral; ++k){
+        integral = isInteger(variables[k]) && coefficients[k].isIntegral();
+      }
+      if(integral){
+        d_pbPropagator.addRow(varSlack, variables, coefficients);
+      }
+    }
+
     ++(d_statistics.d_statSlackVariables);
     markSetup(polyNode);
   }
@@ -1109,6 +1202,13 @@ void TheoryArith::setupAtom(TNode atom) {
 
   d_constraintDatabase.addLiteral(atom);
 
+  ArithVar v = d_constraintDatabase.lookup(atom)->getVariable();
+  if(d_atomsPerVariable.isKey(v)){
+    ++d_atomsPerVariable.get(v);
+  }else{
+    d_atomsPerVariable.set(v, 1);
+  }
+
   markSetup(atom);
 }
 
@@ -1134,6 +1234,10 @@ void TheoryArith::releaseArithVar(ArithVar v){
   Assert(d_arithvarNodeMap.hasNode(v));
   
   d_constraintDatabase.removeVariable(v);
+  if(d_atomsPerVariable.isKey(v)){
+    d_atomsPerVariable.remove(v);
+  }
+  d_dlSolver.removeVariable(v);
   d_arithvarNodeMap.remove(v);
 
   d_pool.push_back(v);
@@ -1186,6 +1290,10 @@ ArithVar TheoryArith::requestArithVar(TNode x, bool slack){
   d_variableTypes[varX] = type;
   d_slackVars[varX] = slack;
 
+  if(!slack && options::arithDifferenceLogic()){
+    d_dlSolver.addVariable(varX, type == ATInteger);
+  }
+
   d_constraintDatabase.addVariable(varX);
 
   d_arithvarNodeMap.setArithVar(x,varX);
@@ -1479,6 +1587,11 @@ bool TheoryArith::assertionCases(Constraint constraint){
 
   ArithVar x_i = constraint->getVariable();
 
+  if(options::arithLazyUnateLemmas()){
+    outputUnateLemmas(x_i);
+  }
+  d_pbPropagator.notifyBound(x_i);
+
   switch(constraint->getType()){
   case UpperBound:
     if(isInteger(x_i) && constraint->isStrictUpperBound()){
@@ -1584,18 +1697,22 @@ void TheoryArith::check(Effort effortLevel){
     if(inConflict()){ break; }
   }
   if(!inConflict()){
-    while(!d_learnedBounds.empty()){
-      // we may attempt some constraints twice.  this is okay!
-      Constraint curr = d_learnedBounds.front();
-      d_learnedBounds.pop();
-      Debug("arith::learned") << curr << endl;
-
-      bool res CVC4_UNUSED = assertionCases(curr);
-      Assert(!res || inConflict());
-
-      if(inConflict()){ break; }
-    }
+    do{
+      if(d_pbPropagator.hasPendingRows()){
+        propagatePseudoBoolean();
+      }
+      while(!inConflict() && !d_learnedBounds.empty()){
+        // we may attempt some constraints twice.  this is okay!
+        Constraint curr = d_learnedBounds.front();
+        d_learnedBounds.pop();
+        Debug("arith::learned") << curr << endl;
+
+        bool res CVC4_UNUSED = assertionCases(curr);
+        Assert(!res || inConflict());
+      }
+    }while(!inConflict() && d_pbPropagator.hasPendingRows());
   }
+  d_pbPropagator.clearQueue();
 
   if(inConflict()){
     d_qflraStatus = Result::UNSAT;
@@ -1622,6 +1739,10 @@ void TheoryArith::check(Effort effortLevel){
   bool emmittedConflictOrSplit = false;
   Assert(d_conflicts.empty());
 
+  if(newFacts && options::arithDifferenceLogic()){
+    installDifferenceModel();
+  }
+
   d_qflraStatus = d_simplex.findModel(fullEffort(effortLevel));
 
   switch(d_qflraStatus){
@@ -1757,18 +1878,31 @@ void TheoryArith::check(Effort effortLevel){
       }
     }
 
+    if(!emmittedConflictOrSplit && options::arithGomoryCuts() &&
+       d_cutRoundsSinceBranch < options::arithCutRoundsBeforeBranch()){
+      if(gomoryCutting()){
+        d_cutRoundsSinceBranch = d_cutRoundsSinceBranch + 1;
+        emmittedConflictOrSplit = true;
+      }
+    }
+
     if(!emmittedConflictOrSplit) {
       Node possibleLemma = roundRobinBranch();
       if(!possibleLemma.isNull()){
         ++(d_statistics.d_externalBranchAndBounds);
         emmittedConflictOrSplit = true;
+        d_cutRoundsSinceBranch = 0;
         d_out->lemma(possibleLemma);
       }
     }
   }//if !emmittedConflictOrSplit && fullEffort(effortLevel) && !hasIntegerModel()
   if(fullEffort(effortLevel) && d_nlIncomplete){
-    // TODO this is total paranoia
-    d_out->setIncomplete();
+    if(!options::arithNlLinearize()){
+      // TODO this is total paranoia
+      d_out->setIncomplete();
+    }else if(!emmittedConflictOrSplit){
+      emmittedConflictOrSplit = nonlinearRefinement();
+    }
   }
 
   if(Debug.isOn("paranoid:check_tableau")){ d_linEq.debugCheckTableau(); }
@@ -1776,12 +1910,245 @@ void TheoryArith::check(Effort effortLevel){
   Debug("arith") << "TheoryArith::check end" << std::endl;
 }
 
+bool TheoryArith::outputNonlinearLemma(Node lemma){
+  Node rewritten = Rewriter::rewrite(lemma);
+  if(rewritten.isConst() || d_nlLemmas.contains(rewritten)){
+    return false;
+  }
+  d_nlLemmas.insert(rewritten);
+  Debug("arith::nl") << "nl lemma " << rewritten << endl;
+  d_out->lemma(rewritten);
+  return true;
+}
+
+/** Returns the atom x > 0, x < 0 or x = 0 that holds for the value v of x. */
+static Node signAtom(TNode x, const Rational& v){
+  Node zero = mkRationalNode(0);
+  switch(v.sgn()){
+  case 1:  return NodeManager::currentNM()->mkNode(kind::GT, x, zero);
+  case -1: return NodeManager::currentNM()->mkNode(kind::LT, x, zero);
+  default: return x.eqNode(zero);
+  }
+}
+
+static Node mkImplies(const vector<Node>& premises, Node conclusion){
+  Node premise = premises.size() == 1 ? premises.front() :
+    NodeManager::currentNM()->mkNode(kind::AND, premises);
+  return premise.impNode(conclusion);
+}
+
+bool TheoryArith::nonlinearRefinement(){
+  if(d_qflraStatus != Result::SAT){
+    d_out->setIncomplete();
+    return false;
+  }
+
+  NodeManager* nm = NodeManager::currentNM();
+  const Rational& delta = d_partialModel.getDelta();
+
+  bool sentLemma = false;
+  bool exact = true;
+  for(vector<NonlinearMonomial>::const_iterator i = d_nlMonomials.begin(),
+        i_end = d_nlMonomials.end(); i != i_end; ++i){
+    const NonlinearMonomial& m = *i;
+
+    Rational product(1);
+    vector<Rational> values;
+    for(vector<ArithVar>::const_iterator j = m.d_factors.begin(); j != m.d_factors.end(); ++j){
+      values.push_back(d_partialModel.getAssignment(*j).substituteDelta(delta));
+      product = product * values.back();
+    }
+    Rational value = d_partialModel.getAssignment(m.d_monomial).substituteDelta(delta);
+    if(value == product){
+      continue;
+    }
+    exact = false;
+    ++(d_statistics.d_nlRefinements);
+
+    Node mNode = d_arithvarNodeMap.asNode(m.d_monomial);
+    Debug("arith::nl") << "nl: " << mNode << " is " << value
+                       << " instead of " << product << endl;
+
+    if(value.sgn() != product.sgn()){
+      // the signs of the factors give the sign of the product
+      vector<Node> premises;
+      Node conclusion = mNode.eqNode(mkRationalNode(0));
+      for(size_t k = 0; k < values.size(); ++k){
+        Node x = d_arithvarNodeMap.asNode(m.d_factors[k]);
+        if(values[k].sgn() == 0){
+          premises.clear();
+          premises.push_back(signAtom(x, values[k]));
+          break;
+        }
+        premises.push_back(signAtom(x, values[k]));
+      }
+      if(product.sgn() != 0){
+        conclusion = signAtom(mNode, product);
+      }
+      if(outputNonlinearLemma(mkImplies(premises, conclusion))){
+        ++(d_statistics.d_nlSignLemmas);
+        sentLemma = true;
+      }
+    }else if(m.d_factors.size() == 2){
+      // (x - a)(y - b) is positive if x - a and y - b have the same sign,
+      // and negative otherwise. This gives the tangent planes of x*y at
+      // (a,b): xy >= bx + ay - ab and xy <= bx + ay - ab, each valid in two
+      // quadrants around (a, b), which exclude the current value.
+      Node x = d_arithvarNodeMap.asNode(m.d_factors[0]);
+      Node y = d_arithvarNodeMap.asNode(m.d_factors[1]);
+      const Rational& a = values[0];
+      const Rational& b = values[1];
+      Node aNode = mkRationalNode(a);
+      Node bNode = mkRationalNode(b);
+      Node plane = nm->mkNode(kind::PLUS,
+                              nm->mkNode(kind::MULT, bNode, x),
+                              nm->mkNode(kind::MULT, aNode, y),
+                              mkRationalNode(-(a * b)));
+      bool below = value < product;
+      Kind cmp = below ? kind::GEQ : kind::LEQ;
+      Node conclusion = nm->mkNode(cmp, mNode, plane);
+      for(int quadrant = 0; quadrant < 2; ++quadrant){
+        // below: x >= a & y >= b, x <= a & y <= b
+        // above: x >= a & y <= b, x <= a & y >= b
+        Kind xCmp = (quadrant == 0) ? kind::GEQ : kind::LEQ;
+        Kind yCmp = (quadrant == 0) == below ? kind::GEQ : kind::LEQ;
+        vector<Node> premises;
+        premises.push_back(nm->mkNode(xCmp, x, aNode));
+        premises.push_back(nm->mkNode(yCmp, y, bNode));
+        if(outputNonlinearLemma(mkImplies(premises, conclusion))){
+          ++(d_statistics.d_nlTangentLemmas);
+          sentLemma = true;
+        }
+      }
+    }else{
+      vector<Node> premises;
+      for(size_t k = 0; k < values.size(); ++k){
+        Node x = d_arithvarNodeMap.asNode(m.d_factors[k]);
+        premises.push_back(x.eqNode(mkRationalNode(values[k])));
+      }
+      if(outputNonlinearLemma(mkImplies(premises, mNode.eqNode(mkRationalNode(product))))){
+        ++(d_statistics.d_nlPointLemmas);
+        sentLemma = true;
+      }
+    }
+  }
+
+  if(!exact && !sentLemma){
+    d_out->setIncomplete();
+  }
+  return sentLemma;
+}
+
+bool TheoryArith::assertToDifferenceGraph(Constraint constraint){
+  if(!options::arithDifferenceLogic() || !d_dlSolver.isDifference(constraint->getVariable())){
+    return false;
+  }
+
+  std::vector<Constraint> cycle;
+  std::vector<DifferenceImplication> implied;
+  if(!d_dlSolver.assertConstraint(constraint, cycle, implied)){
+    NodeBuilder<> nb(kind::AND);
+    for(std::vector<Constraint>::const_iterator i = cycle.begin(); i != cycle.end(); ++i){
+      (*i)->explainForConflict(nb);
+    }
+    Node conflict;
+    if(nb.getNumChildren() == 1){
+      conflict = nb[0];
+    }else{
+      conflict = nb;
+    }
+    Debug("arith::dl") << "difference conflict " << conflict << endl;
+    d_raiseConflict(conflict);
+    return true;
+  }
+
+  for(std::vector<DifferenceImplication>::const_iterator i = implied.begin(); i != implied.end(); ++i){
+    const DifferenceImplication& imp = *i;
+    Constraint best = d_constraintDatabase.getBestImpliedBound(imp.d_var, imp.d_type, imp.d_value);
+    if(best != NullConstraint && !best->assertedToTheTheory() && best->canBePropagated() &&
+       !best->hasProof() && !best->negationHasProof()){
+      Debug("arith::dl") << "difference propagation " << best << endl;
+      best->impliedBy(imp.d_first, imp.d_second);
+      ++(d_statistics.d_differencePropagations);
+    }
+  }
+  return false;
+}
+
+bool TheoryArith::propagatePseudoBoolean(){
+  std::vector<Constraint> conflict;
+  std::vector<PseudoBooleanImplication> implied;
+  bool consistent = d_pbPropagator.propagate(conflict, implied);
+
+  for(std::vector<PseudoBooleanImplication>::const_iterator i = implied.begin();
+      consistent && i != implied.end(); ++i){
+    const PseudoBooleanImplication& imp = *i;
+    Constraint c = d_constraintDatabase.getConstraint(imp.d_var, imp.d_type, imp.d_value);
+    if(c->isTrue()){
+      continue;
+    }else if(c->negationHasProof()){
+      conflict = imp.d_reasons;
+      conflict.push_back(c->getNegation());
+      consistent = false;
+    }else{
+      Debug("arith::pb") << "pb propagation " << c << endl;
+      c->impliedBy(imp.d_reasons);
+      d_learnedBounds.push_back(c);
+      ++(d_statistics.d_pbPropagations);
+    }
+  }
+
+  if(!consistent){
+    NodeBuilder<> nb(kind::AND);
+    for(std::vector<Constraint>::const_iterator i = conflict.begin(); i != conflict.end(); ++i){
+      (*i)->explainForConflict(nb);
+    }
+    Node conf;
+    if(nb.getNumChildren() == 1){
+      conf = nb[0];
+    }else{
+      conf = nb;
+    }
+    Debug("arith::pb") << "pb conflict " << conf << endl;
+    d_raiseConflict(conf);
+    return true;
+  }
+  return false;
+}
+
+bool TheoryArith::installDifferenceModel(){
+  std::vector<DeltaRational> values;
+  values.reserve(getNumberOfVariables());
+  for(ArithVar v = 0; v < getNumberOfVariables(); ++v){
+    if(!d_arithvarNodeMap.hasNode(v) || !d_dlSolver.isDifference(v)){
+      return false;
+    }
+    DeltaRational value = d_dlSolver.getValue(v);
+    if((d_partialModel.hasLowerBound(v) && value < d_partialModel.getLowerBound(v)) ||
+       (d_partialModel.hasUpperBound(v) && value > d_partialModel.getUpperBound(v))){
+      return false;
+    }
+    values.push_back(value);
+  }
+
+  // every row of the tableau is a consequence of the definitions of the
+  // slack variables, so the new assignment satisfies all of them
+  for(ArithVar v = 0; v < getNumberOfVariables(); ++v){
+    if(d_partialModel.getAssignment(v) != values[v]){
+      d_partialModel.setAssignment(v, values[v]);
+    }
+  }
+  ++(d_statistics.d_differenceModels);
+  return true;
+}
+
 /** Returns true if the roundRobinBranching() issues a lemma. */
 Node TheoryArith::roundRobinBranch(){
   if(hasIntegerModel()){
     return Node::null();
   }else{
-    ArithVar v = d_nextIntegerCheckVar;
+    ArithVar v = options::arithBranchTightest() ?
+      selectBranchVariable() : d_nextIntegerCheckVar;
 
     Assert(isInteger(v));
     Assert(!isSlackVariable(v));
@@ -1818,6 +2185,141 @@ Node TheoryArith::roundRobinBranch(){
   }
 }
 
+ArithVar TheoryArith::selectBranchVariable(){
+  ArithVar best = ARITHVAR_SENTINEL;
+  bool bestIsBounded = false;
+  Rational bestWidth;
+
+  for(var_iterator vi = var_begin(), vend = var_end(); vi != vend; ++vi){
+    ArithVar v = *vi;
+    if(!isInteger(v) || isSlackVariable(v) ||
+       d_partialModel.getAssignment(v).isIntegral()){
+      continue;
+    }
+    bool bounded = d_partialModel.hasLowerBound(v) && d_partialModel.hasUpperBound(v);
+    if(!bounded){
+      if(best == ARITHVAR_SENTINEL){ best = v; }
+      continue;
+    }
+    DeltaRational width = d_partialModel.getUpperBound(v) - d_partialModel.getLowerBound(v);
+    if(!bestIsBounded || width.getNoninfinitesimalPart() < bestWidth){
+      best = v;
+      bestIsBounded = true;
+      bestWidth = width.getNoninfinitesimalPart();
+    }
+  }
+  Assert(best != ARITHVAR_SENTINEL);
+  return best;
+}
+
+Node TheoryArith::gomoryCut(ArithVar basic){
+  Assert(d_tableau.isBasic(basic));
+
+  const DeltaRational& beta = d_partialModel.getAssignment(basic);
+  if(!beta.infinitesimalIsZero()){
+    return Node::null();
+  }
+  const Rational& betaValue = beta.getNoninfinitesimalPart();
+  Rational f0 = betaValue - Rational(betaValue.floor());
+  Assert(f0.sgn() > 0);
+  Rational oneMinusF0 = Rational(1) - f0;
+
+  RowIndex ridx = d_tableau.basicToRowIndex(basic);
+  if(d_tableau.getRowLength(ridx) > options::arithCutMaxRowLength()){
+    ++(d_statistics.d_cutRowsSkipped);
+    return Node::null();
+  }
+
+  // basic = beta + sum a_j t_j where t_j >= 0 is the distance of the
+  // nonbasic x_j from the bound it is at.
+  // The cut is sum g_j t_j >= 1.
+  NodeBuilder<> antecedent(kind::AND);
+  Polynomial lhs = Polynomial::mkZero();
+  Rational rhs(1);
+  for(Tableau::RowIterator i = d_tableau.basicRowIterator(basic); !i.atEnd(); ++i){
+    const Tableau::Entry& entry = *i;
+    ArithVar x = entry.getColVar();
+    if(x == basic){ continue; }
+
+    const DeltaRational& value = d_partialModel.getAssignment(x);
+    bool atLower = d_partialModel.equalsLowerBound(x, value);
+    bool atUpper = !atLower && d_partialModel.equalsUpperBound(x, value);
+    if(!(atLower || atUpper) || !value.infinitesimalIsZero()){
+      ++(d_statistics.d_cutRowsSkipped);
+      return Node::null();
+    }
+
+    const Rational& bound = value.getNoninfinitesimalPart();
+    Rational a = atLower ? entry.getCoefficient() : -entry.getCoefficient();
+    Rational g;
+    if(isInteger(x) && !isSlackVariable(x) && bound.isIntegral()){
+      Rational fj = a - Rational(a.floor());
+      g = (fj <= f0) ? fj / f0 : (Rational(1) - fj) / oneMinusF0;
+    }else{
+      g = (a.sgn() > 0) ? a / f0 : (-a) / oneMinusF0;
+    }
+    if(g.isZero()){ continue; }
+
+    Constraint c = atLower ?
+      d_partialModel.getLowerBoundConstraint(x) : d_partialModel.getUpperBoundConstraint(x);
+    c->explainForConflict(antecedent);
+
+    Polynomial px = Polynomial::parsePolynomial(d_arithvarNodeMap.asNode(x));
+    if(atLower){
+      // t_j = x_j - l_j
+      lhs = lhs + px * g;
+      rhs += g * bound;
+    }else{
+      // t_j = u_j - x_j
+      lhs = lhs + px * (-g);
+      rhs = rhs - g * bound;
+    }
+  }
+
+  Comparison cut = Comparison::mkComparison(GEQ, lhs, Polynomial(Constant::mkConstant(rhs)));
+  Node lemma;
+  if(antecedent.getNumChildren() == 0){
+    lemma = cut.getNode();
+  }else if(antecedent.getNumChildren() == 1){
+    lemma = NodeManager::currentNM()->mkNode(kind::IMPLIES, antecedent[0], cut.getNode());
+  }else{
+    Node conjunction = antecedent;
+    lemma = NodeManager::currentNM()->mkNode(kind::IMPLIES, conjunction, cut.getNode());
+  }
+  Debug("arith::cuts") << "gomory cut for " << basic << ": " << lemma << endl;
+
+  if(d_cuts.find(lemma) != d_cuts.end()){
+    ++(d_statistics.d_duplicateCuts);
+    return Node::null();
+  }
+  d_cuts.insert(lemma);
+  return lemma;
+}
+
+bool TheoryArith::gomoryCutting(){
+  TimerStat::CodeTimer codeTimer(d_statistics.d_cutTimer);
+
+  // The cuts are collected first, sending a lemma may add rows to the tableau.
+  std::vector<Node> cuts;
+  Tableau::BasicIterator i = d_tableau.beginBasic(), end = d_tableau.endBasic();
+  for(; i != end && cuts.size() < options::arithCutsPerRound(); ++i){
+    ArithVar basic = *i;
+    if(isInteger(basic) && !isSlackVariable(basic) &&
+       !d_partialModel.getAssignment(basic).isIntegral()){
+      Node cut = gomoryCut(basic);
+      if(!cut.isNull()){
+        cuts.push_back(cut);
+      }
+    }
+  }
+
+  for(std::vector<Node>::const_iterator c = cuts.begin(); c != cuts.end(); ++c){
+    ++(d_statistics.d_gomoryCuts);
+    d_out->lemma(*c);
+  }
+  return !cuts.empty();
+}
+
 bool TheoryArith::splitDisequalities(){
   bool splitSomething = false;
 
@@ -2284,6 +2786,44 @@ bool TheoryArith::unenqueuedVariablesAreConsistent(){
   return result;
 }
 
+void TheoryArith::outputUnateLemmas(ArithVar v){
+  Node n = d_arithvarNodeMap.asNode(v);
+  uint32_t atoms = d_atomsPerVariable.isKey(v) ? d_atomsPerVariable[v] : 0;
+  context::CDHashMap<Node, uint32_t, NodeHashFunction>::const_iterator covered = d_unateAtomsCovered.find(n);
+  if(covered != d_unateAtomsCovered.end() && (*covered).second == atoms){
+    return;
+  }
+  d_unateAtomsCovered[n] = atoms;
+
+  vector<Node> lemmas;
+  switch(options::arithUnateLemmaMode()){
+  case NO_PRESOLVE_LEMMAS:
+    break;
+  case INEQUALITY_PRESOLVE_LEMMAS:
+    d_constraintDatabase.outputUnateInequalityLemmas(lemmas, v);
+    break;
+  case EQUALITY_PRESOLVE_LEMMAS:
+    d_constraintDatabase.outputUnateEqualityLemmas(lemmas, v);
+    break;
+  case ALL_PRESOLVE_LEMMAS:
+    d_constraintDatabase.outputUnateInequalityLemmas(lemmas, v);
+    d_constraintDatabase.outputUnateEqualityLemmas(lemmas, v);
+    break;
+  default:
+    Unhandled(options::arithUnateLemmaMode());
+  }
+
+  ++(d_statistics.d_lazyUnateVariables);
+  for(vector<Node>::const_iterator i = lemmas.begin(), i_end = lemmas.end(); i != i_end; ++i){
+    if(!d_unateLemmasSent.contains(*i)){
+      d_unateLemmasSent.insert(*i);
+      ++(d_statistics.d_lazyUnateLemmas);
+      Debug("arith::unate") << "lazy unate lemma " << *i << endl;
+      d_out->lemma(*i);
+    }
+  }
+}
+
 void TheoryArith::presolve(){
   TimerStat::CodeTimer codeTimer(d_statistics.d_presolveTime);
 
@@ -2298,7 +2838,8 @@ void TheoryArith::presolve(){
   }
 
   vector<Node> lemmas;
-  switch(options::arithUnateLemmaMode()){
+  // with --lazy-unate-lemmas these are sent by outputUnateLemmas()
+  switch(options::arithLazyUnateLemmas() ? NO_PRESOLVE_LEMMAS : options::arithUnateLemmaMode()){
   case NO_PRESOLVE_LEMMAS:
     break;
   case INEQUALITY_PRESOLVE_LEMMAS:
@@ -2352,13 +2893,9 @@ EqualityStatus TheoryArith::getEqualityStatus(TNode a, TNode b) {
   }
 }
 
-bool TheoryArith::propagateCandidateBound(ArithVar basic, bool upperBound){
+bool TheoryArith::propagateCandidateBound(ArithVar basic, bool upperBound, const DeltaRational& bound){
   ++d_statistics.d_boundComputations;
 
-  DeltaRational bound = upperBound ?
-    d_linEq.computeUpperBound(basic):
-    d_linEq.computeLowerBound(basic);
-
   if((upperBound && d_partialModel.strictlyLessThanUpperBound(basic, bound)) ||
      (!upperBound && d_partialModel.strictlyGreaterThanLowerBound(basic, bound))){
 
@@ -2421,13 +2958,13 @@ bool TheoryArith::propagateCandidateBound(ArithVar basic, bool upperBound){
   return false;
 }
 
-void TheoryArith::propagateCandidate(ArithVar basic){
+void TheoryArith::propagateCandidate(const RowBounds& rb){
   bool success = false;
-  if(d_partialModel.strictlyAboveLowerBound(basic) && d_linEq.hasLowerBounds(basic)){
-    success |= propagateCandidateLowerBound(basic);
+  if(rb.d_hasLower){
+    success |= propagateCandidateBound(rb.d_basic, false, rb.d_lower);
   }
-  if(d_partialModel.strictlyBelowUpperBound(basic) && d_linEq.hasUpperBounds(basic)){
-    success |= propagateCandidateUpperBound(basic);
+  if(rb.d_hasUpper){
+    success |= propagateCandidateBound(rb.d_basic, true, rb.d_upper);
   }
   if(success){
     ++d_statistics.d_boundPropagations;
@@ -2464,11 +3001,18 @@ void TheoryArith::propagateCandidates(){
   }
   d_updatedBounds.purge();
 
+  std::vector<RowBounds> rows;
   while(!d_candidateBasics.empty()){
     ArithVar candidate = d_candidateBasics.back();
     d_candidateBasics.pop_back();
     Assert(d_tableau.isBasic(candidate));
-    propagateCandidate(candidate);
+    rows.push_back(RowBounds(candidate));
+  }
+
+  d_linEq.computeRowBounds(rows, options::arithPropagateThreads());
+
+  for(std::vector<RowBounds>::const_iterator i = rows.begin(); i != rows.end(); ++i){
+    propagateCandidate(*i);
   }
 }
 
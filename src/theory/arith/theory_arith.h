@@ -21,9 +21,11 @@
 #include "theory/theory.h"
 #include "context/context.h"
 #include "context/cdlist.h"
+#include "context/cdhashmap.h"
 #include "context/cdhashset.h"
 #include "context/cdinsert_hashmap.h"
 #include "context/cdqueue.h"
+#include "context/cdo.h"
 #include "expr/node.h"
 
 #include "util/dense_map.h"
@@ -38,6 +40,8 @@
 #include "theory/arith/arith_static_learner.h"
 #include "theory/arith/arithvar_node_map.h"
 #include "theory/arith/dio_solver.h"
+#include "theory/arith/difference_logic.h"
+#include "theory/arith/pseudo_boolean.h"
 #include "theory/arith/congruence_manager.h"
 
 #include "theory/arith/constraint.h"
@@ -70,6 +74,37 @@ private:
   // TODO A better would be:
   //context::CDO<bool> d_nlIncomplete;
 
+  /** A product of at least two variables, d_monomial = d_factors[0] * ... */
+  struct NonlinearMonomial {
+    ArithVar d_monomial;
+    std::vector<ArithVar> d_factors;
+  };
+
+  /**
+   * The products of variables that are treated as variables by the linear
+   * solver. With --nl-linearize the assignment is checked against the
+   * products at full effort.
+   */
+  std::vector<NonlinearMonomial> d_nlMonomials;
+
+  /** The refinement lemmas sent in the current user context. */
+  context::CDHashSet<Node, NodeHashFunction> d_nlLemmas;
+
+  /**
+   * Checks the assignment against the products in d_nlMonomials and sends
+   * lemmas excluding it for every product whose value is wrong:
+   *  - a sign lemma if the sign of the product is wrong,
+   *  - otherwise the tangent planes at the assignment for a product of two
+   *    variables,
+   *  - otherwise a lemma fixing the product at the values of the factors.
+   * Returns true if a lemma was sent. If the assignment is wrong but no new
+   * lemma excludes it, the output channel is marked incomplete.
+   */
+  bool nonlinearRefinement();
+
+  /** Sends the lemma unless it was already sent, returns true if it was sent. */
+  bool outputNonlinearLemma(Node lemma);
+
   enum Result::Sat d_qflraStatus;
   // check()
   //   !done() -> d_qflraStatus = Unknown
@@ -188,6 +223,54 @@ private:
   Node callDioSolver();
   Node dioCutting();
 
+  /**
+   * Returns a Gomory mixed-integer cut derived from the tableau row of basic
+   * as a lemma (bounds of the nonbasic variables) => cut, or Node::null()
+   * if the row does not qualify.
+   * The row qualifies if every nonbasic variable on it is at a bound that
+   * has no infinitesimal part and the assignment of basic is fractional.
+   */
+  Node gomoryCut(ArithVar basic);
+
+  /**
+   * Sends Gomory cuts for the fractional integer basic variables on the
+   * output channel. Returns true if any lemma was sent.
+   */
+  bool gomoryCutting();
+
+  /** Number of rounds of cuts since the last branch. */
+  context::CDO<unsigned> d_cutRoundsSinceBranch;
+
+  /** The cuts sent in the current user context. */
+  context::CDHashSet<Node, NodeHashFunction> d_cuts;
+
+  /** The unate lemmas sent in the current user context. */
+  context::CDHashSet<Node, NodeHashFunction> d_unateLemmasSent;
+
+  /** The number of atoms set up on each variable. */
+  DenseMap<uint32_t> d_atomsPerVariable;
+
+  /**
+   * The number of atoms on each variable when its unate lemmas were
+   * last output in the current user context.
+   */
+  context::CDHashMap<Node, uint32_t, NodeHashFunction> d_unateAtomsCovered;
+
+  /**
+   * Sends the unate lemmas selected by --unate-lemmas between the
+   * constraints on v that have not already been sent.
+   * With --lazy-unate-lemmas this is done when v is bounded instead of
+   * for every variable in presolve(); the lemmas are only recomputed
+   * when atoms have been set up on v since the last time.
+   */
+  void outputUnateLemmas(ArithVar v);
+
+  /**
+   * Returns the integer variable with a non-integer assignment whose bounds
+   * are the closest together. Unbounded variables come last.
+   */
+  ArithVar selectBranchVariable();
+
   Comparison mkIntegerEqualityFromAssignment(ArithVar v);
 
   /**
@@ -236,6 +319,40 @@ private:
    */
   DioSolver d_diosolver;
 
+  /**
+   * The constraint graph of the asserted difference constraints
+   * (see --dl-solver).
+   */
+  DifferenceLogicSolver d_dlSolver;
+
+  /**
+   * Adds constraint to d_dlSolver if it is a bound on a difference.
+   * Returns true if this raises a conflict (a negative cycle).
+   * The bounds implied by the new edges are propagated.
+   */
+  bool assertToDifferenceGraph(Constraint constraint);
+
+  /**
+   * If every variable is a difference and the potential of d_dlSolver
+   * satisfies all of the bounds, the assignment is set from the potential
+   * so that the simplex search has nothing left to repair.
+   * Returns true if the assignment was set.
+   */
+  bool installDifferenceModel();
+
+  /**
+   * The rows over 0/1 integer variables with integral coefficients
+   * (see --pb-propagation).
+   */
+  PseudoBooleanPropagator d_pbPropagator;
+
+  /**
+   * Propagates the rows of d_pbPropagator with new bounds.
+   * The implied bounds are added to d_learnedBounds.
+   * Returns true if this raises a conflict.
+   */
+  bool propagatePseudoBoolean();
+
   /** Counts the number of notifyRestart() calls to the theory. */
   uint32_t d_restartsCounter;
 
@@ -485,16 +602,16 @@ private:
 
   void revertOutOfConflict();
 
+  /**
+   * Propagates bounds over the rows of the candidate basic variables.
+   * The bounds of all of the rows are computed first (possibly in parallel,
+   * see --prop-threads), and the implied constraints are then propagated
+   * one row at a time. Propagating a constraint does not change the bounds
+   * in the partial model, so this is the same as doing it row by row.
+   */
   void propagateCandidates();
-  void propagateCandidate(ArithVar basic);
-  bool propagateCandidateBound(ArithVar basic, bool upperBound);
-
-  inline bool propagateCandidateLowerBound(ArithVar basic){
-    return propagateCandidateBound(basic, false);
-  }
-  inline bool propagateCandidateUpperBound(ArithVar basic){
-    return propagateCandidateBound(basic, true);
-  }
+  void propagateCandidate(const RowBounds& rb);
+  bool propagateCandidateBound(ArithVar basic, bool upperBound, const DeltaRational& bound);
 
   /**
    * Performs a check to see if it is definitely true that setup can be avoided.
@@ -554,6 +671,17 @@ private:
 
     IntStat d_externalBranchAndBounds;
 
+    IntStat d_differenceModels, d_differencePropagations;
+
+    IntStat d_gomoryCuts, d_duplicateCuts, d_cutRowsSkipped;
+    TimerStat d_cutTimer;
+
+    IntStat d_lazyUnateVariables, d_lazyUnateLemmas;
+
+    IntStat d_nlRefinements, d_nlSignLemmas, d_nlTangentLemmas, d_nlPointLemmas;
+
+    IntStat d_pbPropagations;
+
     IntStat d_initialTableauSize;
     IntStat d_currSetToSmaller;
     IntStat d_smallerSetToCurr;
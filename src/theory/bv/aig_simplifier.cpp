@@ -0,0 +1,279 @@
+/*********************                                                        */
+/*! \file aig_simplifier.cpp
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief And-inverter graph simplification of bit-blasted circuits.
+ **/
+
+#include "theory/bv/aig_simplifier.h"
+#include "theory/bv/theory_bv_utils.h"
+#include "expr/attribute.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::bv;
+
+/** Marks the nodes that are already in and-inverter graph form */
+struct AigNormalFormAttributeId {};
+typedef expr::Attribute<AigNormalFormAttributeId, bool> AigNormalFormAttribute;
+
+static bool isConnective(TNode node) {
+  switch (node.getKind()) {
+  case kind::NOT:
+  case kind::AND:
+  case kind::OR:
+  case kind::XOR:
+  case kind::IFF:
+  case kind::IMPLIES:
+    return true;
+  case kind::ITE:
+    return node.getType().isBoolean();
+  default:
+    return false;
+  }
+}
+
+/** Returns true if a is the negation of b */
+static bool isNegation(TNode a, TNode b) {
+  return (a.getKind() == kind::NOT && a[0] == b) ||
+         (b.getKind() == kind::NOT && b[0] == a);
+}
+
+AigSimplifier::AigSimplifier()
+  : d_cache(),
+    d_statistics()
+{}
+
+Node AigSimplifier::mkNot(TNode a) {
+  if (a.getKind() == kind::NOT) {
+    return a[0];
+  }
+  if (a.getKind() == kind::CONST_BOOLEAN) {
+    return a.getConst<bool>() ? utils::mkFalse() : utils::mkTrue();
+  }
+  return utils::mkNot(a);
+}
+
+Node AigSimplifier::mkAnd(TNode a, TNode b) {
+  // constants and level one rules
+  if (a.getKind() == kind::CONST_BOOLEAN) {
+    return a.getConst<bool>() ? (Node) b : utils::mkFalse();
+  }
+  if (b.getKind() == kind::CONST_BOOLEAN) {
+    return b.getConst<bool>() ? (Node) a : utils::mkFalse();
+  }
+  if (a == b) {
+    return a;
+  }
+  if (isNegation(a, b)) {
+    return utils::mkFalse();
+  }
+
+  // level two rules, tried for both orders of the arguments
+  for (unsigned i = 0; i < 2; ++i) {
+    TNode x = i == 0 ? a : b;
+    TNode y = i == 0 ? b : a;
+
+    if (x.getKind() == kind::AND) {
+      // contradiction: (x0 & x1) & ~x0 = false
+      if (isNegation(x[0], y) || isNegation(x[1], y)) {
+        ++(d_statistics.d_numSimplifications);
+        return utils::mkFalse();
+      }
+      // idempotence: (x0 & x1) & x0 = x0 & x1
+      if (x[0] == y || x[1] == y) {
+        ++(d_statistics.d_numSimplifications);
+        return x;
+      }
+      if (y.getKind() == kind::AND) {
+        // contradiction: (x0 & x1) & (~x0 & y1) = false
+        for (unsigned j = 0; j < 2; ++j) {
+          if (isNegation(x[j], y[0]) || isNegation(x[j], y[1])) {
+            ++(d_statistics.d_numSimplifications);
+            return utils::mkFalse();
+          }
+        }
+      }
+    }
+
+    if (x.getKind() == kind::NOT && x[0].getKind() == kind::AND) {
+      TNode x0 = x[0][0];
+      TNode x1 = x[0][1];
+      // subsumption: ~(x0 & x1) & ~x0 = ~x0
+      if (isNegation(x0, y) || isNegation(x1, y)) {
+        ++(d_statistics.d_numSimplifications);
+        return y;
+      }
+      // substitution: ~(x0 & x1) & x0 = ~x1 & x0
+      if (x0 == y) {
+        ++(d_statistics.d_numSimplifications);
+        return mkAnd(mkNot(x1), y);
+      }
+      if (x1 == y) {
+        ++(d_statistics.d_numSimplifications);
+        return mkAnd(mkNot(x0), y);
+      }
+    }
+  }
+
+  // structural hashing is done by the node manager, ordering the children
+  // makes a & b and b & a the same node
+  ++(d_statistics.d_numAndNodes);
+  return a < b ? utils::mkAnd(a, b) : utils::mkAnd(b, a);
+}
+
+Node AigSimplifier::mkOr(TNode a, TNode b) {
+  return mkNot(mkAnd(mkNot(a), mkNot(b)));
+}
+
+Node AigSimplifier::mkXor(TNode a, TNode b) {
+  // ~a ^ b = ~(a ^ b), so that the xors of a literal and of its negation
+  // are the same node
+  bool negate = false;
+  if (a.getKind() == kind::NOT) {
+    a = a[0];
+    negate = !negate;
+  }
+  if (b.getKind() == kind::NOT) {
+    b = b[0];
+    negate = !negate;
+  }
+  Node result;
+  if (a.getKind() == kind::CONST_BOOLEAN) {
+    result = a.getConst<bool>() ? mkNot(b) : (Node) b;
+  } else if (b.getKind() == kind::CONST_BOOLEAN) {
+    result = b.getConst<bool>() ? mkNot(a) : (Node) a;
+  } else if (a == b) {
+    result = utils::mkFalse();
+  } else {
+    ++(d_statistics.d_numXorNodes);
+    result = a < b ? utils::mkNode(kind::XOR, a, b) : utils::mkNode(kind::XOR, b, a);
+  }
+  return negate ? mkNot(result) : result;
+}
+
+Node AigSimplifier::mkIte(TNode cond, TNode a, TNode b) {
+  return mkOr(mkAnd(cond, a), mkAnd(mkNot(cond), b));
+}
+
+Node AigSimplifier::convertNode(TNode node) {
+  std::vector<Node> children;
+  for (unsigned i = 0; i < node.getNumChildren(); ++i) {
+    Assert (d_cache.find(node[i]) != d_cache.end());
+    children.push_back(d_cache[node[i]]);
+  }
+
+  switch (node.getKind()) {
+  case kind::NOT:
+    return mkNot(children[0]);
+  case kind::AND: {
+    Node result = children[0];
+    for (unsigned i = 1; i < children.size(); ++i) {
+      result = mkAnd(result, children[i]);
+    }
+    return result;
+  }
+  case kind::OR: {
+    Node result = children[0];
+    for (unsigned i = 1; i < children.size(); ++i) {
+      result = mkOr(result, children[i]);
+    }
+    return result;
+  }
+  case kind::XOR:
+    return mkXor(children[0], children[1]);
+  case kind::IFF:
+    return mkNot(mkXor(children[0], children[1]));
+  case kind::IMPLIES:
+    return mkOr(mkNot(children[0]), children[1]);
+  case kind::ITE:
+    return mkIte(children[0], children[1], children[2]);
+  default:
+    Unreachable();
+  }
+}
+
+Node AigSimplifier::convertCached(TNode node) {
+  NodeMap::const_iterator find = d_cache.find(node);
+  if (find != d_cache.end()) {
+    return find->second;
+  }
+
+  // post-order traversal, the circuits can be too deep for recursion
+  std::vector< std::pair<TNode, bool> > toVisit;
+  toVisit.push_back(std::make_pair(node, false));
+  while (!toVisit.empty()) {
+    TNode current = toVisit.back().first;
+    bool childrenDone = toVisit.back().second;
+
+    if (d_cache.find(current) != d_cache.end()) {
+      toVisit.pop_back();
+      continue;
+    }
+
+    if (!isConnective(current) || current.getAttribute(AigNormalFormAttribute())) {
+      // leaves and converted circuits are kept as they are
+      d_cache[current] = current;
+      toVisit.pop_back();
+      continue;
+    }
+
+    if (childrenDone) {
+      Node result = convertNode(current);
+      d_cache[current] = result;
+      // the result is already in normal form
+      d_cache[result] = result;
+      result.setAttribute(AigNormalFormAttribute(), true);
+      toVisit.pop_back();
+    } else {
+      toVisit.back().second = true;
+      for (unsigned i = 0; i < current.getNumChildren(); ++i) {
+        if (d_cache.find(current[i]) == d_cache.end()) {
+          toVisit.push_back(std::make_pair(current[i], false));
+        }
+      }
+    }
+  }
+
+  return d_cache[node];
+}
+
+Node AigSimplifier::convert(TNode node) {
+  d_cache.clear();
+  Node result = convertCached(node);
+  d_cache.clear();
+  return result;
+}
+
+void AigSimplifier::convert(std::vector<Node>& bits) {
+  // the bits share their carries and the like, so they share the cache
+  d_cache.clear();
+  for (unsigned i = 0; i < bits.size(); ++i) {
+    bits[i] = convertCached(bits[i]);
+  }
+  d_cache.clear();
+}
+
+AigSimplifier::Statistics::Statistics() :
+  d_numAndNodes("theory::bv::AigSimplifier::NumAndNodes", 0),
+  d_numXorNodes("theory::bv::AigSimplifier::NumXorNodes", 0),
+  d_numSimplifications("theory::bv::AigSimplifier::NumSimplifications", 0)
+{
+  StatisticsRegistry::registerStat(&d_numAndNodes);
+  StatisticsRegistry::registerStat(&d_numXorNodes);
+  StatisticsRegistry::registerStat(&d_numSimplifications);
+}
+
+AigSimplifier::Statistics::~Statistics() {
+  StatisticsRegistry::unregisterStat(&d_numAndNodes);
+  StatisticsRegistry::unregisterStat(&d_numXorNodes);
+  StatisticsRegistry::unregisterStat(&d_numSimplifications);
+}
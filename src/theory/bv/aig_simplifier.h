@@ -0,0 +1,88 @@
+/*********************                                                        */
+/*! \file aig_simplifier.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief And-inverter graph simplification of bit-blasted circuits.
+ **
+ ** Converts the Boolean circuits produced by the bit-blasting strategies
+ ** into and-inverter graphs made of binary AND and NOT nodes. The AND nodes
+ ** are structurally hashed (with ordered children) and simplified locally
+ ** with the two-level rules of Brummayer and Biere (contradiction,
+ ** idempotence, subsumption and substitution) as they are built.
+ ** XOR and IFF are kept as binary XOR nodes (with the negations moved out)
+ ** rather than lowered to three ANDs, which would grow the CNF of parity
+ ** circuits such as adders.
+ **
+ ** The converted nodes are marked with an attribute, so that the circuits
+ ** of the subterms, which are already converted, are not traversed again.
+ ** The cache only lives for one call to convert.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__BV__AIG_SIMPLIFIER_H
+#define __CVC4__THEORY__BV__AIG_SIMPLIFIER_H
+
+#include "expr/node.h"
+#include "util/statistics_registry.h"
+#include <vector>
+#include <ext/hash_map>
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+class AigSimplifier {
+
+  typedef __gnu_cxx::hash_map<Node, Node, NodeHashFunction> NodeMap;
+
+  /** Maps circuit nodes to their and-inverter graph, cleared by each convert */
+  NodeMap d_cache;
+
+  Node mkNot(TNode a);
+  Node mkAnd(TNode a, TNode b);
+  Node mkOr(TNode a, TNode b);
+  Node mkXor(TNode a, TNode b);
+  Node mkIte(TNode cond, TNode a, TNode b);
+
+  /** Converts a node whose children have already been converted */
+  Node convertNode(TNode node);
+  /** Converts a node, reusing the conversions cached in this call */
+  Node convertCached(TNode node);
+
+  class Statistics {
+  public:
+    IntStat d_numAndNodes;
+    IntStat d_numXorNodes;
+    IntStat d_numSimplifications;
+    Statistics();
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+
+public:
+  AigSimplifier();
+
+  /**
+   * Returns an equivalent node built only from binary AND, XOR and NOT over
+   * the Boolean constants and the non-Boolean-connective leaves of node.
+   */
+  Node convert(TNode node);
+
+  /** Converts every bit in place */
+  void convert(std::vector<Node>& bits);
+};
+
+}/* CVC4::theory::bv namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__BV__AIG_SIMPLIFIER_H */
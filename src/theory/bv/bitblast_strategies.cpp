@@ -651,7 +651,9 @@ void DefaultUdivBB (TNode node, Bits& q, Bitblaster* bb) {
 
   // cache the remainder in case we need it later
   Node remainder = mkNode(kind::BITVECTOR_UREM_TOTAL, node[0], node[1]);
-  bb->cacheTermDef(remainder, r);
+  if (!bb->hasBBTerm(remainder)) {
+    bb->cacheTermDef(remainder, r);
+  }
 }
 
 void DefaultUremBB (TNode node, Bits& rem, Bitblaster* bb) {
@@ -667,7 +669,9 @@ void DefaultUremBB (TNode node, Bits& rem, Bitblaster* bb) {
 
   // cache the quotient in case we need it later
   Node quotient = mkNode(kind::BITVECTOR_UDIV_TOTAL, node[0], node[1]);
-  bb->cacheTermDef(quotient, q);
+  if (!bb->hasBBTerm(quotient)) {
+    bb->cacheTermDef(quotient, q);
+  }
 }
 
 
@@ -58,6 +58,9 @@ Bitblaster::Bitblaster(context::Context* c, bv::TheoryBV* bv) :
     d_termCache(),
     d_bitblastedAtoms(),
     d_assertedAtoms(c),
+    d_assertedLiterals(c),
+    d_atomDefinitions(),
+    d_eagerAtoms(bv->getUserContext()),
     d_statistics()
   {
     d_satSolver = prop::SatSolverFactory::createMinisat(c);
@@ -89,6 +92,18 @@ void Bitblaster::bbAtom(TNode node) {
     return; 
   }
 
+  if (options::bitvectorEagerBitblast()) {
+    // the lemmas are removed from the main SAT solver when the user context
+    // is popped, so the definition is sent again rather than re-encoded
+    AtomDefMap::const_iterator it = d_atomDefinitions.find(node);
+    if (it != d_atomDefinitions.end()) {
+      ++d_statistics.d_numReusedAtoms;
+      d_bvOutput->lemma(it->second, false);
+      d_eagerAtoms.insert(node);
+      return;
+    }
+  }
+
   // make sure it is marked as an atom
   addAtom(node); 
 
@@ -96,14 +111,22 @@ void Bitblaster::bbAtom(TNode node) {
   ++d_statistics.d_numAtoms;
   // the bitblasted definition of the atom
   Node atom_bb = Rewriter::rewrite(d_atomBBStrategies[node.getKind()](node, this));
+  if (options::bitvectorAig()) {
+    atom_bb = d_aigSimplifier.convert(atom_bb);
+  }
   // asserting that the atom is true iff the definition holds
   Node atom_definition = mkNode(kind::IFF, node, atom_bb);
 
   if (!options::bitvectorEagerBitblast()) {
+    // the definition is permanent in the bit-blasting SAT solver and only
+    // takes effect when the marker literal of the atom is assumed, so it is
+    // kept across user context pops
     d_cnfStream->convertAndAssert(atom_definition, false, false);
     d_bitblastedAtoms.insert(node);
   } else {
     d_bvOutput->lemma(atom_definition, false);
+    d_atomDefinitions[node] = atom_definition;
+    d_eagerAtoms.insert(node);
   }
 }
 
@@ -118,13 +141,133 @@ void Bitblaster::bbTerm(TNode node, Bits& bits) {
   BVDebug("bitvector-bitblast") << "Bitblasting node " << node <<"\n"; 
   ++d_statistics.d_numTerms;
 
-  d_termBBStrategies[node.getKind()] (node, bits,this);
+  if (isAbstracted(node)) {
+    bbAbstractTerm(node, bits);
+  } else {
+    d_termBBStrategies[node.getKind()] (node, bits,this);
+  }
+
+  if (options::bitvectorAig()) {
+    d_aigSimplifier.convert(bits);
+  }
   
   Assert (bits.size() == utils::getSize(node));
 
   cacheTermDef(node, bits); 
 }
 
+bool Bitblaster::isAbstracted(TNode node) const {
+  if (!options::bitvectorAbstractMult() ||
+      options::bitvectorEagerBitblast() ||
+      utils::getSize(node) < options::bitvectorAbstractMultWidth()) {
+    return false;
+  }
+
+  switch (node.getKind()) {
+  case kind::BITVECTOR_MULT:
+    // multiplication by a constant is just a sequence of adders
+    for (unsigned i = 0; i < node.getNumChildren(); ++i) {
+      if (node[i].getKind() == kind::CONST_BITVECTOR) {
+        return false;
+      }
+    }
+    return true;
+  case kind::BITVECTOR_UDIV_TOTAL:
+  case kind::BITVECTOR_UREM_TOTAL:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void Bitblaster::bbAbstractTerm(TNode node, Bits& bits) {
+  BVDebug("bitvector-bb") << "Bitblaster::bbAbstractTerm abstracting " << node << "\n";
+  Assert (bits.size() == 0);
+
+  // the operands are bit-blasted so that the abstraction can be checked
+  // against their values in the model
+  for (unsigned i = 0; i < node.getNumChildren(); ++i) {
+    Bits child_bits;
+    bbTerm(node[i], child_bits);
+  }
+
+  for (unsigned i = 0; i < utils::getSize(node); ++i) {
+    bits.push_back(utils::mkBitOf(node, i));
+  }
+
+  d_abstractedTerms.push_back(node);
+  ++d_statistics.d_numAbstractedTerms;
+}
+
+bool Bitblaster::refineAbstraction() {
+  bool refined = false;
+
+  for (unsigned i = 0; i < d_abstractedTerms.size(); ++i) {
+    TNode term = d_abstractedTerms[i];
+    if (d_refinedTerms.find(term) != d_refinedTerms.end()) {
+      continue;
+    }
+
+    Bits abstract_bits;
+    getBBTerm(term, abstract_bits);
+
+    std::vector<BitVector> operands;
+    for (unsigned j = 0; j < term.getNumChildren(); ++j) {
+      Bits child_bits;
+      getBBTerm(term[j], child_bits);
+      operands.push_back(getBitsValue(child_bits));
+    }
+
+    // division by zero is always refined as the circuit is what defines it
+    bool spurious = false;
+    switch (term.getKind()) {
+    case kind::BITVECTOR_MULT: {
+      BitVector product = operands[0];
+      for (unsigned j = 1; j < operands.size(); ++j) {
+        product = product * operands[j];
+      }
+      spurious = !(product == getBitsValue(abstract_bits));
+      break;
+    }
+    case kind::BITVECTOR_UDIV_TOTAL:
+      spurious = operands[1].getValue() == 0 ||
+        !(operands[0].unsignedDiv(operands[1]) == getBitsValue(abstract_bits));
+      break;
+    case kind::BITVECTOR_UREM_TOTAL:
+      spurious = operands[1].getValue() == 0 ||
+        !(operands[0].unsignedRem(operands[1]) == getBitsValue(abstract_bits));
+      break;
+    default:
+      Unreachable();
+    }
+
+    if (!spurious) {
+      continue;
+    }
+
+    BVDebug("bitvector-bb") << "Bitblaster::refineAbstraction refining " << term << "\n";
+    Bits concrete_bits;
+    d_termBBStrategies[term.getKind()](term, concrete_bits, this);
+    Assert (concrete_bits.size() == abstract_bits.size());
+
+    std::vector<Node> definition;
+    for (unsigned j = 0; j < abstract_bits.size(); ++j) {
+      definition.push_back(mkNode(kind::IFF, abstract_bits[j], concrete_bits[j]));
+    }
+    Node refinement = Rewriter::rewrite(mkAnd(definition));
+    if (options::bitvectorAig()) {
+      refinement = d_aigSimplifier.convert(refinement);
+    }
+    d_cnfStream->convertAndAssert(refinement, false, false);
+
+    d_refinedTerms.insert(term);
+    ++d_statistics.d_numRefinedTerms;
+    refined = true;
+  }
+
+  return refined;
+}
+
 Node Bitblaster::bbOptimize(TNode node) {
   std::vector<Node> children;
 
@@ -201,6 +344,9 @@ bool Bitblaster::assertToSat(TNode lit, bool propagate) {
   SatValue ret = d_satSolver->assertAssumption(markerLit, propagate);
 
   d_assertedAtoms.push_back(markerLit);
+  if (options::bitvectorCacheCores()) {
+    d_assertedLiterals.insert(markerLit);
+  }
 
   Assert(ret != prop::SAT_VALUE_UNKNOWN);
   return ret == prop::SAT_VALUE_TRUE;
@@ -222,12 +368,106 @@ bool Bitblaster::solve(bool quick_solve) {
     }
   }
   BVDebug("bitvector") << "Bitblaster::solve() asserted atoms " << d_assertedAtoms.size() <<"\n"; 
-  return SAT_VALUE_TRUE == d_satSolver->solve(); 
+  d_solveConflict.clear();
+
+  if (options::bitvectorCacheCores() && findCachedCore(d_solveConflict)) {
+    ++d_statistics.d_numCachedConflicts;
+    return false;
+  }
+
+  if (SAT_VALUE_TRUE == d_satSolver->solve()) {
+    return true;
+  }
+
+  d_satSolver->getUnsatCore(d_solveConflict);
+  if (options::bitvectorMinimizeCores()) {
+    minimizeCore(d_solveConflict);
+  }
+  if (options::bitvectorCacheCores() && !d_solveConflict.empty()) {
+    cacheCore(d_solveConflict);
+  }
+  return false;
+}
+
+void Bitblaster::minimizeCore(SatClause& core) {
+  TimerStat::CodeTimer codeTimer(d_statistics.d_coreMinimizationTimer);
+  unsigned budget = options::bitvectorMinimizeCoresBudget();
+
+  unsigned i = 0;
+  while (i < core.size() && core.size() > 1) {
+    SatClause assumptions;
+    for (unsigned j = 0; j < core.size(); ++j) {
+      if (j != i) {
+        assumptions.push_back(~core[j]);
+      }
+    }
+
+    SatClause subcore;
+    if (d_satSolver->solveAssumptions(assumptions, budget) == SAT_VALUE_FALSE) {
+      d_satSolver->getUnsatCore(subcore);
+    }
+    if (subcore.empty()) {
+      // the literal is needed (or we ran out of budget)
+      ++i;
+      continue;
+    }
+
+    // the core of the smaller problem may drop more literals than core[i]
+    __gnu_cxx::hash_set<SatLiteral, SatLiteralHashFunction> inSubcore(subcore.begin(), subcore.end());
+    SatClause reduced;
+    for (unsigned j = 0; j < core.size(); ++j) {
+      if (j != i && inSubcore.count(core[j])) {
+        reduced.push_back(core[j]);
+      }
+    }
+    d_statistics.d_numRemovedCoreLiterals += core.size() - reduced.size();
+    core.swap(reduced);
+  }
+}
+
+bool Bitblaster::findCachedCore(SatClause& core) {
+  if (d_cores.empty()) {
+    return false;
+  }
+  context::CDList<prop::SatLiteral>::const_iterator it = d_assertedAtoms.begin();
+  for (; it != d_assertedAtoms.end(); ++it) {
+    CoreWatchMap::const_iterator watches = d_coreWatches.find(*it);
+    if (watches == d_coreWatches.end()) {
+      continue;
+    }
+    const std::vector<unsigned>& cores = watches->second;
+    for (unsigned i = 0; i < cores.size(); ++i) {
+      const SatClause& candidate = d_cores[cores[i]];
+      bool contained = true;
+      for (unsigned j = 1; contained && j < candidate.size(); ++j) {
+        contained = d_assertedLiterals.contains(~candidate[j]);
+      }
+      if (contained) {
+        core = candidate;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void Bitblaster::cacheCore(const SatClause& core) {
+  Assert (!core.empty());
+  if (d_cores.size() >= options::bitvectorCacheCoresLimit()) {
+    d_cores.clear();
+    d_coreWatches.clear();
+  }
+  d_coreWatches[~core[0]].push_back(d_cores.size());
+  d_cores.push_back(core);
 }
 
 void Bitblaster::getConflict(std::vector<TNode>& conflict) {
   SatClause conflictClause;
-  d_satSolver->getUnsatCore(conflictClause);
+  if (!d_solveConflict.empty()) {
+    conflictClause.swap(d_solveConflict);
+  } else {
+    d_satSolver->getUnsatCore(conflictClause);
+  }
   
   for (unsigned i = 0; i < conflictClause.size(); i++) {
     SatLiteral lit = conflictClause[i]; 
@@ -307,7 +547,8 @@ void Bitblaster::initTermBBStrategies() {
 }
  
 bool Bitblaster::hasBBAtom(TNode atom) const {
-  return d_bitblastedAtoms.find(atom) != d_bitblastedAtoms.end();
+  return d_bitblastedAtoms.find(atom) != d_bitblastedAtoms.end() ||
+         d_eagerAtoms.find(atom) != d_eagerAtoms.end();
 }
 
 void Bitblaster::cacheTermDef(TNode term, Bits def) {
@@ -330,12 +571,24 @@ Bitblaster::Statistics::Statistics() :
   d_numAtomClauses("theory::bv::NumberOfAtomSatClauses", 0),
   d_numTerms("theory::bv::NumberOfBitblastedTerms", 0),
   d_numAtoms("theory::bv::NumberOfBitblastedAtoms", 0), 
+  d_numReusedAtoms("theory::bv::NumberOfReusedAtoms", 0),
+  d_numAbstractedTerms("theory::bv::NumberOfAbstractedTerms", 0),
+  d_numRefinedTerms("theory::bv::NumberOfRefinedTerms", 0),
+  d_numCachedConflicts("theory::bv::NumberOfCachedConflicts", 0),
+  d_numRemovedCoreLiterals("theory::bv::NumberOfRemovedCoreLiterals", 0),
+  d_coreMinimizationTimer("theory::bv::CoreMinimizationTimer"),
   d_bitblastTimer("theory::bv::BitblastTimer")
 {
   StatisticsRegistry::registerStat(&d_numTermClauses);
   StatisticsRegistry::registerStat(&d_numAtomClauses);
   StatisticsRegistry::registerStat(&d_numTerms);
   StatisticsRegistry::registerStat(&d_numAtoms);
+  StatisticsRegistry::registerStat(&d_numReusedAtoms);
+  StatisticsRegistry::registerStat(&d_numAbstractedTerms);
+  StatisticsRegistry::registerStat(&d_numRefinedTerms);
+  StatisticsRegistry::registerStat(&d_numCachedConflicts);
+  StatisticsRegistry::registerStat(&d_numRemovedCoreLiterals);
+  StatisticsRegistry::registerStat(&d_coreMinimizationTimer);
   StatisticsRegistry::registerStat(&d_bitblastTimer);
 }
 
@@ -345,6 +598,12 @@ Bitblaster::Statistics::~Statistics() {
   StatisticsRegistry::unregisterStat(&d_numAtomClauses);
   StatisticsRegistry::unregisterStat(&d_numTerms);
   StatisticsRegistry::unregisterStat(&d_numAtoms);
+  StatisticsRegistry::unregisterStat(&d_numReusedAtoms);
+  StatisticsRegistry::unregisterStat(&d_numAbstractedTerms);
+  StatisticsRegistry::unregisterStat(&d_numRefinedTerms);
+  StatisticsRegistry::unregisterStat(&d_numCachedConflicts);
+  StatisticsRegistry::unregisterStat(&d_numRemovedCoreLiterals);
+  StatisticsRegistry::unregisterStat(&d_coreMinimizationTimer);
   StatisticsRegistry::unregisterStat(&d_bitblastTimer);
 }
 
@@ -412,24 +671,26 @@ bool Bitblaster::isSharedTerm(TNode node) {
   return d_bv->d_sharedTermsSet.find(node) != d_bv->d_sharedTermsSet.end(); 
 }
 
-Node Bitblaster::getVarValue(TNode a) {
-  Assert (d_termCache.find(a) != d_termCache.end()); 
-  Bits bits = d_termCache[a];
+BitVector Bitblaster::getBitsValue(const Bits& bits) {
   Integer value(0); 
   for (int i = bits.size() -1; i >= 0; --i) {
-    SatValue bit_value;
-    if (d_cnfStream->hasLiteral(bits[i])) { 
+    bool bit_value = false;
+    if (bits[i].getKind() == kind::CONST_BOOLEAN) {
+      bit_value = bits[i].getConst<bool>();
+    } else if (d_cnfStream->hasLiteral(bits[i])) {
       SatLiteral bit = d_cnfStream->getLiteral(bits[i]);
-      bit_value = d_satSolver->value(bit);
-      Assert (bit_value != SAT_VALUE_UNKNOWN);
-    } else {
-      // the bit is unconstrainted so we can give it an arbitrary value 
-      bit_value = SAT_VALUE_FALSE;
+      Assert (d_satSolver->value(bit) != SAT_VALUE_UNKNOWN);
+      bit_value = d_satSolver->value(bit) == SAT_VALUE_TRUE;
     }
-    Integer bit_int = bit_value == SAT_VALUE_TRUE ? Integer(1) : Integer(0); 
-    value = value * 2 + bit_int;  
+    // otherwise the bit is unconstrained so we can give it an arbitrary value
+    value = value * 2 + (bit_value ? Integer(1) : Integer(0));
   }
-  return utils::mkConst(BitVector(bits.size(), value));  
+  return BitVector(bits.size(), value);
+}
+
+Node Bitblaster::getVarValue(TNode a) {
+  Assert (d_termCache.find(a) != d_termCache.end()); 
+  return utils::mkConst(getBitsValue(d_termCache[a]));  
 }
 
 void Bitblaster::collectModelInfo(TheoryModel* m) {
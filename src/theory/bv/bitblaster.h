@@ -35,6 +35,7 @@
 #include "theory_bv_utils.h"
 #include "util/statistics_registry.h"
 #include "bitblast_strategies.h"
+#include "aig_simplifier.h"
 
 #include "prop/sat_solver.h"
 
@@ -84,6 +85,8 @@ class Bitblaster {
   typedef __gnu_cxx::hash_map <Node, Bits, TNodeHashFunction >              TermDefMap;
   typedef __gnu_cxx::hash_set<TNode, TNodeHashFunction>                      AtomSet;
   typedef __gnu_cxx::hash_set<TNode, TNodeHashFunction>                      VarSet; 
+  typedef __gnu_cxx::hash_set<Node, NodeHashFunction>                        TermSet; 
+  typedef __gnu_cxx::hash_map<Node, Node, NodeHashFunction>                  AtomDefMap;
   
   typedef void   (*TermBBStrategy) (TNode, Bits&, Bitblaster*); 
   typedef Node   (*AtomBBStrategy) (TNode, Bitblaster*); 
@@ -101,12 +104,31 @@ class Bitblaster {
   VarSet                       d_variables; 
   context::CDList<prop::SatLiteral>  d_assertedAtoms; /**< context dependent list storing the atoms
                                                        currently asserted by the DPLL SAT solver. */
+  context::CDHashSet<prop::SatLiteral, prop::SatLiteralHashFunction> d_assertedLiterals; /**< the literals
+                                                       of d_assertedAtoms, used with --bv-cache-cores */
+  // eager bit-blasting: the definitions are lemmas of the main SAT solver
+  AtomDefMap                   d_atomDefinitions; /**< definitions of the atoms bit-blasted so far */
+  context::CDHashSet<Node, NodeHashFunction> d_eagerAtoms; /**< user context dependent set of the atoms
+                                                       whose definition is currently a lemma */
+
+  // abstraction refinement of multipliers and dividers
+  std::vector<Node>            d_abstractedTerms; /**< terms bit-blasted as fresh bits */
+  TermSet                      d_refinedTerms;    /**< abstracted terms whose circuit was added */
+
+  AigSimplifier                d_aigSimplifier;   /**< used with --bitblast-aig */
+
+  // unsat cores, as clauses over the negations of the marker literals
+  typedef __gnu_cxx::hash_map<prop::SatLiteral, std::vector<unsigned>, prop::SatLiteralHashFunction> CoreWatchMap;
+  std::vector<prop::SatClause> d_cores;           /**< cores found so far (--bv-cache-cores) */
+  CoreWatchMap                 d_coreWatches;     /**< the cores indexed by the negation of their first
+                                                       literal, a core is only checked when it is asserted */
+  prop::SatClause              d_solveConflict;   /**< the conflict found by the last call to solve */
 
   /// helper methods
   public:
   bool          hasBBAtom(TNode node) const;
-  private:
   bool          hasBBTerm(TNode node) const;
+  private:
   void          getBBTerm(TNode node, Bits& bits) const;
 
   /// function tables for the various bitblasting strategies indexed by node kind
@@ -125,6 +147,34 @@ class Bitblaster {
   // so it needs to use private bitblaster interface
   void bbUdiv(TNode node, Bits& bits);
   void bbUrem(TNode node, Bits& bits); 
+
+  /** 
+   * Returns true if the term should be bit-blasted as fresh bits rather
+   * than as a circuit (see --bv-abstract-mult). 
+   */
+  bool isAbstracted(TNode node) const;
+  void bbAbstractTerm(TNode node, Bits& bits);
+  /** 
+   * Returns the value of the given bits in the current SAT model;
+   * unassigned bits are taken to be false. 
+   */
+  BitVector getBitsValue(const Bits& bits);
+
+  /** 
+   * Removes the literals of the core that are not needed for the
+   * unsatisfiability, trying to solve without each of them within the
+   * conflict budget given by --bv-minimize-cores-budget. 
+   */
+  void minimizeCore(prop::SatClause& core);
+  /** 
+   * Looks for a cached core whose literals are all currently asserted. 
+   */
+  bool findCachedCore(prop::SatClause& core);
+  /** 
+   * Caches the core, emptying the cache first if it holds
+   * --bv-cache-cores-limit cores. 
+   */
+  void cacheCore(const prop::SatClause& core);
 public:
   void cacheTermDef(TNode node, Bits def); // public so we can cache remainder for division
   void bbTerm(TNode node, Bits&  bits);
@@ -135,6 +185,15 @@ public:
   bool assertToSat(TNode node, bool propagate = true);
   bool propagate();
   bool solve(bool quick_solve = false);
+  /** 
+   * Checks the abstracted multipliers and dividers against the current
+   * SAT model and adds the bit-blasted circuit of every term whose
+   * abstract value does not match the value computed from its operands.
+   * 
+   * @return true if the abstraction was refined and the problem needs to
+   * be solved again
+   */
+  bool refineAbstraction();
   void getConflict(std::vector<TNode>& conflict); 
   void explain(TNode atom, std::vector<TNode>& explanation);
 
@@ -171,6 +230,10 @@ private:
   public:
     IntStat d_numTermClauses, d_numAtomClauses;
     IntStat d_numTerms, d_numAtoms; 
+    IntStat d_numReusedAtoms; 
+    IntStat d_numAbstractedTerms, d_numRefinedTerms; 
+    IntStat d_numCachedConflicts, d_numRemovedCoreLiterals; 
+    TimerStat d_coreMinimizationTimer;
     TimerStat d_bitblastTimer;
     Statistics();
     ~Statistics(); 
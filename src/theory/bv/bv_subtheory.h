@@ -33,7 +33,8 @@ namespace bv {
 
 enum SubTheory {
   SUB_EQUALITY = 1,
-  SUB_BITBLAST = 2
+  SUB_BITBLAST = 2,
+  SUB_PROPAGATION = 3
 };
 
 inline std::ostream& operator << (std::ostream& out, SubTheory subtheory) {
@@ -44,6 +45,9 @@ inline std::ostream& operator << (std::ostream& out, SubTheory subtheory) {
   case SUB_EQUALITY:
     out << "EQUALITY";
     break;
+  case SUB_PROPAGATION:
+    out << "PROPAGATION";
+    break;
   default:
     Unreachable();
     break;
@@ -108,6 +108,12 @@ bool BitblastSolver::addAssertions(const std::vector<TNode>& assertions, Theory:
     Assert(!d_bv->inConflict());
     BVDebug("bitvector::bitblaster") << "BitblastSolver::addAssertions solving. \n";
     bool ok = d_bitblaster->solve();
+    // abstracted multipliers and dividers are refined until the model is
+    // consistent with their actual semantics
+    while (ok && options::bitvectorAbstractMult() && d_bitblaster->refineAbstraction()) {
+      BVDebug("bitvector::bitblaster") << "BitblastSolver::addAssertions re-solving refined abstraction. \n";
+      ok = d_bitblaster->solve();
+    }
     if (!ok) {
       std::vector<TNode> conflictAtoms;
       d_bitblaster->getConflict(conflictAtoms);
@@ -17,6 +17,7 @@
 #include "theory/bv/bv_subtheory_eq.h"
 #include "theory/bv/theory_bv.h"
 #include "theory/bv/theory_bv_utils.h"
+#include "theory/bv/options.h"
 #include "theory/model.h"
 
 using namespace std;
@@ -64,6 +65,12 @@ EqualitySolver::EqualitySolver(context::Context* c, TheoryBV* bv)
     //    d_equalityEngine.addFunctionKind(kind::BITVECTOR_SLE);
     //    d_equalityEngine.addFunctionKind(kind::BITVECTOR_SGT);
     //    d_equalityEngine.addFunctionKind(kind::BITVECTOR_SGE);
+
+    if (options::bitvectorAbstractMult()) {
+      // abstracted dividers are only related through congruence until refined
+      d_equalityEngine.addFunctionKind(kind::BITVECTOR_UDIV_TOTAL);
+      d_equalityEngine.addFunctionKind(kind::BITVECTOR_UREM_TOTAL);
+    }
   }
 }
 
@@ -0,0 +1,619 @@
+/*********************                                                        */
+/*! \file bv_subtheory_propagation.cpp
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Word-level propagation solver.
+ **/
+
+#include "theory/bv/bv_subtheory_propagation.h"
+#include "theory/bv/theory_bv.h"
+#include "theory/bv/theory_bv_utils.h"
+
+#include <set>
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::context;
+using namespace CVC4::theory;
+using namespace CVC4::theory::bv;
+using namespace CVC4::theory::bv::utils;
+
+/** Maximal number of domain updates done in a single call to addAssertions */
+static const unsigned s_maxDomainUpdates = 10000;
+
+static BitVector allOnes(unsigned size) {
+  return ~BitVector(size);
+}
+
+static BitVector mkBit(unsigned size, unsigned i) {
+  return BitVector(size, Integer(1).multiplyByPow2(i));
+}
+
+static bool isBitSet(const BitVector& bv, unsigned i) {
+  return bv.extract(i, i).getValue() == Integer(1);
+}
+
+static void addReasons(std::vector<TNode>& reasons, const std::vector<TNode>& other) {
+  std::set<TNode> seen(reasons.begin(), reasons.end());
+  for (unsigned i = 0; i < other.size(); ++i) {
+    if (seen.insert(other[i]).second) {
+      reasons.push_back(other[i]);
+    }
+  }
+}
+
+/** Number of consecutive known-zero bits starting from the least significant one */
+static unsigned trailingZeros(const BitVector& mask, const BitVector& bits) {
+  unsigned i = 0;
+  while (i < mask.getSize() && isBitSet(mask, i) && !isBitSet(bits, i)) {
+    ++i;
+  }
+  return i;
+}
+
+PropagationSolver::Domain::Domain(unsigned size)
+  : lower(size),
+    upper(allOnes(size)),
+    mask(size),
+    bits(size),
+    reasons()
+{}
+
+bool PropagationSolver::Domain::isEmpty() const {
+  return lower > upper;
+}
+
+/**
+ * Makes the interval and the known bits of the domain agree with each
+ * other. Returns false if the domain is empty.
+ */
+static bool normalize(BitVector& lower, BitVector& upper, BitVector& mask, BitVector& bits) {
+  unsigned size = lower.getSize();
+
+  // bounds implied by the known bits
+  BitVector min = bits & mask;
+  BitVector max = bits | ~mask;
+  if (lower < min) {
+    lower = min;
+  }
+  if (max < upper) {
+    upper = max;
+  }
+  if (lower > upper) {
+    return false;
+  }
+
+  // the common prefix of the bounds is fixed
+  for (int i = size - 1; i >= 0; --i) {
+    bool lowerBit = isBitSet(lower, i);
+    if (lowerBit != isBitSet(upper, i)) {
+      break;
+    }
+    if (isBitSet(mask, i)) {
+      if (isBitSet(bits, i) != lowerBit) {
+        return false;
+      }
+    } else {
+      mask = mask | mkBit(size, i);
+      if (lowerBit) {
+        bits = bits | mkBit(size, i);
+      }
+    }
+  }
+  return true;
+}
+
+PropagationSolver::PropagationSolver(context::Context* c, TheoryBV* bv)
+  : SubtheorySolver(c, bv),
+    d_domains(c),
+    d_assertedAtoms(c),
+    d_explanations(c),
+    d_seeded(c),
+    d_parents(),
+    d_registered(),
+    d_toVisit(),
+    d_budget(0),
+    d_statistics()
+{}
+
+void PropagationSolver::preRegister(TNode node) {
+  if (node.getKind() == kind::EQUAL ||
+      node.getKind() == kind::BITVECTOR_ULT ||
+      node.getKind() == kind::BITVECTOR_ULE) {
+    if (!node[0].getType().isBitVector()) {
+      return;
+    }
+    registerTerm(node);
+  }
+}
+
+void PropagationSolver::registerTerm(TNode node) {
+  if (d_registered.find(node) != d_registered.end()) {
+    return;
+  }
+  d_registered.insert(node);
+
+  for (unsigned i = 0; i < node.getNumChildren(); ++i) {
+    if (node[i].getType().isBitVector()) {
+      registerTerm(node[i]);
+      d_parents[node[i]].push_back(node);
+    }
+  }
+}
+
+PropagationSolver::Domain PropagationSolver::getDomain(TNode term) {
+  DomainMap::const_iterator it = d_domains.find(term);
+  if (it != d_domains.end()) {
+    return (*it).second;
+  }
+  Domain domain(utils::getSize(term));
+  if (term.getKind() == kind::CONST_BITVECTOR) {
+    BitVector value = term.getConst<BitVector>();
+    domain.lower = domain.upper = domain.bits = value;
+    domain.mask = allOnes(value.getSize());
+  }
+  return domain;
+}
+
+PropagationSolver::Domain PropagationSolver::computeDomain(TNode term) {
+  unsigned size = utils::getSize(term);
+  Domain result(size);
+  Integer bound = Integer(1).multiplyByPow2(size);
+
+  switch (term.getKind()) {
+  case kind::BITVECTOR_CONCAT: {
+    Domain current = getDomain(term[0]);
+    for (unsigned i = 1; i < term.getNumChildren(); ++i) {
+      Domain child = getDomain(term[i]);
+      current.lower = current.lower.concat(child.lower);
+      current.upper = current.upper.concat(child.upper);
+      current.mask = current.mask.concat(child.mask);
+      current.bits = current.bits.concat(child.bits);
+      addReasons(current.reasons, child.reasons);
+    }
+    result = current;
+    break;
+  }
+  case kind::BITVECTOR_EXTRACT: {
+    Domain child = getDomain(term[0]);
+    unsigned high = utils::getExtractHigh(term);
+    unsigned low = utils::getExtractLow(term);
+    result.mask = child.mask.extract(high, low);
+    result.bits = child.bits.extract(high, low);
+    // if the bits above the extract are zero the extract is a shift
+    if (child.upper.getValue() < Integer(1).multiplyByPow2(high + 1)) {
+      result.lower = child.lower.extract(high, low);
+      result.upper = child.upper.extract(high, low);
+    }
+    result.reasons = child.reasons;
+    break;
+  }
+  case kind::BITVECTOR_PLUS: {
+    Integer lower(0), upper(0);
+    BitVector mask = allOnes(size);
+    BitVector bits(size);
+    for (unsigned i = 0; i < term.getNumChildren(); ++i) {
+      Domain child = getDomain(term[i]);
+      lower += child.lower.getValue();
+      upper += child.upper.getValue();
+      // the low bits are known as long as the summands are
+      BitVector sum = bits + child.bits;
+      unsigned known = 0;
+      while (known < size && isBitSet(mask, known) && isBitSet(child.mask, known)) {
+        ++known;
+      }
+      mask = known == 0 ? BitVector(size) : allOnes(known).zeroExtend(size - known);
+      bits = sum & mask;
+      addReasons(result.reasons, child.reasons);
+    }
+    if (upper < bound) {
+      result.lower = BitVector(size, lower);
+      result.upper = BitVector(size, upper);
+    }
+    result.mask = mask;
+    result.bits = bits;
+    break;
+  }
+  case kind::BITVECTOR_MULT: {
+    Integer lower(1), upper(1);
+    unsigned zeros = 0;
+    for (unsigned i = 0; i < term.getNumChildren(); ++i) {
+      Domain child = getDomain(term[i]);
+      lower *= child.lower.getValue();
+      upper *= child.upper.getValue();
+      zeros += trailingZeros(child.mask, child.bits);
+      addReasons(result.reasons, child.reasons);
+    }
+    if (upper < bound) {
+      result.lower = BitVector(size, lower);
+      result.upper = BitVector(size, upper);
+    }
+    zeros = zeros < size ? zeros : size;
+    if (zeros > 0) {
+      result.mask = allOnes(zeros).zeroExtend(size - zeros);
+    }
+    break;
+  }
+  case kind::BITVECTOR_SHL: {
+    Domain shift = getDomain(term[1]);
+    if (!shift.isConstant()) {
+      break;
+    }
+    Domain child = getDomain(term[0]);
+    if (shift.lower.getValue() >= Integer(size)) {
+      result.lower = result.upper = result.bits = BitVector(size);
+      result.mask = allOnes(size);
+    } else {
+      unsigned amount = shift.lower.getValue().toUnsignedInt();
+      result.mask = child.mask.leftShift(shift.lower) | (amount == 0 ? BitVector(size) : allOnes(amount).zeroExtend(size - amount));
+      result.bits = child.bits.leftShift(shift.lower);
+      if (child.upper.getValue().multiplyByPow2(amount) < bound) {
+        result.lower = child.lower.leftShift(shift.lower);
+        result.upper = child.upper.leftShift(shift.lower);
+      }
+    }
+    result.reasons = child.reasons;
+    addReasons(result.reasons, shift.reasons);
+    break;
+  }
+  default:
+    // no information from the children
+    break;
+  }
+
+  if (!normalize(result.lower, result.upper, result.mask, result.bits)) {
+    // can only happen if the children are already in conflict
+    result = Domain(size);
+  }
+  return result;
+}
+
+bool PropagationSolver::restrictDomain(TNode term, const Domain& domain) {
+  Domain current = getDomain(term);
+  Domain result = current;
+
+  if (result.lower < domain.lower) {
+    result.lower = domain.lower;
+  }
+  if (domain.upper < result.upper) {
+    result.upper = domain.upper;
+  }
+  BitVector common = result.mask & domain.mask;
+  bool ok = ((result.bits ^ domain.bits) & common) == BitVector(common.getSize());
+  if (ok) {
+    result.mask = result.mask | domain.mask;
+    result.bits = result.bits | domain.bits;
+    ok = normalize(result.lower, result.upper, result.mask, result.bits);
+  }
+
+  if (!ok) {
+    std::vector<TNode> conflict = current.reasons;
+    addReasons(conflict, domain.reasons);
+    BVDebug("bitvector::propagation") << "PropagationSolver::restrictDomain conflict on " << term << "\n";
+    ++(d_statistics.d_numConflicts);
+    d_bv->setConflict(mkConjunction(conflict));
+    return false;
+  }
+
+  if (result.lower == current.lower && result.upper == current.upper &&
+      result.mask == current.mask) {
+    // nothing new
+    return true;
+  }
+
+  BVDebug("bitvector::propagation") << "PropagationSolver::restrictDomain " << term
+                                    << " in [" << result.lower.getValue() << ", "
+                                    << result.upper.getValue() << "]\n";
+  addReasons(result.reasons, domain.reasons);
+  d_domains.insert(term, result);
+  d_toVisit.push_back(term);
+  ++(d_statistics.d_numDomainUpdates);
+  if (d_budget > 0) {
+    --d_budget;
+  }
+  return true;
+}
+
+bool PropagationSolver::seedDomain(TNode term) {
+  if (d_seeded.contains(term)) {
+    return true;
+  }
+  d_seeded.insert(term);
+  if (term.getNumChildren() == 0) {
+    return true;
+  }
+  for (unsigned i = 0; i < term.getNumChildren(); ++i) {
+    if (term[i].getType().isBitVector() && !seedDomain(term[i])) {
+      return false;
+    }
+  }
+  return restrictDomain(term, computeDomain(term));
+}
+
+bool PropagationSolver::propagateDown(TNode term) {
+  Domain domain = getDomain(term);
+
+  switch (term.getKind()) {
+  case kind::BITVECTOR_CONCAT: {
+    unsigned high = utils::getSize(term);
+    for (unsigned i = 0; i < term.getNumChildren(); ++i) {
+      unsigned low = high - utils::getSize(term[i]);
+      Domain restriction(utils::getSize(term[i]));
+      restriction.mask = domain.mask.extract(high - 1, low);
+      restriction.bits = domain.bits.extract(high - 1, low);
+      restriction.reasons = domain.reasons;
+      if (!restrictDomain(term[i], restriction)) {
+        return false;
+      }
+      high = low;
+    }
+    break;
+  }
+  case kind::BITVECTOR_EXTRACT: {
+    unsigned size = utils::getSize(term[0]);
+    unsigned high = utils::getExtractHigh(term);
+    unsigned low = utils::getExtractLow(term);
+    Domain restriction(size);
+    restriction.mask = domain.mask.zeroExtend(size - high - 1);
+    restriction.bits = domain.bits.zeroExtend(size - high - 1);
+    if (low > 0) {
+      restriction.mask = restriction.mask.concat(BitVector(low));
+      restriction.bits = restriction.bits.concat(BitVector(low));
+    }
+    restriction.reasons = domain.reasons;
+    if (!restrictDomain(term[0], restriction)) {
+      return false;
+    }
+    break;
+  }
+  default:
+    break;
+  }
+  return true;
+}
+
+bool PropagationSolver::assertFact(TNode atom, bool polarity, TNode fact) {
+  TNode a = atom[0];
+  TNode b = atom[1];
+  Domain a_domain = getDomain(a);
+  Domain b_domain = getDomain(b);
+  unsigned size = utils::getSize(a);
+  BitVector one(size, 1u);
+
+  switch (atom.getKind()) {
+  case kind::EQUAL:
+    if (polarity) {
+      a_domain.reasons.push_back(fact);
+      b_domain.reasons.push_back(fact);
+      return restrictDomain(a, b_domain) && restrictDomain(b, a_domain);
+    }
+    // a disequality only cuts off an end of an interval
+    if (b_domain.isConstant()) {
+      std::swap(a, b);
+      std::swap(a_domain, b_domain);
+    }
+    if (a_domain.isConstant()) {
+      Domain restriction(size);
+      restriction.reasons = a_domain.reasons;
+      restriction.reasons.push_back(fact);
+      if (b_domain.lower == a_domain.lower) {
+        if (b_domain.lower == allOnes(size)) {
+          restriction.lower = allOnes(size);
+          restriction.upper = BitVector(size);
+        } else {
+          restriction.lower = a_domain.lower + one;
+        }
+        return restrictDomain(b, restriction);
+      }
+      if (b_domain.upper == a_domain.lower) {
+        if (b_domain.upper == BitVector(size)) {
+          restriction.lower = allOnes(size);
+          restriction.upper = BitVector(size);
+        } else {
+          restriction.upper = a_domain.lower - one;
+        }
+        return restrictDomain(b, restriction);
+      }
+    }
+    return true;
+  case kind::BITVECTOR_ULT:
+  case kind::BITVECTOR_ULE: {
+    bool strict = atom.getKind() == kind::BITVECTOR_ULT;
+    if (!polarity) {
+      // not (a < b) is b <= a, and not (a <= b) is b < a
+      std::swap(a, b);
+      std::swap(a_domain, b_domain);
+      strict = !strict;
+    }
+    // a < b or a <= b: a is bounded by upper(b) and b by lower(a)
+    Domain a_restriction(size);
+    Domain b_restriction(size);
+    if (strict) {
+      if (b_domain.upper == BitVector(size) || a_domain.lower == allOnes(size)) {
+        std::vector<TNode> conflict = b_domain.upper == BitVector(size) ? b_domain.reasons : a_domain.reasons;
+        conflict.push_back(fact);
+        ++(d_statistics.d_numConflicts);
+        d_bv->setConflict(mkConjunction(conflict));
+        return false;
+      }
+      a_restriction.upper = b_domain.upper - one;
+      b_restriction.lower = a_domain.lower + one;
+    } else {
+      a_restriction.upper = b_domain.upper;
+      b_restriction.lower = a_domain.lower;
+    }
+    a_restriction.reasons = b_domain.reasons;
+    a_restriction.reasons.push_back(fact);
+    b_restriction.reasons = a_domain.reasons;
+    b_restriction.reasons.push_back(fact);
+    return restrictDomain(a, a_restriction) && restrictDomain(b, b_restriction);
+  }
+  default:
+    Unreachable();
+  }
+  return true;
+}
+
+void PropagationSolver::checkAtom(TNode atom) {
+  if (d_bv->inConflict() ||
+      d_explanations.find(atom) != d_explanations.end() ||
+      d_explanations.find(atom.notNode()) != d_explanations.end()) {
+    return;
+  }
+
+  Domain a_domain = getDomain(atom[0]);
+  Domain b_domain = getDomain(atom[1]);
+  bool implied = false;
+  bool value = false;
+
+  switch (atom.getKind()) {
+  case kind::EQUAL: {
+    BitVector common = a_domain.mask & b_domain.mask;
+    if (a_domain.upper < b_domain.lower || b_domain.upper < a_domain.lower ||
+        ((a_domain.bits ^ b_domain.bits) & common) != BitVector(common.getSize())) {
+      implied = true;
+      value = false;
+    } else if (a_domain.isConstant() && b_domain.isConstant()) {
+      implied = true;
+      value = true;
+    }
+    break;
+  }
+  case kind::BITVECTOR_ULT:
+    if (a_domain.upper < b_domain.lower) {
+      implied = true;
+      value = true;
+    } else if (a_domain.lower >= b_domain.upper) {
+      implied = true;
+      value = false;
+    }
+    break;
+  case kind::BITVECTOR_ULE:
+    if (a_domain.upper <= b_domain.lower) {
+      implied = true;
+      value = true;
+    } else if (a_domain.lower > b_domain.upper) {
+      implied = true;
+      value = false;
+    }
+    break;
+  default:
+    Unreachable();
+  }
+
+  if (!implied) {
+    return;
+  }
+
+  std::vector<TNode> reasons = a_domain.reasons;
+  addReasons(reasons, b_domain.reasons);
+  Node literal = value ? (Node) atom : atom.notNode();
+  BVDebug("bitvector::propagation") << "PropagationSolver::checkAtom propagating " << literal << "\n";
+  d_explanations.insert(literal, mkConjunction(reasons));
+  ++(d_statistics.d_numPropagations);
+  d_bv->storePropagation(literal, SUB_PROPAGATION);
+}
+
+bool PropagationSolver::propagate() {
+  while (!d_toVisit.empty() && d_budget > 0) {
+    TNode term = d_toVisit.back();
+    d_toVisit.pop_back();
+
+    if (!propagateDown(term)) {
+      return false;
+    }
+
+    ParentMap::const_iterator it = d_parents.find(term);
+    if (it == d_parents.end()) {
+      continue;
+    }
+    const std::vector<Node>& parents = it->second;
+    for (unsigned i = 0; i < parents.size(); ++i) {
+      TNode parent = parents[i];
+      if (parent.getType().isBoolean()) {
+        AssertedMap::const_iterator asserted = d_assertedAtoms.find(parent);
+        if (asserted == d_assertedAtoms.end()) {
+          checkAtom(parent);
+        } else {
+          bool polarity = (*asserted).second;
+          Node fact = polarity ? (Node) parent : parent.notNode();
+          if (!assertFact(parent, polarity, fact)) {
+            return false;
+          }
+        }
+      } else if (!restrictDomain(parent, computeDomain(parent))) {
+        return false;
+      }
+      if (d_bv->inConflict()) {
+        return false;
+      }
+    }
+  }
+  d_toVisit.clear();
+  return true;
+}
+
+bool PropagationSolver::addAssertions(const std::vector<TNode>& assertions, Theory::Effort e) {
+  BVDebug("bitvector::propagation") << "PropagationSolver::addAssertions (" << e << ")" << std::endl;
+  Assert (!d_bv->inConflict());
+
+  d_budget = s_maxDomainUpdates;
+  d_toVisit.clear();
+
+  for (unsigned i = 0; i < assertions.size(); ++i) {
+    TNode fact = assertions[i];
+    bool polarity = fact.getKind() != kind::NOT;
+    TNode atom = polarity ? fact : fact[0];
+    if (d_registered.find(atom) == d_registered.end() ||
+        d_bv->propagatedBy(fact, SUB_PROPAGATION)) {
+      continue;
+    }
+
+    d_assertedAtoms.insert(atom, polarity);
+    // compute the domains of the compound terms from their children
+    if (!seedDomain(atom[0]) || !seedDomain(atom[1])) {
+      return false;
+    }
+    if (!assertFact(atom, polarity, fact) || !propagate()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void PropagationSolver::explain(TNode literal, std::vector<TNode>& assumptions) {
+  ExplanationMap::const_iterator it = d_explanations.find(literal);
+  Assert (it != d_explanations.end());
+  TNode explanation = (*it).second;
+  if (explanation.getKind() == kind::AND) {
+    for (unsigned i = 0; i < explanation.getNumChildren(); ++i) {
+      assumptions.push_back(explanation[i]);
+    }
+  } else if (explanation != mkTrue()) {
+    assumptions.push_back(explanation);
+  }
+}
+
+PropagationSolver::Statistics::Statistics() :
+  d_numConflicts("theory::bv::PropagationSolver::NumConflicts", 0),
+  d_numPropagations("theory::bv::PropagationSolver::NumPropagations", 0),
+  d_numDomainUpdates("theory::bv::PropagationSolver::NumDomainUpdates", 0)
+{
+  StatisticsRegistry::registerStat(&d_numConflicts);
+  StatisticsRegistry::registerStat(&d_numPropagations);
+  StatisticsRegistry::registerStat(&d_numDomainUpdates);
+}
+
+PropagationSolver::Statistics::~Statistics() {
+  StatisticsRegistry::unregisterStat(&d_numConflicts);
+  StatisticsRegistry::unregisterStat(&d_numPropagations);
+  StatisticsRegistry::unregisterStat(&d_numDomainUpdates);
+}
@@ -0,0 +1,124 @@
+/*********************                                                        */
+/*! \file bv_subtheory_propagation.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Word-level propagation solver.
+ **
+ ** Keeps an unsigned interval and a set of known bits for every bit-vector
+ ** term and propagates them through the term structure and the asserted
+ ** equalities and unsigned comparisons, in order to find conflicts and
+ ** implied atoms before the bit-blaster is involved.
+ **/
+
+#include "cvc4_private.h"
+
+#pragma once
+
+#include "theory/bv/bv_subtheory.h"
+#include "context/cdhashmap.h"
+#include "context/cdhashset.h"
+#include "util/statistics_registry.h"
+#include "util/bitvector.h"
+#include <ext/hash_map>
+#include <ext/hash_set>
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+/**
+ * PropagationSolver
+ */
+class PropagationSolver : public SubtheorySolver {
+
+  /**
+   * The abstract value of a term: an unsigned interval [lower, upper]
+   * together with the bits fixed by mask and their values. The reasons
+   * are the asserted literals the domain was derived from.
+   */
+  struct Domain {
+    BitVector lower, upper;
+    BitVector mask, bits;
+    std::vector<TNode> reasons;
+
+    Domain() {}
+    Domain(unsigned size);
+    bool isEmpty() const;
+    bool isConstant() const { return lower == upper; }
+  };
+
+  typedef context::CDHashMap<Node, Domain, NodeHashFunction> DomainMap;
+  typedef context::CDHashMap<Node, bool, NodeHashFunction> AssertedMap;
+  typedef context::CDHashMap<Node, Node, NodeHashFunction> ExplanationMap;
+  typedef __gnu_cxx::hash_map<Node, std::vector<Node>, NodeHashFunction> ParentMap;
+  typedef __gnu_cxx::hash_set<Node, NodeHashFunction> NodeSet;
+
+  /** Current domains of the terms (terms with no entry are unconstrained) */
+  DomainMap d_domains;
+
+  /** The registered atoms that have been asserted, with their polarity */
+  AssertedMap d_assertedAtoms;
+
+  /** The explanations of the literals we propagated */
+  ExplanationMap d_explanations;
+
+  /** Terms whose domain has been computed from their children */
+  context::CDHashSet<Node, NodeHashFunction> d_seeded;
+
+  /** Maps each registered term to the terms and atoms it is a child of */
+  ParentMap d_parents;
+  NodeSet d_registered;
+
+  /** Terms whose domain changed and whose parents need to be visited */
+  std::vector<TNode> d_toVisit;
+
+  /** Remaining number of domain updates in this round */
+  unsigned d_budget;
+
+  void registerTerm(TNode node);
+
+  Domain getDomain(TNode term);
+  /** Computes the domain of the term from the domains of its children */
+  Domain computeDomain(TNode term);
+  /**
+   * Intersects the domain of term with the given domain. Returns false and
+   * sets the conflict if the result is empty.
+   */
+  bool restrictDomain(TNode term, const Domain& domain);
+  bool seedDomain(TNode term);
+  /** Restricts the children of concatenations and extracts from the term */
+  bool propagateDown(TNode term);
+
+  bool assertFact(TNode atom, bool polarity, TNode fact);
+  void checkAtom(TNode atom);
+  bool propagate();
+
+  class Statistics {
+  public:
+    IntStat d_numConflicts, d_numPropagations;
+    IntStat d_numDomainUpdates;
+    Statistics();
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+
+public:
+  PropagationSolver(context::Context* c, TheoryBV* bv);
+
+  void  preRegister(TNode node);
+  bool  addAssertions(const std::vector<TNode>& assertions, Theory::Effort e);
+  void  explain(TNode literal, std::vector<TNode>& assumptions);
+  void  collectModelInfo(TheoryModel* m) {}
+};
+
+}
+}
+}
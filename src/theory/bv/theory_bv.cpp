@@ -41,6 +41,7 @@ TheoryBV::TheoryBV(context::Context* c, context::UserContext* u, OutputChannel&
     d_sharedTermsSet(c),
     d_bitblastSolver(c, this),
     d_equalitySolver(c, this),
+    d_propagationSolver(c, this),
     d_statistics(),
     d_conflict(c, false),
     d_literalsToPropagate(c),
@@ -81,6 +82,9 @@ void TheoryBV::preRegisterTerm(TNode node) {
 
   d_bitblastSolver.preRegister(node);
   d_equalitySolver.preRegister(node);
+  if (options::bitvectorPropagationSolver()) {
+    d_propagationSolver.preRegister(node);
+  }
 }
 
 void TheoryBV::sendConflict() {
@@ -119,6 +123,11 @@ void TheoryBV::check(Effort e)
     d_equalitySolver.addAssertions(new_assertions, e);
   }
 
+  if (!inConflict() && options::bitvectorPropagationSolver()) {
+    // word-level propagation before bit-blasting
+    d_propagationSolver.addAssertions(new_assertions, e);
+  }
+
   if (!inConflict()) {
     // sending assertions to the bitblast solver
     d_bitblastSolver.addAssertions(new_assertions, e);
@@ -242,6 +251,9 @@ void TheoryBV::explain(TNode literal, std::vector<TNode>& assumptions) {
   if (propagatedBy(literal, SUB_EQUALITY)) {
     BVDebug("bitvector::explain") << "TheoryBV::explain(" << literal << "): EQUALITY" << std::endl;
     d_equalitySolver.explain(literal, assumptions);
+  } else if (propagatedBy(literal, SUB_PROPAGATION)) {
+    BVDebug("bitvector::explain") << "TheoryBV::explain(" << literal << "): PROPAGATION" << std::endl;
+    d_propagationSolver.explain(literal, assumptions);
   } else {
     Assert(propagatedBy(literal, SUB_BITBLAST));
     BVDebug("bitvector::explain") << "TheoryBV::explain(" << literal << ") : BITBLASTER" << std::endl;
@@ -29,6 +29,7 @@
 #include "theory/bv/bv_subtheory.h"
 #include "theory/bv/bv_subtheory_eq.h"
 #include "theory/bv/bv_subtheory_bitblast.h"
+#include "theory/bv/bv_subtheory_propagation.h"
 
 namespace CVC4 {
 namespace theory {
@@ -45,6 +46,7 @@ class TheoryBV : public Theory {
 
   BitblastSolver d_bitblastSolver;
   EqualitySolver d_equalitySolver;
+  PropagationSolver d_propagationSolver;
 public:
 
   TheoryBV(context::Context* c, context::UserContext* u, OutputChannel& out, Valuation valuation, const LogicInfo& logicInfo, QuantifiersEngine* qe);
@@ -137,6 +139,7 @@ private:
   friend class Bitblaster;
   friend class BitblastSolver;
   friend class EqualitySolver;
+  friend class PropagationSolver;
 
 };/* class TheoryBV */
 
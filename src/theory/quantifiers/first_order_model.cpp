@@ -112,122 +112,52 @@ void FirstOrderModel::resetEvaluate(){
 // if eVal is not 0, then
 //   each n{ri->d_index[0]/x_0...ri->d_index[depIndex]/x_depIndex, */x_(depIndex+1) ... */x_n } is equivalent in the current model
 int FirstOrderModel::evaluate( Node n, int& depIndex, RepSetIterator* ri ){
-  ++d_eval_formulas;
-  //Debug("fmf-eval-debug") << "Evaluate " << n << " " << phaseReq << std::endl;
-  //Notice() << "Eval " << n << std::endl;
-  if( n.getKind()==NOT ){
-    int val = evaluate( n[0], depIndex, ri );
-    return val==1 ? -1 : ( val==-1 ? 1 : 0 );
-  }else if( n.getKind()==OR || n.getKind()==AND || n.getKind()==IMPLIES ){
-    int baseVal = n.getKind()==AND ? 1 : -1;
-    int eVal = baseVal;
-    int posDepIndex = ri->getNumTerms();
-    int negDepIndex = -1;
-    for( int i=0; i<(int)n.getNumChildren(); i++ ){
-      //evaluate subterm
-      int childDepIndex;
-      Node nn = ( i==0 && n.getKind()==IMPLIES ) ? n[i].notNode() : n[i];
-      int eValT = evaluate( nn, childDepIndex, ri );
-      if( eValT==baseVal ){
-        if( eVal==baseVal ){
-          if( childDepIndex>negDepIndex ){
-            negDepIndex = childDepIndex;
-          }
-        }
-      }else if( eValT==-baseVal ){
-        eVal = -baseVal;
-        if( childDepIndex<posDepIndex ){
-          posDepIndex = childDepIndex;
-          if( posDepIndex==-1 ){
-            break;
-          }
-        }
-      }else if( eValT==0 ){
-        if( eVal==baseVal ){
-          eVal = 0;
-        }
-      }
-    }
-    if( eVal!=0 ){
-      depIndex = eVal==-baseVal ? posDepIndex : negDepIndex;
-      return eVal;
+  RepSetEvaluator ev( this, ri );
+  int eVal = ev.evaluate( n, depIndex );
+  d_eval_formulas += ev.getNumEvaluated();
+  return eVal;
+}
+
+int FirstOrderModel::evaluateLiteral( Node n, int& depIndex, RepSetIterator* ri ){
+  ++d_eval_lits;
+  ////if we know we will fail again, immediately return
+  //if( d_eval_failed.find( n )!=d_eval_failed.end() ){
+  //  if( d_eval_failed[n] ){
+  //    return -1;
+  //  }
+  //}
+  //Debug("fmf-eval-debug") << "Evaluate literal " << n << std::endl;
+  int retVal = 0;
+  depIndex = ri->getNumTerms()-1;
+  Node val = evaluateTerm( n, depIndex, ri );
+  if( !val.isNull() ){
+    if( areEqual( val, d_true ) ){
+      retVal = 1;
+    }else if( areEqual( val, d_false ) ){
+      retVal = -1;
     }else{
-      return 0;
-    }
-  }else if( n.getKind()==IFF || n.getKind()==XOR ){
-    int depIndex1;
-    int eVal = evaluate( n[0], depIndex1, ri );
-    if( eVal!=0 ){
-      int depIndex2;
-      int eVal2 = evaluate( n.getKind()==XOR ? n[1].notNode() : n[1], depIndex2, ri );
-      if( eVal2!=0 ){
-        depIndex = depIndex1>depIndex2 ? depIndex1 : depIndex2;
-        return eVal==eVal2 ? 1 : -1;
-      }
-    }
-    return 0;
-  }else if( n.getKind()==ITE ){
-    int depIndex1, depIndex2;
-    int eVal = evaluate( n[0], depIndex1, ri );
-    if( eVal==0 ){
-      //evaluate children to see if they are the same value
-      int eval1 = evaluate( n[1], depIndex1, ri );
-      if( eval1!=0 ){
-        int eval2 = evaluate( n[1], depIndex2, ri );
-        if( eval1==eval2 ){
-          depIndex = depIndex1>depIndex2 ? depIndex1 : depIndex2;
-          return eval1;
+      if( val.getKind()==EQUAL ){
+        if( areEqual( val[0], val[1] ) ){
+          retVal = 1;
+        }else if( areDisequal( val[0], val[1] ) ){
+          retVal = -1;
         }
       }
-    }else{
-      int eValT = evaluate( n[eVal==1 ? 1 : 2], depIndex2, ri );
-      depIndex = depIndex1>depIndex2 ? depIndex1 : depIndex2;
-      return eValT;
     }
-    return 0;
-  }else if( n.getKind()==FORALL ){
-    return 0;
+  }
+  if( retVal!=0 ){
+    Debug("fmf-eval-debug") << "Evaluate literal: return " << retVal << ", depIndex = " << depIndex << std::endl;
   }else{
-    ++d_eval_lits;
-    ////if we know we will fail again, immediately return
-    //if( d_eval_failed.find( n )!=d_eval_failed.end() ){
-    //  if( d_eval_failed[n] ){
-    //    return -1;
-    //  }
+    ++d_eval_lits_unknown;
+    Trace("fmf-eval-amb") << "Neither true nor false : " << n << std::endl;
+    Trace("fmf-eval-amb") << "   value : " << val << std::endl;
+    //std::cout << "Neither true nor false : " << n << std::endl;
+    //std::cout << "  Value : " << val << std::endl;
+    //for( int i=0; i<(int)n.getNumChildren(); i++ ){
+    //  std::cout << "   " << i << " : " << n[i].getType() << std::endl;
     //}
-    //Debug("fmf-eval-debug") << "Evaluate literal " << n << std::endl;
-    int retVal = 0;
-    depIndex = ri->getNumTerms()-1;
-    Node val = evaluateTerm( n, depIndex, ri );
-    if( !val.isNull() ){
-      if( areEqual( val, d_true ) ){
-        retVal = 1;
-      }else if( areEqual( val, d_false ) ){
-        retVal = -1;
-      }else{
-        if( val.getKind()==EQUAL ){
-          if( areEqual( val[0], val[1] ) ){
-            retVal = 1;
-          }else if( areDisequal( val[0], val[1] ) ){
-            retVal = -1;
-          }
-        }
-      }
-    }
-    if( retVal!=0 ){
-      Debug("fmf-eval-debug") << "Evaluate literal: return " << retVal << ", depIndex = " << depIndex << std::endl;
-    }else{
-      ++d_eval_lits_unknown;
-      Trace("fmf-eval-amb") << "Neither true nor false : " << n << std::endl;
-      Trace("fmf-eval-amb") << "   value : " << val << std::endl;
-      //std::cout << "Neither true nor false : " << n << std::endl;
-      //std::cout << "  Value : " << val << std::endl;
-      //for( int i=0; i<(int)n.getNumChildren(); i++ ){
-      //  std::cout << "   " << i << " : " << n[i].getType() << std::endl;
-      //}
-    }
-    return retVal;
   }
+  return retVal;
 }
 
 Node FirstOrderModel::evaluateTerm( Node n, int& depIndex, RepSetIterator* ri ){
@@ -346,6 +276,95 @@ Node FirstOrderModel::evaluateTerm( Node n, int& depIndex, RepSetIterator* ri ){
   return val;
 }
 
+int FirstOrderModel::evaluateSymbolic( Node n, std::vector< Node >& vals, int& splitVar ){
+  SymbolicEvaluator ev( this, vals );
+  int eVal = ev.evaluate( n, splitVar );
+  d_eval_formulas += ev.getNumEvaluated();
+  return eVal;
+}
+
+int FirstOrderModel::evaluateLiteralSymbolic( Node n, std::vector< Node >& vals, int& splitVar ){
+  ++d_eval_lits;
+  Node val = evaluateTermSymbolic( n, vals, splitVar );
+  if( !val.isNull() ){
+    if( areEqual( val, d_true ) ){
+      return 1;
+    }else if( areEqual( val, d_false ) ){
+      return -1;
+    }else if( val.getKind()==EQUAL ){
+      if( areEqual( val[0], val[1] ) ){
+        return 1;
+      }else if( areDisequal( val[0], val[1] ) ){
+        return -1;
+      }
+    }
+    ++d_eval_lits_unknown;
+  }
+  return 0;
+}
+
+Node FirstOrderModel::evaluateTermSymbolic( Node n, std::vector< Node >& vals, int& splitVar ){
+  if( n.getKind()==INST_CONSTANT ){
+    int v = n.getAttribute(InstVarNumAttribute());
+    if( vals[v].isNull() ){
+      splitVar = v;
+    }
+    return vals[v];
+  }else if( n.getKind()==ITE ){
+    int splitVarC = -1;
+    int eValC = evaluateSymbolic( n[0], vals, splitVarC );
+    if( eValC!=0 ){
+      return evaluateTermSymbolic( n[ eValC==1 ? 1 : 2 ], vals, splitVar );
+    }else{
+      int splitVar1 = -1;
+      int splitVar2 = -1;
+      Node val1 = evaluateTermSymbolic( n[1], vals, splitVar1 );
+      Node val2 = evaluateTermSymbolic( n[2], vals, splitVar2 );
+      if( !val1.isNull() && val1==val2 ){
+        return val1;
+      }
+      splitVar = splitVarC!=-1 ? splitVarC : ( splitVar1!=-1 ? splitVar1 : splitVar2 );
+      return Node::null();
+    }
+  }else if( n.getNumChildren()==0 ){
+    return n;
+  }else{
+    //evaluate the arguments, null arguments may have any value
+    std::vector< Node > children;
+    std::vector< int > childSplitVar;
+    bool isKnown = true;
+    for( int i=0; i<(int)n.getNumChildren(); i++ ){
+      childSplitVar.push_back( -1 );
+      Node nn = evaluateTermSymbolic( n[i], vals, childSplitVar[i] );
+      children.push_back( nn );
+      isKnown = isKnown && !nn.isNull();
+    }
+    if( n.getKind()==APPLY_UF && d_uf_model_tree.find( n.getOperator() )!=d_uf_model_tree.end() ){
+      //consult the interpretation, which may not depend on the unknown arguments
+      ++d_eval_uf_terms;
+      int splitArg = -1;
+      Node val = d_uf_model_tree[ n.getOperator() ].getUniformValue( this, children, splitArg );
+      if( val.isNull() && splitArg!=-1 ){
+        splitVar = childSplitVar[splitArg];
+      }
+      return val;
+    }else if( isKnown ){
+      if( n.getMetaKind()==kind::metakind::PARAMETERIZED ){
+        children.insert( children.begin(), n.getOperator() );
+      }
+      return Rewriter::rewrite( NodeManager::currentNM()->mkNode( n.getKind(), children ) );
+    }else{
+      for( int i=0; i<(int)childSplitVar.size(); i++ ){
+        if( childSplitVar[i]!=-1 ){
+          splitVar = childSplitVar[i];
+          break;
+        }
+      }
+      return Node::null();
+    }
+  }
+}
+
 Node FirstOrderModel::evaluateTermDefault( Node n, int& depIndex, std::vector< int >& childDepIndex, RepSetIterator* ri ){
   depIndex = -1;
   if( n.getNumChildren()==0 ){
@@ -20,6 +20,7 @@
 #include "theory/model.h"
 #include "theory/uf/theory_uf_model.h"
 #include "theory/arrays/theory_arrays_model.h"
+#include "theory/quantifiers/quant_util.h"
 
 namespace CVC4 {
 namespace theory {
@@ -86,6 +87,14 @@ public:
   /** evaluate functions */
   int evaluate( Node n, int& depIndex, RepSetIterator* ri  );
   Node evaluateTerm( Node n, int& depIndex, RepSetIterator* ri  );
+  /** symbolic evaluate functions
+    *   vals are the values of the variables (by InstVarNumAttribute), null for any value.
+    *   evaluateSymbolic returns 1 (resp. -1) if n is true (resp. false) for all values
+    *   of the null variables, 0 otherwise. splitVar is then a null variable the value of
+    *   n depends on, or -1 if there is none.
+    */
+  int evaluateSymbolic( Node n, std::vector< Node >& vals, int& splitVar );
+  Node evaluateTermSymbolic( Node n, std::vector< Node >& vals, int& splitVar );
 public:
   //statistics
   int d_eval_formulas;
@@ -93,6 +102,34 @@ public:
   int d_eval_lits;
   int d_eval_lits_unknown;
 private:
+  /** evaluator for the values of the variables in a RepSetIterator,
+      the dependency is the depIndex of evaluate */
+  class RepSetEvaluator : public BooleanEvaluator {
+  private:
+    FirstOrderModel* d_model;
+    RepSetIterator* d_ri;
+  protected:
+    int evaluateLiteral( Node n, int& dep ) { return d_model->evaluateLiteral( n, dep, d_ri ); }
+    int joinDependency( int d1, int d2 ) { return d1>d2 ? d1 : d2; }
+    int chooseDependency( int d1, int d2 ) { return d1<d2 ? d1 : d2; }
+    bool isBestDependency( int d ) { return d==-1; }
+  public:
+    RepSetEvaluator( FirstOrderModel* m, RepSetIterator* ri ) : d_model( m ), d_ri( ri ){}
+  };
+  /** evaluator for partial values of the variables, the dependency is the splitVar of evaluateSymbolic */
+  class SymbolicEvaluator : public BooleanEvaluator {
+  private:
+    FirstOrderModel* d_model;
+    std::vector< Node >& d_vals;
+  protected:
+    int evaluateLiteral( Node n, int& dep ) { return d_model->evaluateLiteralSymbolic( n, d_vals, dep ); }
+  public:
+    SymbolicEvaluator( FirstOrderModel* m, std::vector< Node >& vals ) : d_model( m ), d_vals( vals ){}
+  };
+  /** evaluate literal n, for evaluate */
+  int evaluateLiteral( Node n, int& depIndex, RepSetIterator* ri );
+  /** evaluate literal n, for evaluateSymbolic */
+  int evaluateLiteralSymbolic( Node n, std::vector< Node >& vals, int& splitVar );
   //default evaluate term function
   Node evaluateTermDefault( Node n, int& depIndex, std::vector< int >& childDepIndex, RepSetIterator* ri  );
   //temporary storing which literals have failed
@@ -15,6 +15,7 @@
 #include "theory/quantifiers/inst_match.h"
 #include "theory/quantifiers/term_database.h"
 #include "theory/quantifiers/quant_util.h"
+#include "theory/quantifiers/options.h"
 #include "theory/quantifiers_engine.h"
 
 using namespace std;
@@ -217,6 +218,163 @@ bool InstMatchTrie::addInstMatch( QuantifiersEngine* qe, Node f, InstMatch& m, b
 }
 
 
+size_t InstMatchSet::hashTerms( const std::vector< Node >& terms ){
+  size_t hash = 0;
+  for( size_t i=0; i<terms.size(); i++ ){
+    hash ^= 0x9e3779b9 + NodeHashFunction()( terms[i] ) + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+void InstMatchSet::HashIndex::insert( size_t h, size_t index ){
+  if( 2*( d_entries+1 )>d_table.size() ){
+    //grow the table, keep it at most half full
+    std::vector< std::pair< size_t, size_t > > old;
+    old.swap( d_table );
+    d_table.resize( old.empty() ? 16 : 2*old.size(), std::pair< size_t, size_t >( 0, 0 ) );
+    d_entries = 0;
+    for( size_t i=0; i<old.size(); i++ ){
+      if( old[i].second!=0 ){
+        insert( old[i].first, old[i].second-1 );
+      }
+    }
+  }
+  size_t mask = d_table.size()-1;
+  size_t i = h & mask;
+  while( d_table[i].second!=0 ){
+    i = ( i+1 ) & mask;
+  }
+  d_table[i] = std::pair< size_t, size_t >( h, index+1 );
+  d_entries++;
+}
+
+void InstMatchSet::HashIndex::clear(){
+  d_table.assign( d_table.size(), std::pair< size_t, size_t >( 0, 0 ) );
+  d_entries = 0;
+}
+
+bool InstMatchSet::lookup( const HashIndex& hi, size_t h, const std::vector< Node >& terms, EqualityQuery* q ) const{
+  if( hi.d_table.empty() ){
+    return false;
+  }
+  size_t mask = hi.d_table.size()-1;
+  for( size_t i = h & mask; hi.d_table[i].second!=0; i = ( i+1 ) & mask ){
+    if( hi.d_table[i].first==h ){
+      size_t start = ( hi.d_table[i].second-1 )*d_arity;
+      bool success = true;
+      for( size_t j=0; j<d_arity && success; j++ ){
+        const Node& n = d_terms[start+j];
+        success = n==terms[j] || ( q && !n.isNull() && !terms[j].isNull() && q->areEqual( n, terms[j] ) );
+      }
+      if( success ){
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool InstMatchSet::lookupAll( const std::vector< Node >& terms, EqualityQuery* q ) const{
+  for( size_t start=0; start<d_terms.size(); start+=d_arity ){
+    bool success = true;
+    for( size_t j=0; j<d_arity && success; j++ ){
+      const Node& n = d_terms[start+j];
+      success = n==terms[j] || ( !n.isNull() && !terms[j].isNull() && q->areEqual( n, terms[j] ) );
+    }
+    if( success ){
+      return true;
+    }
+  }
+  return false;
+}
+
+void InstMatchSet::getTerms( QuantifiersEngine* qe, Node f, InstMatch& m, std::vector< Node >& terms ){
+  d_arity = f[0].getNumChildren();
+  for( size_t i=0; i<d_arity; i++ ){
+    terms.push_back( m.getValue( qe->getTermDatabase()->getInstantiationConstant( f, i ) ) );
+  }
+}
+
+void InstMatchSet::getRepresentatives( QuantifiersEngine* qe, std::vector< Node >& terms, std::vector< Node >& reps ){
+  for( size_t i=0; i<terms.size(); i++ ){
+    reps.push_back( terms[i].isNull() ? terms[i] : qe->getEqualityQuery()->getRepresentative( terms[i] ) );
+  }
+}
+
+int InstMatchSet::getResetCount( QuantifiersEngine* qe ){
+  return ((EqualityQueryQuantifiersEngine*)qe->getEqualityQuery())->getResetCount();
+}
+
+void InstMatchSet::updateRepIndex( QuantifiersEngine* qe ){
+  int resetCount = getResetCount( qe );
+  if( resetCount!=d_rep_reset ){
+    //representatives may have changed since the index was built, rehash all instantiations
+    d_rep_reset = resetCount;
+    d_rep_index.clear();
+    for( size_t index=0; index<size(); index++ ){
+      std::vector< Node > terms( d_terms.begin() + index*d_arity, d_terms.begin() + ( index+1 )*d_arity );
+      std::vector< Node > reps;
+      getRepresentatives( qe, terms, reps );
+      d_rep_index.insert( hashTerms( reps ), index );
+    }
+  }
+}
+
+bool InstMatchSet::existsModEq( QuantifiersEngine* qe, std::vector< Node >& terms, size_t hr ){
+  EqualityQuery* q = qe->getEqualityQuery();
+  if( lookup( d_rep_index, hr, terms, q ) ){
+    return true;
+  }else if( options::eagerInstQuant() ){
+    //merges since the last reset may have moved an equal instantiation to another bucket
+    return lookupAll( terms, q );
+  }else{
+    return false;
+  }
+}
+
+bool InstMatchSet::existsInstMatch( QuantifiersEngine* qe, Node f, InstMatch& m, bool modEq ){
+  std::vector< Node > terms;
+  getTerms( qe, f, m, terms );
+  if( lookup( d_index, hashTerms( terms ), terms, NULL ) ){
+    return true;
+  }else if( modEq ){
+    updateRepIndex( qe );
+    std::vector< Node > reps;
+    getRepresentatives( qe, terms, reps );
+    return existsModEq( qe, terms, hashTerms( reps ) );
+  }else{
+    return false;
+  }
+}
+
+bool InstMatchSet::addInstMatch( QuantifiersEngine* qe, Node f, InstMatch& m, bool modEq ){
+  std::vector< Node > terms;
+  getTerms( qe, f, m, terms );
+  size_t h = hashTerms( terms );
+  if( lookup( d_index, h, terms, NULL ) ){
+    return false;
+  }
+  //if the representatives index is out of date and not needed now, it is rebuilt when it is next used
+  bool useRepIndex = modEq || d_rep_reset==getResetCount( qe );
+  size_t hr = 0;
+  if( useRepIndex ){
+    updateRepIndex( qe );
+    std::vector< Node > reps;
+    getRepresentatives( qe, terms, reps );
+    hr = hashTerms( reps );
+    if( modEq && existsModEq( qe, terms, hr ) ){
+      return false;
+    }
+  }
+  size_t index = size();
+  d_terms.insert( d_terms.end(), terms.begin(), terms.end() );
+  d_index.insert( h, index );
+  if( useRepIndex ){
+    d_rep_index.insert( hr, index );
+  }
+  return true;
+}
+
 }/* CVC4::theory::inst namespace */
 }/* CVC4::theory namespace */
 }/* CVC4 namespace */
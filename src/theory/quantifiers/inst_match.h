@@ -162,6 +162,68 @@ public:
   }
 };/* class InstMatchTrieOrdered */
 
+/** set of the instantiations of a quantifier, for detecting duplicates.
+    The terms of the instantiations are stored one after the other in a
+    flat vector. One open-addressed hash table indexes each instantiation
+    by the hash of its terms, and another by the hash of the representatives
+    of its terms. The latter is used for checking modulo equality, where a
+    hit is confirmed by checking the terms are equal. Since merges change the
+    representatives, the second table is rebuilt when the equality query is
+    reset, and with eager instantiation, where merges happen between resets,
+    a miss is confirmed by comparing against every instantiation.
+*/
+class InstMatchSet {
+private:
+  /** an open-addressed hash table from hashes to instantiation indices */
+  class HashIndex {
+  public:
+    /** the entries, ( hash, instantiation index + 1 ), 0 is empty */
+    std::vector< std::pair< size_t, size_t > > d_table;
+    /** the number of non-empty entries in d_table */
+    size_t d_entries;
+    HashIndex() : d_entries( 0 ){}
+    /** insert the entry for instantiation index with hash h */
+    void insert( size_t h, size_t index );
+    /** remove all entries */
+    void clear();
+  };
+  /** the number of variables of the quantifier */
+  size_t d_arity;
+  /** the terms of the instantiations */
+  std::vector< Node > d_terms;
+  /** the index by the hash of the terms */
+  HashIndex d_index;
+  /** the index by the hash of the representatives of the terms */
+  HashIndex d_rep_index;
+  /** the reset count of the equality query when d_rep_index was built, -1 if never */
+  int d_rep_reset;
+  /** hash of a tuple of terms */
+  static size_t hashTerms( const std::vector< Node >& terms );
+  /** is there an instantiation in hi with hash h whose terms are (equal to, if q is non-null) terms */
+  bool lookup( const HashIndex& hi, size_t h, const std::vector< Node >& terms, EqualityQuery* q ) const;
+  /** is there an instantiation whose terms are equal to terms, checked against all of them */
+  bool lookupAll( const std::vector< Node >& terms, EqualityQuery* q ) const;
+  /** get the terms of m for quantifier f */
+  void getTerms( QuantifiersEngine* qe, Node f, InstMatch& m, std::vector< Node >& terms );
+  /** get the representatives of terms */
+  void getRepresentatives( QuantifiersEngine* qe, std::vector< Node >& terms, std::vector< Node >& reps );
+  /** get the reset count of the equality query of qe */
+  static int getResetCount( QuantifiersEngine* qe );
+  /** rebuild d_rep_index if the representatives may have changed since it was built */
+  void updateRepIndex( QuantifiersEngine* qe );
+  /** is there an instantiation equal to terms modulo equality */
+  bool existsModEq( QuantifiersEngine* qe, std::vector< Node >& terms, size_t hr );
+public:
+  InstMatchSet() : d_arity( 0 ), d_rep_reset( -1 ){}
+  ~InstMatchSet(){}
+  /** return true if m exists in this set, modEq is if we check modulo equality */
+  bool existsInstMatch( QuantifiersEngine* qe, Node f, InstMatch& m, bool modEq = false );
+  /** add match m for quantifier f, return true if it did not already exist */
+  bool addInstMatch( QuantifiersEngine* qe, Node f, InstMatch& m, bool modEq = false );
+  /** get the number of instantiations */
+  size_t size() const { return d_arity==0 ? 0 : d_terms.size()/d_arity; }
+};/* class InstMatchSet */
+
 }/* CVC4::theory::inst namespace */
 
 typedef CVC4::theory::inst::InstMatch InstMatch;
@@ -16,6 +16,7 @@
 #include "theory/quantifiers/trigger.h"
 #include "theory/quantifiers/term_database.h"
 #include "theory/quantifiers/candidate_generator.h"
+#include "theory/quantifiers/match_code_tree.h"
 #include "theory/quantifiers_engine.h"
 
 using namespace std;
@@ -627,20 +628,20 @@ void InstMatchGeneratorSimple::addInstantiations( InstMatch& m, QuantifiersEngin
   }else{
     if( d_match_pattern[argIndex].getKind()==INST_CONSTANT ){
       Node ic = d_match_pattern[argIndex];
-      for( std::map< Node, quantifiers::TermArgTrie >::iterator it = tat->d_data.begin(); it != tat->d_data.end(); ++it ){
+      for( quantifiers::TermArgTrie::TrieMap::iterator it = tat->d_data.begin(); it != tat->d_data.end(); ++it ){
         Node t = it->first;
         if( ( m.get( ic ).isNull() || m.get( ic )==t ) && ic.getType()==t.getType() ){
           Node prev = m.get( ic );
           m.set( ic, t);
-          addInstantiations( m, qe, addedLemmas, argIndex+1, &(it->second) );
+          addInstantiations( m, qe, addedLemmas, argIndex+1, it->second );
           m.set( ic, prev);
         }
       }
     }else{
       Node r = qe->getEqualityQuery()->getRepresentative( d_match_pattern[argIndex] );
-      std::map< Node, quantifiers::TermArgTrie >::iterator it = tat->d_data.find( r );
+      quantifiers::TermArgTrie::TrieMap::iterator it = tat->d_data.find( r );
       if( it!=tat->d_data.end() ){
-        addInstantiations( m, qe, addedLemmas, argIndex+1, &(it->second) );
+        addInstantiations( m, qe, addedLemmas, argIndex+1, it->second );
       }
     }
   }
@@ -659,6 +660,64 @@ int InstMatchGeneratorSimple::addTerm( Node f, Node t, QuantifiersEngine* qe ){
   return qe->addInstantiation( f, m ) ? 1 : 0;
 }
 
+InstMatchGeneratorCodeTree::InstMatchGeneratorCodeTree( Node pat, QuantifiersEngine* qe ) :
+d_tree( qe->getMatchCodeTree() ), d_index( 0 ){
+  d_id = d_tree->addPattern( pat );
+}
+
+void InstMatchGeneratorCodeTree::resetInstantiationRound( QuantifiersEngine* qe ){
+  //the matches are recomputed (for all stale patterns at once) when they are next asked for
+  d_tree->resetPattern( d_id );
+  d_index = 0;
+}
+
+void InstMatchGeneratorCodeTree::getMatch( std::vector< Node >& vals, InstMatch& m ){
+  std::vector< Node >& vars = d_tree->getVariables( d_id );
+  for( int i=0; i<(int)vars.size(); i++ ){
+    m.set( vars[i], vals[i] );
+  }
+}
+
+bool InstMatchGeneratorCodeTree::getNextMatch( InstMatch& m, QuantifiersEngine* qe ){
+  std::vector< std::vector< Node > >& matches = d_tree->getMatches( d_id );
+  if( d_index<(int)matches.size() ){
+    getMatch( matches[d_index], m );
+    d_index++;
+    return true;
+  }else{
+    return false;
+  }
+}
+
+int InstMatchGeneratorCodeTree::addInstantiations( Node f, std::vector< std::vector< Node > >& matches,
+                                                   InstMatch& baseMatch, QuantifiersEngine* qe ){
+  //copy, since adding instantiations may add terms that are matched eagerly
+  std::vector< std::vector< Node > > ms( matches );
+  int addedLemmas = 0;
+  for( int i=0; i<(int)ms.size(); i++ ){
+    InstMatch m;
+    getMatch( ms[i], m );
+    m.add( baseMatch );
+    if( qe->addInstantiation( f, m ) ){
+      addedLemmas++;
+      if( qe->d_optInstLimitActive && qe->d_optInstLimit<=0 ){
+        return addedLemmas;
+      }
+    }
+  }
+  return addedLemmas;
+}
+
+int InstMatchGeneratorCodeTree::addInstantiations( Node f, InstMatch& baseMatch, QuantifiersEngine* qe ){
+  return addInstantiations( f, d_tree->getMatches( d_id ), baseMatch, qe );
+}
+
+int InstMatchGeneratorCodeTree::addTerm( Node f, Node t, QuantifiersEngine* qe ){
+  Assert( options::eagerInstQuant() );
+  InstMatch baseMatch;
+  return addInstantiations( f, d_tree->getMatches( d_id, t ), baseMatch, qe );
+}
+
 }/* CVC4::theory::inst namespace */
 }/* CVC4::theory namespace */
 }/* CVC4 namespace */
@@ -185,6 +185,38 @@ public:
   int addTerm( Node f, Node t, QuantifiersEngine* qe );
 };/* class InstMatchGeneratorSimple */
 
+class MatchCodeTree;
+
+/** single trigger implementation that matches using a code tree shared by all quantifiers */
+class InstMatchGeneratorCodeTree : public IMGenerator {
+private:
+  /** the shared code tree */
+  MatchCodeTree* d_tree;
+  /** the id of the pattern in the code tree */
+  int d_id;
+  /** index of the next match for getNextMatch */
+  int d_index;
+  /** make the inst match for values vals */
+  void getMatch( std::vector< Node >& vals, InstMatch& m );
+  /** add instantiations for each of the matches */
+  int addInstantiations( Node f, std::vector< std::vector< Node > >& matches, InstMatch& baseMatch, QuantifiersEngine* qe );
+public:
+  /** constructors */
+  InstMatchGeneratorCodeTree( Node pat, QuantifiersEngine* qe );
+  /** destructor */
+  ~InstMatchGeneratorCodeTree(){}
+  /** reset instantiation round (call this whenever equivalence classes have changed) */
+  void resetInstantiationRound( QuantifiersEngine* qe );
+  /** reset, eqc is the equivalence class to search in (eqc is ignored) */
+  void reset( Node eqc, QuantifiersEngine* qe ) { d_index = 0; }
+  /** get the next match.  must call reset( eqc ) before this function. */
+  bool getNextMatch( InstMatch& m, QuantifiersEngine* qe );
+  /** add instantiations */
+  int addInstantiations( Node f, InstMatch& baseMatch, QuantifiersEngine* qe );
+  /** add ground term t, possibly add instantiations */
+  int addTerm( Node f, Node t, QuantifiersEngine* qe );
+};/* class InstMatchGeneratorCodeTree */
+
 }
 }
 }
@@ -0,0 +1,79 @@
+/*********************                                                        */
+/*! \file inst_scheduler.cpp
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Implementation of scheduler for instantiation lemmas
+ **/
+
+#include "theory/quantifiers/inst_scheduler.h"
+#include "theory/quantifiers/term_database.h"
+#include "theory/quantifiers_engine.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::kind;
+using namespace CVC4::context;
+using namespace CVC4::theory;
+using namespace CVC4::theory::quantifiers;
+
+int InstScheduler::computeScore( Node f, std::vector< Node >& terms ){
+  uint64_t level = 0;
+  int irrelevant = 0;
+  EqualityQuery* q = d_qe->getEqualityQuery();
+  for( int i=0; i<(int)terms.size(); i++ ){
+    if( terms[i].hasAttribute(InstLevelAttribute()) ){
+      level = std::max( level, terms[i].getAttribute(InstLevelAttribute()) );
+    }
+    if( !q->hasTerm( terms[i] ) ){
+      irrelevant++;
+    }
+  }
+  int load = 0;
+  for( int sent = d_sent[f]; sent>0; sent = sent/2 ){
+    load++;
+  }
+  return 2*(int)level + irrelevant + load;
+}
+
+void InstScheduler::addLemma( Node lem, Node f, Node body, std::vector< Node >& terms ){
+  int score = computeScore( f, terms );
+  Debug("inst-sched") << "Schedule lemma for " << f << " with score " << score << std::endl;
+  d_queue.push( ScheduledLemma( lem, f, body, terms, score, d_age ) );
+  d_age++;
+  ++(d_statistics.d_scheduled);
+  d_statistics.d_max_waiting.maxAssign( (int)d_queue.size() );
+}
+
+void InstScheduler::getLemmas( int n, std::vector< ScheduledLemma >& lemmas ){
+  for( int i=0; i<n && !d_queue.empty(); i++ ){
+    const ScheduledLemma& sl = d_queue.top();
+    Debug("inst-sched") << "Send lemma for " << sl.d_f << " with score " << sl.d_score << std::endl;
+    lemmas.push_back( sl );
+    d_sent[ sl.d_f ]++;
+    d_queue.pop();
+    ++(d_statistics.d_sent);
+  }
+}
+
+InstScheduler::Statistics::Statistics():
+  d_scheduled("InstScheduler::Lemmas_Scheduled", 0),
+  d_sent("InstScheduler::Lemmas_Sent", 0),
+  d_max_waiting("InstScheduler::Max_Lemmas_Waiting", 0)
+{
+  StatisticsRegistry::registerStat(&d_scheduled);
+  StatisticsRegistry::registerStat(&d_sent);
+  StatisticsRegistry::registerStat(&d_max_waiting);
+}
+
+InstScheduler::Statistics::~Statistics(){
+  StatisticsRegistry::unregisterStat(&d_scheduled);
+  StatisticsRegistry::unregisterStat(&d_sent);
+  StatisticsRegistry::unregisterStat(&d_max_waiting);
+}
@@ -0,0 +1,101 @@
+/*********************                                                        */
+/*! \file inst_scheduler.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief scheduler for instantiation lemmas
+ **
+ ** Instantiation lemmas are scored when they are produced, and the best
+ ** ones are sent first, a limited number per instantiation round. The
+ ** score of a lemma (lower is better) is
+ **   2 * level + #irrelevant terms + log2( 1 + #lemmas sent for f )
+ ** where level is the maximum instantiation level of its terms, a term is
+ ** irrelevant if it is not in the current equality engine, and the last
+ ** part prevents a single quantifier from taking the whole budget. Ties are
+ ** broken by age, older lemmas first.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__QUANTIFIERS__INST_SCHEDULER_H
+#define __CVC4__THEORY__QUANTIFIERS__INST_SCHEDULER_H
+
+#include "expr/node.h"
+#include "util/statistics_registry.h"
+
+#include <map>
+#include <queue>
+#include <vector>
+
+namespace CVC4 {
+namespace theory {
+
+class QuantifiersEngine;
+
+namespace quantifiers {
+
+class InstScheduler {
+public:
+  /** a lemma waiting to be sent, the instantiation of d_f with d_terms */
+  class ScheduledLemma {
+  public:
+    Node d_lemma;
+    Node d_f;
+    Node d_body;
+    std::vector< Node > d_terms;
+    int d_score;
+    uint64_t d_age;
+    ScheduledLemma( Node lem, Node f, Node body, std::vector< Node >& terms, int score, uint64_t age ) :
+      d_lemma( lem ), d_f( f ), d_body( body ), d_terms( terms ), d_score( score ), d_age( age ){}
+  };
+private:
+  /** a is worse than b, so that the best lemma is at the top of the queue */
+  struct ScheduledLemmaWorse {
+    bool operator()( const ScheduledLemma& a, const ScheduledLemma& b ) const {
+      return a.d_score>b.d_score || ( a.d_score==b.d_score && a.d_age>b.d_age );
+    }
+  };
+  typedef std::priority_queue< ScheduledLemma, std::vector< ScheduledLemma >, ScheduledLemmaWorse > LemmaQueue;
+  /** the quantifiers engine */
+  QuantifiersEngine* d_qe;
+  /** the lemmas waiting to be sent */
+  LemmaQueue d_queue;
+  /** number of lemmas scheduled so far */
+  uint64_t d_age;
+  /** number of lemmas sent for each quantifier */
+  std::map< Node, int > d_sent;
+  /** compute the score of an instantiation of f with terms */
+  int computeScore( Node f, std::vector< Node >& terms );
+public:
+  InstScheduler( QuantifiersEngine* qe ) : d_qe( qe ), d_age( 0 ){}
+  ~InstScheduler(){}
+  /** schedule lem, the instantiation of f with terms whose body is body */
+  void addLemma( Node lem, Node f, Node body, std::vector< Node >& terms );
+  /** remove the best (at most) n lemmas and add them to lemmas */
+  void getLemmas( int n, std::vector< ScheduledLemma >& lemmas );
+  /** are there lemmas waiting to be sent */
+  bool empty() const { return d_queue.empty(); }
+public:
+  /** statistics class */
+  class Statistics {
+  public:
+    IntStat d_scheduled;
+    IntStat d_sent;
+    IntStat d_max_waiting;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+};/* class InstScheduler */
+
+}/* CVC4::theory::quantifiers namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__QUANTIFIERS__INST_SCHEDULER_H */
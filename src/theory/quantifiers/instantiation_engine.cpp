@@ -116,11 +116,17 @@ bool InstantiationEngine::doInstantiationRound( Theory::Effort effort ){
   //iterate over an internal effort level e
   int e = 0;
   int eLimit = effort==Theory::EFFORT_LAST_CALL ? 10 : 2;
+  //instantiations must be collected before they can be filtered
+  bool useBatch = options::instConflictFirst();
   d_inst_round_status = InstStrategy::STATUS_UNFINISHED;
   //while unfinished, try effort level=0,1,2....
   while( d_inst_round_status==InstStrategy::STATUS_UNFINISHED && e<=eLimit ){
     Debug("inst-engine") << "IE: Prepare instantiation (" << e << ")." << std::endl;
     d_inst_round_status = InstStrategy::STATUS_SAT;
+    //collect the instantiations of all quantifiers, so that only those in conflict or propagating are added if there are any
+    if( useBatch ){
+      d_quantEngine->beginInstantiationBatch();
+    }
     //instantiate each quantifier
     for( int q=0; q<d_quantEngine->getModel()->getNumAssertedQuantifiers(); q++ ){
       Node f = d_quantEngine->getModel()->getAssertedQuantifier( q );
@@ -143,6 +149,10 @@ bool InstantiationEngine::doInstantiationRound( Theory::Effort effort ){
         }
       }
     }
+    if( useBatch ){
+      int numInst = d_quantEngine->commitInstantiationBatch();
+      Debug("inst-engine") << "IE: Committed batch, # added = " << numInst << std::endl;
+    }
     //do not consider another level if already added lemma at this level
     if( d_quantEngine->hasAddedLemma() ){
       d_inst_round_status = InstStrategy::STATUS_UNKNOWN;
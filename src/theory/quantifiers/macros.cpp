@@ -12,6 +12,11 @@
  ** \brief Sort inference module
  **
  ** This class implements quantifiers macro definitions.
+ ** A quantifier forall x. ( ~c V f( t ) = s ), where c is an optional
+ ** quantifier-free guard, defines f as a macro. Definitions may use other
+ ** macros, which are expanded when the definition is first used, so that
+ ** one pass over the assertions expands nested macros. The quantifiers
+ ** that define a macro are satisfied by construction and are removed.
  **/
 
 #include <vector>
@@ -35,7 +40,7 @@ bool QuantifierMacros::simplify( std::vector< Node >& assertions, bool doRewrite
         args.push_back( assertions[i][0][j] );
       }
       //look at the body of the quantifier for macro definition
-      process( assertions[i][1], true, args, assertions[i] );
+      process( assertions[i][1], true, args, assertions[i], Node::null() );
     }
   }
   //create macro defs
@@ -63,17 +68,24 @@ bool QuantifierMacros::simplify( std::vector< Node >& assertions, bool doRewrite
       }
     }
     d_macro_defs[ it->first ] = val;
+    if( !val.isNull() ){
+      d_macro_quants[ d_macro_def_quant[ it->first ] ] = true;
+    }
     Trace("macros-def") << "* " << val << " is a macro for " << it->first << std::endl;
   }
-  //now simplify bodies
-  for( std::map< Node, Node >::iterator it = d_macro_defs.begin(); it != d_macro_defs.end(); ++it ){
-    d_macro_defs[ it->first ] = Rewriter::rewrite( simplify( it->second ) );
-  }
   bool retVal = false;
   if( doRewrite && !d_macro_defs.empty() ){
     //now, rewrite based on macro definitions
     for( size_t i=0; i<assertions.size(); i++ ){
       Node prev = assertions[i];
+      if( d_macro_quants.find( prev )!=d_macro_quants.end() ){
+        //the quantifier holds by the definition of its macro
+        assertions[i] = NodeManager::currentNM()->mkConst( true );
+        Trace("macros-rewrite") << "Eliminate " << prev << std::endl;
+        d_num_eliminated++;
+        retVal = true;
+        continue;
+      }
       assertions[i] = simplify( assertions[i] );
       if( prev!=assertions[i] ){
         assertions[i] = Rewriter::rewrite( assertions[i] );
@@ -118,6 +130,19 @@ bool QuantifierMacros::containsBadOp( Node n, Node n_op ){
   return false;
 }
 
+bool QuantifierMacros::containsOp( Node n, Node op ){
+  if( n.getKind()==APPLY_UF && n.getOperator()==op ){
+    return true;
+  }else{
+    for( size_t i=0; i<n.getNumChildren(); i++ ){
+      if( containsOp( n[i], op ) ){
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
 bool QuantifierMacros::isMacroLiteral( Node n, bool pol ){
   return pol && n.getKind()==EQUAL;//( n.getKind()==EQUAL || n.getKind()==IFF );
 }
@@ -230,12 +255,40 @@ bool QuantifierMacros::getSubstitution( std::vector< Node >& v_quant, std::map<
   return success;
 }
 
-void QuantifierMacros::process( Node n, bool pol, std::vector< Node >& args, Node f ){
+bool QuantifierMacros::containsQuantifier( Node n ){
+  if( n.getKind()==FORALL || n.getKind()==EXISTS ){
+    return true;
+  }else{
+    for( size_t i=0; i<n.getNumChildren(); i++ ){
+      if( containsQuantifier( n[i] ) ){
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+void QuantifierMacros::process( Node n, bool pol, std::vector< Node >& args, Node f, Node cond ){
   if( n.getKind()==NOT ){
-    process( n[0], !pol, args, f );
+    process( n[0], !pol, args, f, cond );
   }else if( n.getKind()==AND || n.getKind()==OR || n.getKind()==IMPLIES ){
-    //bool favorPol = (n.getKind()==AND)==pol;
-    //conditional?
+    //a disjunction ( ~c_1 V ... V ~c_k V l ) is a definition l guarded by c_1 ^ ... ^ c_k
+    if( cond.isNull() && ( n.getKind()==AND )!=pol ){
+      for( size_t i=0; i<n.getNumChildren(); i++ ){
+        std::vector< Node > conds;
+        for( size_t j=0; j<n.getNumChildren(); j++ ){
+          if( j!=i ){
+            //the polarity of the disjunct j is pol, or !pol for the antecedant of an implication
+            bool cpol = ( n.getKind()==IMPLIES && j==0 ) ? !pol : pol;
+            conds.push_back( cpol ? n[j].negate() : n[j] );
+          }
+        }
+        Node c = conds.size()==1 ? conds[0] : NodeManager::currentNM()->mkNode( AND, conds );
+        if( !containsQuantifier( c ) ){
+          process( n[i], ( n.getKind()==IMPLIES && i==0 ) ? !pol : pol, args, f, c );
+        }
+      }
+    }
   }else if( n.getKind()==ITE ){
     //can not do anything
   }else{
@@ -248,14 +301,15 @@ void QuantifierMacros::process( Node n, bool pol, std::vector< Node >& args, Nod
       for( size_t i=0; i<candidates.size(); i++ ){
         Node m = candidates[i];
         Node op = m.getOperator();
-        if( !containsBadOp( n, m ) ){
+        //the condition may not mention op at all, not even as m itself
+        if( !containsBadOp( n, m ) && ( cond.isNull() || ( !containsOp( cond, op ) && !containsBadOp( cond, m ) ) ) ){
           std::vector< Node > fvs;
           getFreeVariables( m, args, fvs, false );
           //get definition and condition
           Node n_def = solveInEquality( m, n ); //definition for the macro
           //definition must exist and not contain any free variables apart from fvs
           if( !n_def.isNull() && !getFreeVariables( n_def, args, fvs, true ) ){
-            Node n_cond;  //condition when this definition holds
+            Node n_cond = cond;  //condition when this definition holds
             //conditional must not contain any free variables apart from fvs
             if( n_cond.isNull() || !getFreeVariables( n_cond, args, fvs, true ) ){
               Trace("macros") << m << " is possible macro in " << f << std::endl;
@@ -336,6 +390,7 @@ void QuantifierMacros::process( Node n, bool pol, std::vector< Node >& args, Nod
                     d_macro_def_cases[ op ].clear();
                   }
                   d_macro_def_cases[ op ].push_back( std::pair< Node, Node >( n_cond, n_def ) );
+                  d_macro_def_quant[ op ] = f;
                 }
               }
             }
@@ -347,6 +402,10 @@ void QuantifierMacros::process( Node n, bool pol, std::vector< Node >& args, Nod
 }
 
 Node QuantifierMacros::simplify( Node n ){
+  std::map< Node, Node >::iterator itc = d_simplify_cache.find( n );
+  if( itc!=d_simplify_cache.end() ){
+    return itc->second;
+  }
   Trace("macros-debug") << "simplify " << n << std::endl;
   std::vector< Node > children;
   bool childChanged = false;
@@ -355,21 +414,27 @@ Node QuantifierMacros::simplify( Node n ){
     children.push_back( nn );
     childChanged = childChanged || nn!=n[i];
   }
+  Node ret = n;
   if( n.getKind()==APPLY_UF ){
     Node op = n.getOperator();
     if( d_macro_defs.find( op )!=d_macro_defs.end() && !d_macro_defs[op].isNull() ){
+      //expand the macros used in the definition (definitions do not depend on each other cyclically)
+      if( d_macro_def_expanded.find( op )==d_macro_def_expanded.end() ){
+        d_macro_def_expanded[op] = true;
+        d_macro_defs[op] = Rewriter::rewrite( simplify( d_macro_defs[op] ) );
+      }
       //do subsitutition
-      Node ret = d_macro_defs[op];
+      ret = d_macro_defs[op];
       ret = ret.substitute( d_macro_basis[op].begin(), d_macro_basis[op].end(), children.begin(), children.end() );
-      return ret;
+      childChanged = false;
     }
   }
   if( childChanged ){
     if( n.getMetaKind() == kind::metakind::PARAMETERIZED ){
       children.insert( children.begin(), n.getOperator() );
     }
-    return NodeManager::currentNM()->mkNode( n.getKind(), children );
-  }else{
-    return n;
+    ret = NodeManager::currentNM()->mkNode( n.getKind(), children );
   }
+  d_simplify_cache[n] = ret;
+  return ret;
 }
@@ -30,9 +30,11 @@ namespace quantifiers {
 
 class QuantifierMacros{
 private:
-  void process( Node n, bool pol, std::vector< Node >& args, Node f );
+  void process( Node n, bool pol, std::vector< Node >& args, Node f, Node cond );
   bool contains( Node n, Node n_s );
+  bool containsQuantifier( Node n );
   bool containsBadOp( Node n, Node n_op );
+  bool containsOp( Node n, Node op );
   bool isMacroLiteral( Node n, bool pol );
   void getMacroCandidates( Node n, std::vector< Node >& candidates );
   Node solveInEquality( Node n, Node lit );
@@ -44,15 +46,26 @@ private:
   std::map< Node, std::vector< Node > > d_macro_basis;
   //map from operators to map from conditions to definition cases
   std::map< Node, std::vector< std::pair< Node, Node > > > d_macro_def_cases;
+  //map from operators to the quantifier their definition case comes from
+  std::map< Node, Node > d_macro_def_quant;
   //map from operators to macro definition
   std::map< Node, Node > d_macro_defs;
+  //operators whose definition has its macros expanded
+  std::map< Node, bool > d_macro_def_expanded;
+  //quantifiers that define a macro
+  std::map< Node, bool > d_macro_quants;
+  //number of quantifiers eliminated
+  int d_num_eliminated;
 private:
+  std::map< Node, Node > d_simplify_cache;
   Node simplify( Node n );
 public:
-  QuantifierMacros(){}
+  QuantifierMacros() : d_num_eliminated( 0 ){}
   ~QuantifierMacros(){}
 
   bool simplify( std::vector< Node >& assertions, bool doRewrite = false );
+  /** get the number of quantifiers eliminated by simplify */
+  int getNumEliminated() { return d_num_eliminated; }
 };
 
 }
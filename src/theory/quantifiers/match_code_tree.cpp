@@ -0,0 +1,268 @@
+/*********************                                                        */
+/*! \file match_code_tree.cpp
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Implementation of code tree for matching single triggers
+ **/
+
+#include "theory/quantifiers/match_code_tree.h"
+#include "theory/quantifiers/trigger.h"
+#include "theory/quantifiers/term_database.h"
+#include "theory/quantifiers/candidate_generator.h"
+#include "theory/quantifiers_engine.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::kind;
+using namespace CVC4::context;
+using namespace CVC4::theory;
+using namespace CVC4::theory::inst;
+
+MatchCodeTree::CodeNode::~CodeNode(){
+  for( int i=0; i<(int)d_children.size(); i++ ){
+    delete d_children[i].second;
+  }
+}
+
+bool MatchCodeTree::isCompilable( Node pat ){
+  if( !Trigger::isAtomicTrigger( pat ) ){
+    return false;
+  }
+  for( int i=0; i<(int)pat.getNumChildren(); i++ ){
+    if( pat[i].getKind()!=INST_CONSTANT && pat[i].hasAttribute(InstConstantAttribute()) ){
+      if( !isCompilable( pat[i] ) ){
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void MatchCodeTree::compile( Node n, int start, int& nregs, std::map< Node, int >& varReg,
+                             std::vector< Instruction >& code ){
+  //first, check the arguments that are variables or ground terms
+  for( int i=0; i<(int)n.getNumChildren(); i++ ){
+    if( n[i].getKind()==INST_CONSTANT ){
+      std::map< Node, int >::iterator it = varReg.find( n[i] );
+      if( it==varReg.end() ){
+        varReg[ n[i] ] = start + i;
+      }else{
+        code.push_back( Instruction( Instruction::COMPARE, start + i, it->second, Node::null() ) );
+      }
+    }else if( !n[i].hasAttribute(InstConstantAttribute()) ){
+      code.push_back( Instruction( Instruction::CHECK, start + i, 0, n[i] ) );
+    }
+  }
+  //then, bind the arguments that are nested patterns
+  for( int i=0; i<(int)n.getNumChildren(); i++ ){
+    if( n[i].getKind()!=INST_CONSTANT && n[i].hasAttribute(InstConstantAttribute()) ){
+      int cstart = nregs;
+      nregs += n[i].getNumChildren();
+      code.push_back( Instruction( Instruction::BIND, start + i, n[i].getNumChildren(), n[i].getOperator(), n[i].getType() ) );
+      compile( n[i], cstart, nregs, varReg, code );
+    }
+  }
+}
+
+int MatchCodeTree::addPattern( Node pat ){
+  std::map< Node, int >::iterator itp = d_pattern_id.find( pat );
+  if( itp!=d_pattern_id.end() ){
+    return itp->second;
+  }
+  Assert( isCompilable( pat ) );
+  std::vector< Instruction > code;
+  std::map< Node, int > varReg;
+  int nregs = pat.getNumChildren();
+  code.push_back( Instruction( Instruction::INIT, 0, pat.getNumChildren(), pat.getOperator(), pat.getType() ) );
+  compile( pat, 0, nregs, varReg, code );
+
+  //the cached matches against d_last_term do not include the new pattern
+  d_last_term = Node::null();
+  int id = (int)d_patterns.size();
+  d_pattern_id[pat] = id;
+  d_patterns.push_back( PatternInfo() );
+  PatternInfo& pi = d_patterns.back();
+  pi.d_stale = false;
+  for( std::map< Node, int >::iterator it = varReg.begin(); it != varReg.end(); ++it ){
+    pi.d_vars.push_back( it->first );
+    pi.d_regs.push_back( it->second );
+  }
+  //insert the code into the tree, sharing the longest existing prefix
+  CodeNode* cn = &d_root;
+  pi.d_path.push_back( cn );
+  for( int i=0; i<(int)code.size(); i++ ){
+    CodeNode* next = NULL;
+    for( int j=0; j<(int)cn->d_children.size(); j++ ){
+      if( cn->d_children[j].first==code[i] ){
+        next = cn->d_children[j].second;
+        break;
+      }
+    }
+    if( !next ){
+      next = new CodeNode;
+      cn->d_children.push_back( std::pair< Instruction, CodeNode* >( code[i], next ) );
+      ++(d_statistics.d_nodes);
+    }
+    cn = next;
+    pi.d_path.push_back( cn );
+  }
+  cn->d_yield.push_back( id );
+  ++(d_statistics.d_patterns);
+  Debug("match-code-tree") << "Compiled " << pat << " to " << code.size() << " instructions" << std::endl;
+  return id;
+}
+
+void MatchCodeTree::setStale( int id, bool stale ){
+  PatternInfo& pi = d_patterns[id];
+  if( pi.d_stale!=stale ){
+    pi.d_stale = stale;
+    for( int i=0; i<(int)pi.d_path.size(); i++ ){
+      pi.d_path[i]->d_numStale += stale ? 1 : -1;
+    }
+  }
+}
+
+bool MatchCodeTree::isCandidate( Node n, const Instruction& i ){
+  return n.getType()==i.d_type && CandidateGenerator::isLegalCandidate( n );
+}
+
+void MatchCodeTree::yield( CodeNode* node, bool onlyStale, bool termMatches ){
+  for( int i=0; i<(int)node->d_yield.size(); i++ ){
+    PatternInfo& pi = d_patterns[ node->d_yield[i] ];
+    if( !onlyStale || pi.d_stale ){
+      std::vector< Node > vals;
+      for( int j=0; j<(int)pi.d_regs.size(); j++ ){
+        vals.push_back( d_registers[ pi.d_regs[j] ] );
+      }
+      if( termMatches ){
+        pi.d_termMatches.push_back( vals );
+      }else{
+        pi.d_matches.push_back( vals );
+      }
+      ++(d_statistics.d_matches);
+    }
+  }
+}
+
+void MatchCodeTree::execute( CodeNode* node, bool onlyStale, bool termMatches ){
+  if( !node->d_yield.empty() ){
+    yield( node, onlyStale, termMatches );
+  }
+  for( int i=0; i<(int)node->d_children.size(); i++ ){
+    if( !onlyStale || node->d_children[i].second->d_numStale>0 ){
+      executeInstruction( node->d_children[i].first, node->d_children[i].second, onlyStale, termMatches );
+    }
+  }
+}
+
+void MatchCodeTree::executeInit( const Instruction& i, CodeNode* node, Node t, bool onlyStale, bool termMatches ){
+  Assert( d_registers.empty() );
+  ++(d_statistics.d_candidates);
+  for( int j=0; j<(int)t.getNumChildren(); j++ ){
+    d_registers.push_back( t[j] );
+  }
+  execute( node, onlyStale, termMatches );
+  d_registers.clear();
+}
+
+void MatchCodeTree::executeInstruction( const Instruction& i, CodeNode* node, bool onlyStale, bool termMatches ){
+  EqualityQuery* q = d_qe->getEqualityQuery();
+  if( i.d_kind==Instruction::INIT ){
+    std::vector< Node >& terms = d_qe->getTermDatabase()->d_op_map[ i.d_node ];
+    //terms added while matching are considered in the next round
+    int limit = (int)terms.size();
+    for( int j=0; j<limit; j++ ){
+      Node t = terms[j];
+      if( isCandidate( t, i ) ){
+        executeInit( i, node, t, onlyStale, termMatches );
+      }
+    }
+  }else if( i.d_kind==Instruction::BIND ){
+    std::vector< Node > eqc;
+    q->getEquivalenceClass( q->getRepresentative( d_registers[i.d_reg] ), eqc );
+    int nregs = (int)d_registers.size();
+    for( int j=0; j<(int)eqc.size(); j++ ){
+      Node n = eqc[j];
+      if( n.hasOperator() && n.getOperator()==i.d_node && isCandidate( n, i ) ){
+        ++(d_statistics.d_candidates);
+        for( int k=0; k<(int)n.getNumChildren(); k++ ){
+          d_registers.push_back( n[k] );
+        }
+        execute( node, onlyStale, termMatches );
+        d_registers.resize( nregs );
+      }
+    }
+  }else if( i.d_kind==Instruction::CHECK ){
+    if( q->areEqual( d_registers[i.d_reg], i.d_node ) ){
+      execute( node, onlyStale, termMatches );
+    }
+  }else{
+    Assert( i.d_kind==Instruction::COMPARE );
+    if( q->areEqual( d_registers[i.d_reg], d_registers[i.d_arg] ) ){
+      execute( node, onlyStale, termMatches );
+    }
+  }
+}
+
+std::vector< std::vector< Node > >& MatchCodeTree::getMatches( int id ){
+  if( d_patterns[id].d_stale ){
+    ++(d_statistics.d_runs);
+    for( int i=0; i<(int)d_patterns.size(); i++ ){
+      if( d_patterns[i].d_stale ){
+        d_patterns[i].d_matches.clear();
+      }
+    }
+    //one pass over the tree computes the matches of all stale patterns
+    execute( &d_root, true, false );
+    for( int i=0; i<(int)d_patterns.size(); i++ ){
+      setStale( i, false );
+    }
+  }
+  return d_patterns[id].d_matches;
+}
+
+std::vector< std::vector< Node > >& MatchCodeTree::getMatches( int id, Node t ){
+  if( t!=d_last_term ){
+    d_last_term = t;
+    for( int i=0; i<(int)d_patterns.size(); i++ ){
+      d_patterns[i].d_termMatches.clear();
+    }
+    //only run the code whose INIT instruction applies to t
+    for( int i=0; i<(int)d_root.d_children.size(); i++ ){
+      const Instruction& init = d_root.d_children[i].first;
+      if( t.hasOperator() && t.getOperator()==init.d_node && isCandidate( t, init ) ){
+        executeInit( init, d_root.d_children[i].second, t, false, true );
+      }
+    }
+  }
+  return d_patterns[id].d_termMatches;
+}
+
+MatchCodeTree::Statistics::Statistics():
+  d_patterns("MatchCodeTree::Patterns", 0),
+  d_nodes("MatchCodeTree::Nodes", 0),
+  d_runs("MatchCodeTree::Runs", 0),
+  d_candidates("MatchCodeTree::Candidates", 0),
+  d_matches("MatchCodeTree::Matches", 0)
+{
+  StatisticsRegistry::registerStat(&d_patterns);
+  StatisticsRegistry::registerStat(&d_nodes);
+  StatisticsRegistry::registerStat(&d_runs);
+  StatisticsRegistry::registerStat(&d_candidates);
+  StatisticsRegistry::registerStat(&d_matches);
+}
+
+MatchCodeTree::Statistics::~Statistics(){
+  StatisticsRegistry::unregisterStat(&d_patterns);
+  StatisticsRegistry::unregisterStat(&d_nodes);
+  StatisticsRegistry::unregisterStat(&d_runs);
+  StatisticsRegistry::unregisterStat(&d_candidates);
+  StatisticsRegistry::unregisterStat(&d_matches);
+}
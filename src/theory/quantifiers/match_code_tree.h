@@ -0,0 +1,168 @@
+/*********************                                                        */
+/*! \file match_code_tree.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief code tree for matching single triggers of all quantifiers at once
+ **
+ ** Each pattern is compiled to a sequence of instructions over a vector of
+ ** registers holding ground terms:
+ **   INIT( f, T, n )    : the candidate is a term f( t_1, ..., t_n ) of type T,
+ **                        t_1, ..., t_n are pushed to the registers,
+ **   BIND( r, g, T, n ) : for each term g( s_1, ..., s_n ) of type T in the
+ **                        equivalence class of register r, push s_1, ..., s_n,
+ **   CHECK( r, t )      : register r is equal to the ground term t,
+ **   COMPARE( r, s )    : registers r and s are equal.
+ ** A variable is bound to the register of its first occurrence, and later
+ ** occurrences are COMPAREd with it, so the code of a pattern does not
+ ** depend on the names of its variables. The code of all patterns is
+ ** stored in a trie, so patterns of different quantifiers that share a
+ ** prefix (e.g. f( x, g( y ) ) and f( z, g( a ) )) share its execution.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__QUANTIFIERS__MATCH_CODE_TREE_H
+#define __CVC4__THEORY__QUANTIFIERS__MATCH_CODE_TREE_H
+
+#include "expr/node.h"
+#include "expr/type_node.h"
+#include "util/statistics_registry.h"
+
+#include <map>
+#include <vector>
+
+namespace CVC4 {
+namespace theory {
+
+class QuantifiersEngine;
+
+namespace inst {
+
+class MatchCodeTree {
+public:
+  /** an instruction of the code tree */
+  class Instruction {
+  public:
+    enum {
+      INIT,
+      BIND,
+      CHECK,
+      COMPARE,
+    };
+    int d_kind;
+    /** the register this instruction reads (unused for INIT) */
+    int d_reg;
+    /** the register compared against (COMPARE) or the arity (INIT, BIND) */
+    int d_arg;
+    /** the operator (INIT, BIND) or the ground term (CHECK) */
+    Node d_node;
+    /** the type of the term (INIT, BIND) */
+    TypeNode d_type;
+    Instruction( int k, int r, int a, Node n, TypeNode tn = TypeNode::null() ) :
+      d_kind( k ), d_reg( r ), d_arg( a ), d_node( n ), d_type( tn ){}
+    bool operator==( const Instruction& i ) const {
+      return d_kind==i.d_kind && d_reg==i.d_reg && d_arg==i.d_arg && d_node==i.d_node && d_type==i.d_type;
+    }
+  };/* class MatchCodeTree::Instruction */
+private:
+  /** a node of the code tree */
+  class CodeNode {
+  public:
+    CodeNode() : d_numStale( 0 ){}
+    ~CodeNode();
+    /** the instructions that follow this one */
+    std::vector< std::pair< Instruction, CodeNode* > > d_children;
+    /** the patterns whose code ends here */
+    std::vector< int > d_yield;
+    /** number of stale patterns whose code goes through this node */
+    int d_numStale;
+  };
+  /** a pattern registered with the code tree */
+  class PatternInfo {
+  public:
+    /** the variables of the pattern */
+    std::vector< Node > d_vars;
+    /** the register bound to each variable */
+    std::vector< int > d_regs;
+    /** the code nodes on the path of the code of the pattern */
+    std::vector< CodeNode* > d_path;
+    /** whether the matches of this pattern are out of date */
+    bool d_stale;
+    /** the matches of the current round, as values for d_vars */
+    std::vector< std::vector< Node > > d_matches;
+    /** the matches against the last term given to getMatches */
+    std::vector< std::vector< Node > > d_termMatches;
+  };
+  /** the quantifiers engine */
+  QuantifiersEngine* d_qe;
+  /** the root of the code tree, its children are INIT instructions */
+  CodeNode d_root;
+  /** all registered patterns */
+  std::vector< PatternInfo > d_patterns;
+  /** the pattern ids, for patterns already registered */
+  std::map< Node, int > d_pattern_id;
+  /** the registers */
+  std::vector< Node > d_registers;
+  /** the last ground term given to getMatches, null if its matches are out of date */
+  Node d_last_term;
+  /** compile the arguments of pattern term n, stored from register start,
+      nregs is the number of registers used so far */
+  void compile( Node n, int start, int& nregs, std::map< Node, int >& varReg,
+                std::vector< Instruction >& code );
+  /** execute the code below node, record matches for stale patterns only if onlyStale */
+  void execute( CodeNode* node, bool onlyStale, bool termMatches );
+  /** execute instruction i, then the code below node */
+  void executeInstruction( const Instruction& i, CodeNode* node, bool onlyStale, bool termMatches );
+  /** execute INIT instruction i for candidate t, then the code below node */
+  void executeInit( const Instruction& i, CodeNode* node, Node t, bool onlyStale, bool termMatches );
+  /** record matches for the patterns ending at node */
+  void yield( CodeNode* node, bool onlyStale, bool termMatches );
+  /** mark pattern as stale */
+  void setStale( int id, bool stale );
+  /** whether we may match against term n */
+  bool isCandidate( Node n, const Instruction& i );
+public:
+  MatchCodeTree( QuantifiersEngine* qe ) : d_qe( qe ){}
+  ~MatchCodeTree(){}
+  /** whether pattern pat can be compiled to the code tree */
+  static bool isCompilable( Node pat );
+  /** add a pattern, return its id */
+  int addPattern( Node pat );
+  /** the matches of pattern id are out of date (call this each instantiation round) */
+  void resetPattern( int id ) { setStale( id, true ); d_last_term = Node::null(); }
+  /** compute the matches of all stale patterns in the current term database,
+      and return the ones for pattern id */
+  std::vector< std::vector< Node > >& getMatches( int id );
+  /** compute the matches of all patterns against ground term t,
+      and return the ones for pattern id.  The matches are cached for the last
+      term until the next call to resetPattern or addPattern */
+  std::vector< std::vector< Node > >& getMatches( int id, Node t );
+  /** get the variables of pattern id, in the order of the values of its matches */
+  std::vector< Node >& getVariables( int id ) { return d_patterns[id].d_vars; }
+public:
+  /** statistics class */
+  class Statistics {
+  public:
+    IntStat d_patterns;
+    IntStat d_nodes;
+    IntStat d_runs;
+    IntStat d_candidates;
+    IntStat d_matches;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+};/* class MatchCodeTree */
+
+}/* CVC4::theory::inst namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__QUANTIFIERS__MATCH_CODE_TREE_H */
@@ -179,6 +179,7 @@ int ModelEngine::checkModel( int checkOption ){
   d_testLemmas = 0;
   d_relevantLemmas = 0;
   d_totalLemmas = 0;
+  d_uf_value.clear();
   Trace("model-engine-debug") << "Do exhaustive instantiation..." << std::endl;
   for( int i=0; i<fm->getNumAssertedQuantifiers(); i++ ){
     Node f = fm->getAssertedQuantifier( i );
@@ -200,7 +201,29 @@ int ModelEngine::checkModel( int checkOption ){
     }
     //if we need to consider this quantifier on this iteration
     if( checkQuant ){
-      addedLemmas += exhaustiveInstantiate( f, optUseRelevantDomain() );
+      //if the model did not change for f since it was verified, f is still satisfied
+      std::vector< Node > sig;
+      bool useSig = options::fmfCacheVerified() && !optUseRelevantDomain() && computeSignature( f, sig );
+      if( useSig ){
+        std::map< Node, std::vector< Node > >::iterator itv = d_quant_verified.find( f );
+        if( itv!=d_quant_verified.end() && itv->second==sig ){
+          Trace("model-engine-debug") << "Skip verified quantifier " << f << std::endl;
+          ++(d_statistics.d_check_skipped);
+          continue;
+        }
+      }
+      bool prevIncomplete = d_incomplete_check;
+      d_incomplete_check = false;
+      int lems = exhaustiveInstantiate( f, optUseRelevantDomain() );
+      if( useSig ){
+        if( lems==0 && !d_incomplete_check ){
+          d_quant_verified[f] = sig;
+        }else{
+          d_quant_verified.erase( f );
+        }
+      }
+      d_incomplete_check = d_incomplete_check || prevIncomplete;
+      addedLemmas += lems;
       if( Trace.isOn("model-engine-warn") ){
         if( addedLemmas>10000 ){
           Debug("fmf-exit") << std::endl;
@@ -242,50 +265,57 @@ int ModelEngine::exhaustiveInstantiate( Node f, bool useRelInstDomain ){
     d_quantEngine->getModel()->resetEvaluate();
     int tests = 0;
     int triedLemmas = 0;
-    while( !riter.isFinished() && ( addedLemmas==0 || !optOneInstPerQuantRound() ) ){
-      d_testLemmas++;
-      int eval = 0;
-      int depIndex;
-      if( d_builder->optUseModel() ){
-        //see if instantiation is already true in current model
-        Debug("fmf-model-eval") << "Evaluating ";
-        riter.debugPrintSmall("fmf-model-eval");
-        Debug("fmf-model-eval") << "Done calculating terms." << std::endl;
-        tests++;
-        //if evaluate(...)==1, then the instantiation is already true in the model
-        //  depIndex is the index of the least significant variable that this evaluation relies upon
-        depIndex = riter.getNumTerms()-1;
-        eval = d_quantEngine->getModel()->evaluate( d_quantEngine->getTermDatabase()->getInstConstantBody( f ), depIndex, &riter );
+    if( d_builder->optUseModel() && options::fmfSymbolicEval() ){
+      //only enumerate the values of variables the interpretation depends on
+      std::vector< Node > vals;
+      vals.resize( f[0].getNumChildren() );
+      addedLemmas = symbolicInstantiate( f, &riter, vals, tests, triedLemmas );
+    }else{
+      while( !riter.isFinished() && ( addedLemmas==0 || !optOneInstPerQuantRound() ) ){
+        d_testLemmas++;
+        int eval = 0;
+        int depIndex;
+        if( d_builder->optUseModel() ){
+          //see if instantiation is already true in current model
+          Debug("fmf-model-eval") << "Evaluating ";
+          riter.debugPrintSmall("fmf-model-eval");
+          Debug("fmf-model-eval") << "Done calculating terms." << std::endl;
+          tests++;
+          //if evaluate(...)==1, then the instantiation is already true in the model
+          //  depIndex is the index of the least significant variable that this evaluation relies upon
+          depIndex = riter.getNumTerms()-1;
+          eval = d_quantEngine->getModel()->evaluate( d_quantEngine->getTermDatabase()->getInstConstantBody( f ), depIndex, &riter );
+          if( eval==1 ){
+            Debug("fmf-model-eval") << "  Returned success with depIndex = " << depIndex << std::endl;
+          }else{
+            Debug("fmf-model-eval") << "  Returned " << (eval==-1 ? "failure" : "unknown") << ", depIndex = " << depIndex << std::endl;
+          }
+        }
         if( eval==1 ){
-          Debug("fmf-model-eval") << "  Returned success with depIndex = " << depIndex << std::endl;
+          //instantiation is already true -> skip
+          riter.increment2( depIndex );
         }else{
-          Debug("fmf-model-eval") << "  Returned " << (eval==-1 ? "failure" : "unknown") << ", depIndex = " << depIndex << std::endl;
-        }
-      }
-      if( eval==1 ){
-        //instantiation is already true -> skip
-        riter.increment2( depIndex );
-      }else{
-        //instantiation was not shown to be true, construct the match
-        InstMatch m;
-        for( int i=0; i<riter.getNumTerms(); i++ ){
-          m.set( d_quantEngine->getTermDatabase()->getInstantiationConstant( f, riter.d_index_order[i] ), riter.getTerm( i ) );
-        }
-        Debug("fmf-model-eval") << "* Add instantiation " << m << std::endl;
-        triedLemmas++;
-        d_triedLemmas++;
-        //add as instantiation
-        if( d_quantEngine->addInstantiation( f, m ) ){
-          addedLemmas++;
-          //if the instantiation is show to be false, and we wish to skip multiple instantiations at once
-          if( eval==-1 && optExhInstEvalSkipMultiple() ){
-            riter.increment2( depIndex );
+          //instantiation was not shown to be true, construct the match
+          InstMatch m;
+          for( int i=0; i<riter.getNumTerms(); i++ ){
+            m.set( d_quantEngine->getTermDatabase()->getInstantiationConstant( f, riter.d_index_order[i] ), riter.getTerm( i ) );
+          }
+          Debug("fmf-model-eval") << "* Add instantiation " << m << std::endl;
+          triedLemmas++;
+          d_triedLemmas++;
+          //add as instantiation
+          if( d_quantEngine->addInstantiation( f, m ) ){
+            addedLemmas++;
+            //if the instantiation is show to be false, and we wish to skip multiple instantiations at once
+            if( eval==-1 && optExhInstEvalSkipMultiple() ){
+              riter.increment2( depIndex );
+            }else{
+              riter.increment();
+            }
           }else{
+            Debug("fmf-model-eval") << "* Failed Add instantiation " << m << std::endl;
             riter.increment();
           }
-        }else{
-          Debug("fmf-model-eval") << "* Failed Add instantiation " << m << std::endl;
-          riter.increment();
         }
       }
     }
@@ -320,6 +350,134 @@ int ModelEngine::exhaustiveInstantiate( Node f, bool useRelInstDomain ){
   return addedLemmas;
 }
 
+Node ModelEngine::getUfValue( FirstOrderModel* fm, Node op ){
+  std::map< Node, Node >::iterator it = d_uf_value.find( op );
+  if( it==d_uf_value.end() ){
+    Node val;
+    std::map< Node, uf::UfModelTree >::iterator itt = fm->d_uf_model_tree.find( op );
+    if( itt!=fm->d_uf_model_tree.end() ){
+      //use the same arguments each time, so that equal functions have equal values
+      if( d_uf_args.find( op )==d_uf_args.end() ){
+        TypeNode tn = op.getType();
+        for( int i=0; i<(int)tn.getNumChildren()-1; i++ ){
+          std::stringstream ss;
+          ss << "$x" << (i+1);
+          d_uf_args[op].push_back( NodeManager::currentNM()->mkBoundVar( ss.str(), tn[i] ) );
+        }
+      }
+      uf::UfModelTree tree = itt->second;
+      tree.update( fm );
+      val = tree.getFunctionValue( d_uf_args[op] );
+    }
+    d_uf_value[op] = val;
+    return val;
+  }else{
+    return it->second;
+  }
+}
+
+bool ModelEngine::computeSignature( Node f, std::vector< Node >& sig ){
+  FirstOrderModel* fm = d_quantEngine->getModel();
+  for( int i=0; i<(int)f[0].getNumChildren(); i++ ){
+    TypeNode tn = f[0][i].getType();
+    if( !tn.isSort() || !fm->d_rep_set.hasType( tn ) ){
+      return false;
+    }
+    std::vector< Node >& reps = fm->d_rep_set.d_type_reps[tn];
+    sig.insert( sig.end(), reps.begin(), reps.end() );
+    sig.push_back( Node::null() );
+  }
+  return computeSignature( fm, d_quantEngine->getTermDatabase()->getInstConstantBody( f ), sig );
+}
+
+bool ModelEngine::computeSignature( FirstOrderModel* fm, Node n, std::vector< Node >& sig ){
+  Kind k = n.getKind();
+  if( k==INST_CONSTANT ){
+    return true;
+  }else if( n.getNumChildren()==0 ){
+    sig.push_back( fm->getRepresentative( n ) );
+    return true;
+  }else if( k==APPLY_UF ){
+    Node val = getUfValue( fm, n.getOperator() );
+    if( val.isNull() ){
+      return false;
+    }
+    sig.push_back( val );
+  }else if( k!=NOT && k!=AND && k!=OR && k!=IMPLIES && k!=IFF && k!=XOR && k!=ITE && k!=EQUAL ){
+    //the evaluation of other terms is not determined by the signature
+    return false;
+  }
+  for( int i=0; i<(int)n.getNumChildren(); i++ ){
+    if( !computeSignature( fm, n[i], sig ) ){
+      return false;
+    }
+  }
+  return true;
+}
+
+int ModelEngine::symbolicInstantiate( Node f, RepSetIterator* riter, std::vector< Node >& vals, int& tests, int& triedLemmas ){
+  FirstOrderModel* fm = d_quantEngine->getModel();
+  d_testLemmas++;
+  tests++;
+  int splitVar = -1;
+  int eval = fm->evaluateSymbolic( d_quantEngine->getTermDatabase()->getInstConstantBody( f ), vals, splitVar );
+  Debug("fmf-model-eval") << "Symbolic evaluation returned " << eval << ", split on " << splitVar << std::endl;
+  if( eval==1 ){
+    //true for all values of the unassigned variables
+    ++(d_statistics.d_sym_eval_skipped);
+    return 0;
+  }
+  int unassigned = -1;
+  for( int i=0; i<(int)vals.size(); i++ ){
+    if( vals[i].isNull() ){
+      unassigned = i;
+      break;
+    }
+  }
+  if( eval==-1 || unassigned==-1 ){
+    //instantiate, using the first value in the domain for the unassigned variables
+    InstMatch m;
+    bool success = true;
+    for( int i=0; i<(int)vals.size(); i++ ){
+      Node t = vals[i];
+      if( t.isNull() ){
+        if( riter->d_domain[i].empty() ){
+          success = false;
+          break;
+        }
+        t = fm->d_rep_set.d_type_reps[ riter->d_types[i] ][ riter->d_domain[i][0] ];
+      }
+      m.set( d_quantEngine->getTermDatabase()->getInstantiationConstant( f, i ), t );
+    }
+    if( success ){
+      Debug("fmf-model-eval") << "* Add instantiation " << m << std::endl;
+      triedLemmas++;
+      d_triedLemmas++;
+      if( d_quantEngine->addInstantiation( f, m ) ){
+        return 1;
+      }
+    }
+    if( unassigned==-1 ){
+      return 0;
+    }
+    //the instantiation already exists, consider the other values
+  }
+  if( splitVar==-1 || !vals[splitVar].isNull() ){
+    splitVar = unassigned;
+  }
+  int addedLemmas = 0;
+  TypeNode tn = riter->d_types[splitVar];
+  for( int i=0; i<(int)riter->d_domain[splitVar].size(); i++ ){
+    vals[splitVar] = fm->d_rep_set.d_type_reps[tn][ riter->d_domain[splitVar][i] ];
+    addedLemmas += symbolicInstantiate( f, riter, vals, tests, triedLemmas );
+    if( addedLemmas>0 && optOneInstPerQuantRound() ){
+      break;
+    }
+  }
+  vals[splitVar] = Node::null();
+  return addedLemmas;
+}
+
 void ModelEngine::debugPrint( const char* c ){
   Trace( c ) << "Quantifiers: " << std::endl;
   for( int i=0; i<(int)d_quantEngine->getModel()->getNumAssertedQuantifiers(); i++ ){
@@ -341,7 +499,9 @@ ModelEngine::Statistics::Statistics():
   d_eval_uf_terms("ModelEngine::Eval_Uf_Terms", 0 ),
   d_eval_lits("ModelEngine::Eval_Lits", 0 ),
   d_eval_lits_unknown("ModelEngine::Eval_Lits_Unknown", 0 ),
-  d_exh_inst_lemmas("ModelEngine::Exhaustive_Instantiation_Lemmas", 0 )
+  d_exh_inst_lemmas("ModelEngine::Exhaustive_Instantiation_Lemmas", 0 ),
+  d_check_skipped("ModelEngine::Check_Skipped", 0 ),
+  d_sym_eval_skipped("ModelEngine::Symbolic_Eval_Skipped", 0 )
 {
   StatisticsRegistry::registerStat(&d_inst_rounds);
   StatisticsRegistry::registerStat(&d_eval_formulas);
@@ -349,6 +509,8 @@ ModelEngine::Statistics::Statistics():
   StatisticsRegistry::registerStat(&d_eval_lits);
   StatisticsRegistry::registerStat(&d_eval_lits_unknown);
   StatisticsRegistry::registerStat(&d_exh_inst_lemmas);
+  StatisticsRegistry::registerStat(&d_check_skipped);
+  StatisticsRegistry::registerStat(&d_sym_eval_skipped);
 }
 
 ModelEngine::Statistics::~Statistics(){
@@ -358,6 +520,8 @@ ModelEngine::Statistics::~Statistics(){
   StatisticsRegistry::unregisterStat(&d_eval_lits);
   StatisticsRegistry::unregisterStat(&d_eval_lits_unknown);
   StatisticsRegistry::unregisterStat(&d_exh_inst_lemmas);
+  StatisticsRegistry::unregisterStat(&d_check_skipped);
+  StatisticsRegistry::unregisterStat(&d_sym_eval_skipped);
 }
 
 
@@ -52,6 +52,23 @@ private:
   int checkModel( int checkOption );
   //exhaustively instantiate quantifier (possibly using mbqi), return number of lemmas produced
   int exhaustiveInstantiate( Node f, bool useRelInstDomain = false );
+  //instantiate f for the values of riter that extend vals (null for unassigned variables),
+  //  splitting on variables only where the model is not uniform
+  int symbolicInstantiate( Node f, RepSetIterator* riter, std::vector< Node >& vals, int& tests, int& triedLemmas );
+private:
+  //for each quantifier, the signature of the model it was last verified in
+  std::map< Node, std::vector< Node > > d_quant_verified;
+  //the function values of the uf models in the current round
+  std::map< Node, Node > d_uf_value;
+  //the arguments used for the function values of each uf
+  std::map< Node, std::vector< Node > > d_uf_args;
+  //get the function value of op in the current model
+  Node getUfValue( FirstOrderModel* fm, Node op );
+  //compute the signature of the model for quantifier f: the domains of its
+  //  variables, the function values of its ufs and the representatives of its
+  //  ground leaves. The evaluation of f only depends on this signature.
+  bool computeSignature( Node f, std::vector< Node >& sig );
+  bool computeSignature( FirstOrderModel* fm, Node n, std::vector< Node >& sig );
 private:
   //temporary statistics
   int d_triedLemmas;
@@ -79,6 +96,8 @@ public:
     IntStat d_eval_lits;
     IntStat d_eval_lits_unknown;
     IntStat d_exh_inst_lemmas;
+    IntStat d_check_skipped;
+    IntStat d_sym_eval_skipped;
     Statistics();
     ~Statistics();
   };
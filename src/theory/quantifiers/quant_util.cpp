@@ -22,6 +22,82 @@ using namespace CVC4::kind;
 using namespace CVC4::context;
 using namespace CVC4::theory;
 
+int BooleanEvaluator::evaluate( Node n, int& dep ){
+  d_numEvaluated++;
+  if( n.getKind()==NOT ){
+    return -evaluate( n[0], dep );
+  }else if( n.getKind()==OR || n.getKind()==AND || n.getKind()==IMPLIES ){
+    int baseVal = n.getKind()==AND ? 1 : -1;
+    int eVal = baseVal;
+    int allDep = -1;
+    int anyDep = -1;
+    int unknownDep = -1;
+    for( int i=0; i<(int)n.getNumChildren(); i++ ){
+      int childDep = -1;
+      int eValI = evaluate( n[i], childDep );
+      if( i==0 && n.getKind()==IMPLIES ){
+        eValI = -eValI;
+      }
+      if( eValI==-baseVal ){
+        //this child alone justifies the value
+        anyDep = eVal==-baseVal ? chooseDependency( anyDep, childDep ) : childDep;
+        eVal = -baseVal;
+        if( isBestDependency( anyDep ) ){
+          break;
+        }
+      }else if( eValI==baseVal ){
+        allDep = joinDependency( allDep, childDep );
+      }else{
+        if( eVal==baseVal ){
+          eVal = 0;
+        }
+        if( unknownDep==-1 ){
+          unknownDep = childDep;
+        }
+      }
+    }
+    dep = eVal==-baseVal ? anyDep : ( eVal==baseVal ? allDep : unknownDep );
+    return eVal;
+  }else if( n.getKind()==IFF || n.getKind()==XOR ){
+    int dep1 = -1;
+    int dep2 = -1;
+    int eVal1 = evaluate( n[0], dep1 );
+    int eVal2 = evaluate( n[1], dep2 );
+    if( eVal1==0 || eVal2==0 ){
+      dep = ( eVal1==0 && dep1!=-1 ) ? dep1 : dep2;
+      return 0;
+    }else{
+      dep = joinDependency( dep1, dep2 );
+      return ( eVal1==eVal2 )==( n.getKind()==IFF ) ? 1 : -1;
+    }
+  }else if( n.getKind()==ITE ){
+    int depC = -1;
+    int eValC = evaluate( n[0], depC );
+    if( eValC!=0 ){
+      int depB = -1;
+      int eValB = evaluate( n[ eValC==1 ? 1 : 2 ], depB );
+      dep = joinDependency( depC, depB );
+      return eValB;
+    }else{
+      //the value is known if both branches have the same value
+      int dep1 = -1;
+      int dep2 = -1;
+      int eVal1 = evaluate( n[1], dep1 );
+      int eVal2 = evaluate( n[2], dep2 );
+      if( eVal1!=0 && eVal1==eVal2 ){
+        dep = joinDependency( dep1, dep2 );
+        return eVal1;
+      }
+      dep = depC!=-1 ? depC : ( dep1!=-1 ? dep1 : dep2 );
+      return 0;
+    }
+  }else if( n.getKind()==FORALL ){
+    return 0;
+  }else{
+    return evaluateLiteral( n, dep );
+  }
+}
+
 void QuantRelevance::registerQuantifier( Node f ){
   //compute symbols in f
   std::vector< Node > syms;
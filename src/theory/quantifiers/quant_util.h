@@ -93,6 +93,35 @@ public:
   virtual void getEquivalenceClass( Node a, std::vector< Node >& eqc ) = 0;
 };/* class EqualityQuery */
 
+/** three-valued evaluation of the Boolean connectives NOT, AND, OR, IMPLIES,
+    IFF, XOR and ITE, where subclasses resolve the literals.  Values are 1
+    (true), -1 (false) and 0 (unknown).  Each value comes with a dependency,
+    an integer whose meaning is given by the subclass, -1 meaning none.  A
+    known value depends on joinDependency of the children it needs, or on
+    the best (see chooseDependency) of the children that each suffice.  An
+    unknown value depends on the first dependency of its unknown children.
+*/
+class BooleanEvaluator {
+protected:
+  /** the number of formulas evaluated */
+  int d_numEvaluated;
+  /** evaluate literal n */
+  virtual int evaluateLiteral( Node n, int& dep ) = 0;
+  /** the dependency of a value that needs both values with dependencies d1 and d2 */
+  virtual int joinDependency( int d1, int d2 ) { return d1!=-1 ? d1 : d2; }
+  /** the dependency of a value that either value with dependency d1 or d2 justifies */
+  virtual int chooseDependency( int d1, int d2 ) { return d1; }
+  /** whether no other justifying value can have a better dependency than d */
+  virtual bool isBestDependency( int d ) { return true; }
+public:
+  BooleanEvaluator() : d_numEvaluated( 0 ){}
+  virtual ~BooleanEvaluator(){}
+  /** evaluate n, dep is set to the dependency of its value */
+  int evaluate( Node n, int& dep );
+  /** get the number of formulas evaluated */
+  int getNumEvaluated() { return d_numEvaluated; }
+};/* class BooleanEvaluator */
+
 }
 }
 
@@ -33,20 +33,43 @@ using namespace CVC4::theory::inst;
 bool TermArgTrie::addTerm2( QuantifiersEngine* qe, Node n, int argIndex ){
   if( argIndex<(int)n.getNumChildren() ){
     Node r = qe->getEqualityQuery()->getRepresentative( n[ argIndex ] );
-    std::map< Node, TermArgTrie >::iterator it = d_data.find( r );
+    TrieMap::iterator it = d_data.find( r );
     if( it==d_data.end() ){
-      d_data[r].addTerm2( qe, n, argIndex+1 );
+      TermArgTrie* tat = new TermArgTrie;
+      d_data[r] = tat;
+      tat->addTerm2( qe, n, argIndex+1 );
       return true;
     }else{
-      return it->second.addTerm2( qe, n, argIndex+1 );
+      return it->second->addTerm2( qe, n, argIndex+1 );
     }
   }else{
     //store n in d_data (this should be interpretted as the "data" and not as a reference to a child)
-    d_data[n].d_data.clear();
+    if( d_data.find( n )==d_data.end() ){
+      d_data[n] = NULL;
+    }
     return false;
   }
 }
 
+Node TermArgTrie::existsTerm( std::vector< Node >& reps ){
+  TermArgTrie* tat = this;
+  for( int i=0; i<(int)reps.size(); i++ ){
+    TrieMap::iterator it = tat->d_data.find( reps[i] );
+    if( it==tat->d_data.end() ){
+      return Node::null();
+    }
+    tat = it->second;
+  }
+  return tat->d_data.empty() ? Node::null() : tat->d_data.begin()->first;
+}
+
+void TermArgTrie::clear(){
+  for( TrieMap::iterator it = d_data.begin(); it != d_data.end(); ++it ){
+    delete it->second;
+  }
+  d_data.clear();
+}
+
 void TermDb::addTermEfficient( Node n, std::set< Node >& added){
   static AvailableInTermDb aitdi;
   if (inst::Trigger::isAtomicTrigger( n ) && !n.getAttribute(aitdi)){
@@ -85,7 +108,8 @@ void TermDb::addTerm( Node n, std::set< Node >& added, bool withinQuant ){
           addTerm( n[i], added, withinQuant );
           if( options::efficientEMatching() ){
             EfficientEMatcher* eem = d_quantEngine->getEfficientEMatcher();
-            if( d_parents[n[i]][op].empty() ){
+            const std::vector< Node >& pops = getParentOps( n[i] );
+            if( std::find( pops.begin(), pops.end(), op )==pops.end() ){
               //must add parent to equivalence class info
               Node nir = d_quantEngine->getEqualityQuery()->getRepresentative( n[i] );
               EqClassInfo* eci_nir = eem->getEquivalenceClassInfo( nir );
@@ -94,10 +118,8 @@ void TermDb::addTerm( Node n, std::set< Node >& added, bool withinQuant ){
               }
             }
             //add to parent structure
-            if( std::find( d_parents[n[i]][op][i].begin(), d_parents[n[i]][op][i].end(), n )==d_parents[n[i]][op][i].end() ){
-              d_parents[n[i]][op][i].push_back( n );
-              Assert(!getParents(n[i],op,i).empty());
-            }
+            addParent( n, i );
+            Assert(!getParents(n[i],op,i).empty());
           }
           if( options::eagerInstQuant() ){
             if( !n.hasAttribute(InstLevelAttribute()) && n.getAttribute(InstLevelAttribute())==0 ){
@@ -131,14 +153,14 @@ void TermDb::addTerm( Node n, std::set< Node >& added, bool withinQuant ){
    int congruentCount = 0;
    int alreadyCongruentCount = 0;
    //rebuild d_func/pred_map_trie for each operation, this will calculate all congruent terms
-   for( std::map< Node, std::vector< Node > >::iterator it = d_op_map.begin(); it != d_op_map.end(); ++it ){
+   for( OpMap::iterator it = d_op_map.begin(); it != d_op_map.end(); ++it ){
      d_op_count[ it->first ] = 0;
      if( !it->second.empty() ){
        if( it->second[0].getType().isBoolean() ){
-         d_pred_map_trie[ 0 ][ it->first ].d_data.clear();
-         d_pred_map_trie[ 1 ][ it->first ].d_data.clear();
+         d_pred_map_trie[ 0 ][ it->first ].clear();
+         d_pred_map_trie[ 1 ][ it->first ].clear();
        }else{
-         d_func_map_trie[ it->first ].d_data.clear();
+         d_func_map_trie[ it->first ].clear();
          for( int i=0; i<(int)it->second.size(); i++ ){
            Node n = it->second[i];
            computeModelBasisArgAttribute( n );
@@ -393,19 +415,35 @@ Node TermDb::getFreeVariableForInstConstant( Node n ){
   return d_free_vars[tn];
 }
 
-const std::vector<Node> & TermDb::getParents(TNode n, TNode f, int arg){
-  std::hash_map< Node, std::hash_map< Node, std::hash_map< int, std::vector< Node > >,NodeHashFunction  >,NodeHashFunction  >::const_iterator
-    rn = d_parents.find( n );
-  if( rn !=d_parents.end() ){
-    std::hash_map< Node, std::hash_map< int, std::vector< Node > > , NodeHashFunction  > ::const_iterator
-      rf = rn->second.find(f);
-    if( rf != rn->second.end() ){
-      std::hash_map< int, std::vector< Node > > ::const_iterator
-        ra = rf->second.find(arg);
-      if( ra != rf->second.end() ){
-        return ra->second;
+void TermDb::addParent( Node p, int index ){
+  Node n = p[index];
+  Node op = p.getOperator();
+  std::vector< Node >& parents = d_parents[ ParentKey( n, op, index ) ];
+  if( std::find( parents.begin(), parents.end(), p )==parents.end() ){
+    if( parents.empty() ){
+      std::vector< Node >& ops = d_parent_ops[n];
+      if( std::find( ops.begin(), ops.end(), op )==ops.end() ){
+        ops.push_back( op );
       }
     }
+    parents.push_back( p );
+  }
+}
+
+const std::vector<Node> & TermDb::getParents(TNode n, TNode f, int arg){
+  std::hash_map< ParentKey, std::vector< Node >, ParentKeyHashFunction >::const_iterator
+    it = d_parents.find( ParentKey( n, f, arg ) );
+  if( it != d_parents.end() ){
+    return it->second;
+  }
+  static std::vector<Node> empty;
+  return empty;
+}
+
+const std::vector<Node> & TermDb::getParentOps(TNode n){
+  std::hash_map< Node, std::vector< Node >, NodeHashFunction >::const_iterator it = d_parent_ops.find( n );
+  if( it != d_parent_ops.end() ){
+    return it->second;
   }
   static std::vector<Node> empty;
   return empty;
@@ -18,6 +18,7 @@
 #define __CVC4__THEORY__QUANTIFIERS__TERM_DATABASE_H
 
 #include "theory/theory.h"
+#include "util/hash.h"
 
 #include <map>
 
@@ -75,11 +76,22 @@ namespace quantifiers {
 class TermArgTrie {
 private:
   bool addTerm2( QuantifiersEngine* qe, Node n, int argIndex );
+  TermArgTrie& operator=( const TermArgTrie& t );
 public:
-  /** the data */
-  std::map< Node, TermArgTrie > d_data;
+  typedef std::hash_map< Node, TermArgTrie*, NodeHashFunction > TrieMap;
+  /** the data, indexed by the representatives of the arguments.
+      At the last argument, the terms themselves are stored with no child. */
+  TrieMap d_data;
 public:
+  TermArgTrie(){}
+  /** only empty tries are copied (when they are inserted in a map) */
+  TermArgTrie( const TermArgTrie& t ){ Assert( t.d_data.empty() ); }
+  ~TermArgTrie(){ clear(); }
+  /** clear the trie */
+  void clear();
   bool addTerm( QuantifiersEngine* qe, Node n ) { return addTerm2( qe, n, 0 ); }
+  /** get a term whose arguments have representatives reps, or null if none exists */
+  Node existsTerm( std::vector< Node >& reps );
 };/* class TermArgTrie */
 
 
@@ -95,14 +107,16 @@ private:
 public:
   TermDb( QuantifiersEngine* qe ) : d_quantEngine( qe ){}
   ~TermDb(){}
+  typedef std::hash_map< Node, std::vector< Node >, NodeHashFunction > OpMap;
+  typedef std::hash_map< Node, TermArgTrie, NodeHashFunction > OpTrieMap;
   /** map from APPLY_UF operators to ground terms for that operator */
-  std::map< Node, std::vector< Node > > d_op_map;
+  OpMap d_op_map;
   /** count number of APPLY_UF terms per operator */
-  std::map< Node, int > d_op_count;
+  std::hash_map< Node, int, NodeHashFunction > d_op_count;
   /** map from APPLY_UF functions to trie */
-  std::map< Node, TermArgTrie > d_func_map_trie;
+  OpTrieMap d_func_map_trie;
   /** map from APPLY_UF predicates to trie */
-  std::map< Node, TermArgTrie > d_pred_map_trie[2];
+  OpTrieMap d_pred_map_trie[2];
   /** map from type nodes to terms of that type */
   std::map< TypeNode, std::vector< Node > > d_type_map;
   /** add a term to the database */
@@ -112,16 +126,40 @@ public:
 private:
   /** for efficient e-matching */
   void addTermEfficient( Node n, std::set< Node >& added);
-public:
+  /** key ( n, op, index ) of the parent structure */
+  class ParentKey {
+  public:
+    Node d_n;
+    Node d_op;
+    int d_index;
+    ParentKey( Node n, Node op, int index ) : d_n( n ), d_op( op ), d_index( index ){}
+    bool operator==( const ParentKey& k ) const {
+      return d_n==k.d_n && d_op==k.d_op && d_index==k.d_index;
+    }
+  };
+  struct ParentKeyHashFunction {
+    size_t operator()( const ParentKey& k ) const {
+      size_t hash = 0x9e3779b9 + NodeHashFunction()( k.d_n );
+      hash ^= 0x9e3779b9 + NodeHashFunction()( k.d_op ) + (hash << 6) + (hash >> 2);
+      hash ^= 0x9e3779b9 + k.d_index + (hash << 6) + (hash >> 2);
+      return hash;
+    }
+  };
   /** parent structure (for efficient E-matching):
-      n -> op -> index -> L
-      map from node "n" to a list of nodes "L", where each node n' in L
+      ( n, op, index ) -> L
+      map to a list of nodes "L", where each node n' in L
         has operator "op", and n'["index"] = n.
-      for example, d_parents[n][f][1] = { f( t1, n ), f( t2, n ), ... }
+      for example, d_parents[( n, f, 1 )] = { f( t1, n ), f( t2, n ), ... }
   */
-  /* Todo replace int by size_t */
-  std::hash_map< Node, std::hash_map< Node, std::hash_map< int, std::vector< Node >  >, NodeHashFunction  > , NodeHashFunction > d_parents;
+  std::hash_map< ParentKey, std::vector< Node >, ParentKeyHashFunction > d_parents;
+  /** map from node n to the operators of its parents */
+  std::hash_map< Node, std::vector< Node >, NodeHashFunction > d_parent_ops;
+  /** add p as a parent of p[index] */
+  void addParent( Node p, int index );
+public:
   const std::vector<Node> & getParents(TNode n, TNode f, int arg);
+  /** get the operators of the parents of n */
+  const std::vector<Node> & getParentOps(TNode n);
 
 //for model basis
 private:
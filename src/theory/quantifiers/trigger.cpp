@@ -20,6 +20,7 @@
 #include "theory/quantifiers/options.h"
 #include "theory/quantifiers/term_database.h"
 #include "theory/quantifiers/inst_match_generator.h"
+#include "theory/quantifiers/match_code_tree.h"
 
 using namespace std;
 using namespace CVC4;
@@ -34,7 +35,11 @@ using namespace CVC4::theory::inst;
 Trigger::Trigger( QuantifiersEngine* qe, Node f, std::vector< Node >& nodes, int matchOption, bool smartTriggers ) :
 d_quantEngine( qe ), d_f( f ){
   d_nodes.insert( d_nodes.begin(), nodes.begin(), nodes.end() );
-  if( smartTriggers ){
+  if( options::quantCodeTree() && d_nodes.size()==1 && !qe->d_optMatchIgnoreModelBasis &&
+      MatchCodeTree::isCompilable( d_nodes[0] ) && !( smartTriggers && isSimpleTrigger( d_nodes[0] ) ) ){
+    //match in the code tree shared with the triggers of the other quantifiers
+    d_mg = new InstMatchGeneratorCodeTree( d_nodes[0], qe );
+  }else if( smartTriggers ){
     if( d_nodes.size()==1 ){
       if( isSimpleTrigger( d_nodes[0] ) ){
         d_mg = new InstMatchGeneratorSimple( f, d_nodes[0] );
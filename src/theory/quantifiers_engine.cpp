@@ -25,6 +25,8 @@
 #include "theory/quantifiers/first_order_model.h"
 #include "theory/quantifiers/term_database.h"
 #include "theory/quantifiers/trigger.h"
+#include "theory/quantifiers/match_code_tree.h"
+#include "theory/quantifiers/inst_scheduler.h"
 #include "theory/rewriterules/efficient_e_matching.h"
 #include "theory/rewriterules/rr_trigger.h"
 
@@ -41,9 +43,13 @@ d_quant_rel( false ){ //currently do not care about relevance
   d_eq_query = new EqualityQueryQuantifiersEngine( this );
   d_term_db = new quantifiers::TermDb( this );
   d_tr_trie = new inst::TriggerTrie;
+  d_code_tree = new inst::MatchCodeTree( this );
   d_rr_tr_trie = new rrinst::TriggerTrie;
   d_eem = new EfficientEMatcher( this );
   d_hasAddedLemma = false;
+  d_inst_sched = new quantifiers::InstScheduler( this );
+  d_num_sched_sent = 0;
+  d_inst_batch_active = false;
 
   //the model object
   d_model = new quantifiers::FirstOrderModel( c, "FirstOrderModel" );
@@ -76,6 +82,8 @@ QuantifiersEngine::~QuantifiersEngine(){
   delete d_model_engine;
   delete d_inst_engine;
   delete d_model;
+  delete d_code_tree;
+  delete d_inst_sched;
   delete d_term_db;
   delete d_eq_query;
 }
@@ -118,6 +126,7 @@ void QuantifiersEngine::check( Theory::Effort e ){
     Trace("quant-engine") << "Quantifiers Engine check, level = " << e << std::endl;
     //reset relevant information
     d_hasAddedLemma = false;
+    d_num_sched_sent = 0;
     d_term_db->reset( e );
     d_eq_query->reset();
     if( e==Theory::EFFORT_LAST_CALL ){
@@ -235,40 +244,49 @@ bool QuantifiersEngine::addInstantiation( Node f, std::vector< Node >& vars, std
   NodeBuilder<> nb(kind::OR);
   nb << f.notNode() << body;
   Node lem = nb;
-  //check for duplication
-  if( addLemma( lem ) ){
-    Trace("inst") << "*** Instantiate " << f << " with " << std::endl;
-    uint64_t maxInstLevel = 0;
-    for( int i=0; i<(int)terms.size(); i++ ){
-      if( terms[i].hasAttribute(InstConstantAttribute()) ){
-        Debug("inst")<< "***& Bad Instantiate " << f << " with " << std::endl;
-        for( int i=0; i<(int)terms.size(); i++ ){
-          Debug("inst") << "   " << terms[i] << std::endl;
-        }
-        Unreachable("Bad instantiation");
-      }else{
-        Trace("inst") << "   " << terms[i];
-        //Debug("inst-engine") << " " << terms[i].getAttribute(InstLevelAttribute());
-        Trace("inst") << std::endl;
-        if( terms[i].hasAttribute(InstLevelAttribute()) ){
-          if( terms[i].getAttribute(InstLevelAttribute())>maxInstLevel ){
-            maxInstLevel = terms[i].getAttribute(InstLevelAttribute());
-          }
-        }else{
-          setInstantiationLevelAttr( terms[i], 0 );
-        }
+  for( int i=0; i<(int)terms.size(); i++ ){
+    if( terms[i].hasAttribute(InstConstantAttribute()) ){
+      Debug("inst")<< "***& Bad Instantiate " << f << " with " << std::endl;
+      for( int i=0; i<(int)terms.size(); i++ ){
+        Debug("inst") << "   " << terms[i] << std::endl;
       }
+      Unreachable("Bad instantiation");
     }
+  }
+  //check for duplication
+  if( options::instBudget()>0 ){
+    //the instantiation is recorded when the scheduler sends it, in flushLemmas
+    if( addScheduledLemma( lem, f, body, terms ) ){
+      return true;
+    }
+  }else if( addLemma( lem ) ){
     Trace("inst-debug") << "*** Lemma is " << lem << std::endl;
-    setInstantiationLevelAttr( body, maxInstLevel+1 );
-    ++(d_statistics.d_instantiations);
-    d_statistics.d_total_inst_var += (int)terms.size();
-    d_statistics.d_max_instantiation_level.maxAssign( maxInstLevel+1 );
+    recordInstantiation( f, body, terms );
     return true;
-  }else{
-    ++(d_statistics.d_inst_duplicate);
-    return false;
   }
+  ++(d_statistics.d_inst_duplicate);
+  return false;
+}
+
+void QuantifiersEngine::recordInstantiation( Node f, Node body, std::vector< Node >& terms ){
+  Trace("inst") << "*** Instantiate " << f << " with " << std::endl;
+  uint64_t maxInstLevel = 0;
+  for( int i=0; i<(int)terms.size(); i++ ){
+    Trace("inst") << "   " << terms[i];
+    //Debug("inst-engine") << " " << terms[i].getAttribute(InstLevelAttribute());
+    Trace("inst") << std::endl;
+    if( terms[i].hasAttribute(InstLevelAttribute()) ){
+      if( terms[i].getAttribute(InstLevelAttribute())>maxInstLevel ){
+        maxInstLevel = terms[i].getAttribute(InstLevelAttribute());
+      }
+    }else{
+      setInstantiationLevelAttr( terms[i], 0 );
+    }
+  }
+  setInstantiationLevelAttr( body, maxInstLevel+1 );
+  ++(d_statistics.d_instantiations);
+  d_statistics.d_total_inst_var += (int)terms.size();
+  d_statistics.d_max_instantiation_level.maxAssign( maxInstLevel+1 );
 }
 
 void QuantifiersEngine::setInstantiationLevelAttr( Node n, uint64_t level ){
@@ -308,8 +326,10 @@ Node QuantifiersEngine::getInstantiation( Node f, InstMatch& m ){
 }
 
 bool QuantifiersEngine::existsInstantiation( Node f, InstMatch& m, bool modEq, bool modInst ){
-  if( d_inst_match_trie.find( f )!=d_inst_match_trie.end() ){
-    if( d_inst_match_trie[f].existsInstMatch( this, f, m, modEq, modInst ) ){
+  //the instantiations added are complete, so modInst never applies to them
+  std::map< Node, inst::InstMatchSet >::iterator it = d_inst_match_set.find( f );
+  if( it!=d_inst_match_set.end() ){
+    if( it->second.existsInstMatch( this, f, m, modEq ) ){
       return true;
     }
   }
@@ -335,6 +355,17 @@ bool QuantifiersEngine::addLemma( Node lem ){
   }
 }
 
+bool QuantifiersEngine::addScheduledLemma( Node lem, Node f, Node body, std::vector< Node >& terms ){
+  lem = Rewriter::rewrite(lem);
+  if( d_lemmas_produced.find( lem )==d_lemmas_produced.end() ){
+    d_lemmas_produced[ lem ] = true;
+    d_inst_sched->addLemma( lem, f, body, terms );
+    return true;
+  }else{
+    return false;
+  }
+}
+
 bool QuantifiersEngine::addInstantiation( Node f, InstMatch& m, bool modEq, bool modInst, bool mkRep ){
   Trace("inst-add-debug") << "Add instantiation: " << m << std::endl;
   //make sure there are values for each variable we are instantiating
@@ -354,8 +385,27 @@ bool QuantifiersEngine::addInstantiation( Node f, InstMatch& m, bool modEq, bool
       m.set( ic, r );
     }
   }
+  if( d_inst_batch_active ){
+    //only read the instantiations added so far, the batch is committed later
+    if( d_inst_match_set[f].existsInstMatch( this, f, m, modEq ) ||
+        !d_inst_batch_set[f].addInstMatch( this, f, m, modEq ) ){
+      Trace("inst-add-debug") << " -> Already exists." << std::endl;
+      ++(d_statistics.d_inst_duplicate);
+      return false;
+    }
+    if( d_inst_batch.find( f )==d_inst_batch.end() ){
+      d_inst_batch_quants.push_back( f );
+    }
+    d_inst_batch[f].push_back( std::pair< InstMatch, bool >( m, modEq ) );
+    Trace("inst-add-debug") << " -> Added to batch." << std::endl;
+    return true;
+  }
+  return commitInstantiation( f, m, modEq );
+}
+
+bool QuantifiersEngine::commitInstantiation( Node f, InstMatch& m, bool modEq ){
   //check for duplication modulo equality
-  if( !d_inst_match_trie[f].addInstMatch( this, f, m, modEq, modInst ) ){
+  if( !d_inst_match_set[f].addInstMatch( this, f, m, modEq ) ){
     Trace("inst-add-debug") << " -> Already exists." << std::endl;
     ++(d_statistics.d_inst_duplicate);
     return false;
@@ -381,6 +431,157 @@ bool QuantifiersEngine::addInstantiation( Node f, InstMatch& m, bool modEq, bool
   }
 }
 
+void QuantifiersEngine::beginInstantiationBatch(){
+  Assert( !d_inst_batch_active );
+  d_inst_batch_active = true;
+}
+
+int QuantifiersEngine::commitInstantiationBatch(){
+  Assert( d_inst_batch_active );
+  d_inst_batch_active = false;
+  //if any instantiation is in conflict or propagates, only add those
+  std::map< Node, std::vector< bool > > useInst;
+  bool filter = false;
+  if( options::instConflictFirst() ){
+    for( int i=0; i<(int)d_inst_batch_quants.size(); i++ ){
+      Node f = d_inst_batch_quants[i];
+      std::vector< std::pair< InstMatch, bool > >& batch = d_inst_batch[f];
+      for( int j=0; j<(int)batch.size(); j++ ){
+        int status = getInstantiationStatus( f, batch[j].first );
+        if( status==inst_status_conflict ){
+          ++(d_statistics.d_inst_conflict);
+        }else if( status==inst_status_propagate ){
+          ++(d_statistics.d_inst_propagate);
+        }
+        useInst[f].push_back( status!=inst_status_other );
+        filter = filter || status!=inst_status_other;
+      }
+    }
+    Trace("inst-conflict") << "Instantiation batch has conflicting/propagating instances : " << filter << std::endl;
+  }
+  int addedLemmas = 0;
+  for( int i=0; i<(int)d_inst_batch_quants.size(); i++ ){
+    Node f = d_inst_batch_quants[i];
+    std::vector< std::pair< InstMatch, bool > >& batch = d_inst_batch[f];
+    for( int j=0; j<(int)batch.size(); j++ ){
+      if( !filter || useInst[f][j] ){
+        if( commitInstantiation( f, batch[j].first, batch[j].second ) ){
+          addedLemmas++;
+        }
+      }
+    }
+  }
+  d_statistics.d_inst_batch_max.maxAssign( addedLemmas );
+  d_inst_batch_quants.clear();
+  d_inst_batch.clear();
+  d_inst_batch_set.clear();
+  return addedLemmas;
+}
+
+int QuantifiersEngine::getInstantiationStatus( Node f, InstMatch& m ){
+  Node body = getInstantiation( f, m );
+  int eval = evaluate( body );
+  if( eval==-1 ){
+    Trace("inst-conflict") << "Conflicting instance : " << body << std::endl;
+    return inst_status_conflict;
+  }else if( eval==0 ){
+    //the instance propagates if it is an unknown literal,
+    // or a clause whose disjuncts are all false but one unknown literal
+    if( isLiteral( body ) ){
+      return inst_status_propagate;
+    }else if( body.getKind()==OR ){
+      int numUnknown = 0;
+      for( int i=0; i<(int)body.getNumChildren(); i++ ){
+        int evalc = evaluate( body[i] );
+        if( evalc==0 ){
+          if( !isLiteral( body[i] ) ){
+            return inst_status_other;
+          }
+          numUnknown++;
+        }else if( evalc==1 ){
+          return inst_status_other;
+        }
+      }
+      if( numUnknown==1 ){
+        return inst_status_propagate;
+      }
+    }
+  }
+  return inst_status_other;
+}
+
+bool QuantifiersEngine::isLiteral( Node n ){
+  Node atom = n.getKind()==NOT ? n[0] : n;
+  Kind k = atom.getKind();
+  return k!=NOT && k!=AND && k!=OR && k!=IMPLIES && k!=IFF && k!=XOR && k!=ITE;
+}
+
+Node QuantifiersEngine::getEvaluatedRepresentative( Node n ){
+  EqualityQuery* q = getEqualityQuery();
+  if( q->hasTerm( n ) ){
+    return q->getRepresentative( n );
+  }else if( n.getKind()==APPLY_UF ){
+    //look for a congruent term in the term database
+    std::vector< Node > reps;
+    for( int i=0; i<(int)n.getNumChildren(); i++ ){
+      Node r = getEvaluatedRepresentative( n[i] );
+      if( r.isNull() ){
+        return r;
+      }
+      reps.push_back( r );
+    }
+    Node op = n.getOperator();
+    if( n.getType().isBoolean() ){
+      for( int i=0; i<2; i++ ){
+        quantifiers::TermDb::OpTrieMap::iterator it = d_term_db->d_pred_map_trie[i].find( op );
+        if( it!=d_term_db->d_pred_map_trie[i].end() && !it->second.existsTerm( reps ).isNull() ){
+          return q->getRepresentative( NodeManager::currentNM()->mkConst( i==1 ) );
+        }
+      }
+    }else{
+      quantifiers::TermDb::OpTrieMap::iterator it = d_term_db->d_func_map_trie.find( op );
+      if( it!=d_term_db->d_func_map_trie.end() ){
+        Node t = it->second.existsTerm( reps );
+        if( !t.isNull() ){
+          return q->getRepresentative( t );
+        }
+      }
+    }
+  }
+  return Node::null();
+}
+
+int QuantifiersEngine::evaluate( Node n ){
+  GroundEvaluator ev( this );
+  int dep = -1;
+  return ev.evaluate( n, dep );
+}
+
+int QuantifiersEngine::evaluateLiteral( Node n ){
+  if( n.getKind()==EQUAL ){
+    Node r1 = getEvaluatedRepresentative( n[0] );
+    Node r2 = getEvaluatedRepresentative( n[1] );
+    if( !r1.isNull() && !r2.isNull() ){
+      if( r1==r2 ){
+        return 1;
+      }else if( getEqualityQuery()->areDisequal( r1, r2 ) ){
+        return -1;
+      }
+    }
+    return 0;
+  }else{
+    Node r = getEvaluatedRepresentative( n );
+    if( !r.isNull() ){
+      if( getEqualityQuery()->areEqual( r, NodeManager::currentNM()->mkConst( true ) ) ){
+        return 1;
+      }else if( getEqualityQuery()->areEqual( r, NodeManager::currentNM()->mkConst( false ) ) ){
+        return -1;
+      }
+    }
+    return 0;
+  }
+}
+
 bool QuantifiersEngine::addSplit( Node n, bool reqPhase, bool reqPhasePol ){
   n = Rewriter::rewrite( n );
   Node lem = NodeManager::currentNM()->mkNode( OR, n, n.notNode() );
@@ -416,6 +617,23 @@ void QuantifiersEngine::flushLemmas( OutputChannel* out ){
     }
     d_lemmas_waiting.clear();
   }
+  //send the best scheduled instantiations, within the budget for this round
+  if( out && !d_inst_sched->empty() && d_num_sched_sent<options::instBudget() ){
+    std::vector< quantifiers::InstScheduler::ScheduledLemma > lemmas;
+    d_inst_sched->getLemmas( options::instBudget()-d_num_sched_sent, lemmas );
+    d_num_sched_sent += (int)lemmas.size();
+    d_hasAddedLemma = true;
+    for( int i=0; i<(int)lemmas.size(); i++ ){
+      Trace("inst-debug") << "*** Lemma is " << lemmas[i].d_lemma << std::endl;
+      recordInstantiation( lemmas[i].d_f, lemmas[i].d_body, lemmas[i].d_terms );
+      out->lemma( lemmas[i].d_lemma );
+    }
+  }
+}
+
+bool QuantifiersEngine::hasAddedLemma(){
+  //scheduled lemmas will be sent when the lemmas are flushed
+  return !d_lemmas_waiting.empty() || d_hasAddedLemma || !d_inst_sched->empty();
 }
 
 void QuantifiersEngine::getPhaseReqTerms( Node f, std::vector< Node >& nodes ){
@@ -507,6 +725,9 @@ QuantifiersEngine::Statistics::Statistics():
   d_total_inst_var_unspec("QuantifiersEngine::Vars_Inst_Unspecified", 0),
   d_inst_unspec("QuantifiersEngine::Unspecified_Inst", 0),
   d_inst_duplicate("QuantifiersEngine::Duplicate_Inst", 0),
+  d_inst_batch_max("QuantifiersEngine::Max_Inst_Batch", 0),
+  d_inst_conflict("QuantifiersEngine::Inst_Conflict", 0),
+  d_inst_propagate("QuantifiersEngine::Inst_Propagate", 0),
   d_lit_phase_req("QuantifiersEngine::lit_phase_req", 0),
   d_lit_phase_nreq("QuantifiersEngine::lit_phase_nreq", 0),
   d_triggers("QuantifiersEngine::Triggers", 0),
@@ -532,6 +753,9 @@ QuantifiersEngine::Statistics::Statistics():
   StatisticsRegistry::registerStat(&d_total_inst_var_unspec);
   StatisticsRegistry::registerStat(&d_inst_unspec);
   StatisticsRegistry::registerStat(&d_inst_duplicate);
+  StatisticsRegistry::registerStat(&d_inst_batch_max);
+  StatisticsRegistry::registerStat(&d_inst_conflict);
+  StatisticsRegistry::registerStat(&d_inst_propagate);
   StatisticsRegistry::registerStat(&d_lit_phase_req);
   StatisticsRegistry::registerStat(&d_lit_phase_nreq);
   StatisticsRegistry::registerStat(&d_triggers);
@@ -559,6 +783,9 @@ QuantifiersEngine::Statistics::~Statistics(){
   StatisticsRegistry::unregisterStat(&d_total_inst_var_unspec);
   StatisticsRegistry::unregisterStat(&d_inst_unspec);
   StatisticsRegistry::unregisterStat(&d_inst_duplicate);
+  StatisticsRegistry::unregisterStat(&d_inst_batch_max);
+  StatisticsRegistry::unregisterStat(&d_inst_conflict);
+  StatisticsRegistry::unregisterStat(&d_inst_propagate);
   StatisticsRegistry::unregisterStat(&d_lit_phase_req);
   StatisticsRegistry::unregisterStat(&d_lit_phase_nreq);
   StatisticsRegistry::unregisterStat(&d_triggers);
@@ -64,10 +64,12 @@ namespace quantifiers {
   class ModelEngine;
   class TermDb;
   class FirstOrderModel;
+  class InstScheduler;
 }/* CVC4::theory::quantifiers */
 
 namespace inst {
   class TriggerTrie;
+  class MatchCodeTree;
 }/* CVC4::theory::inst */
 
 namespace rrinst {
@@ -108,12 +110,26 @@ private:
   std::vector< Node > d_lemmas_waiting;
   /** has added lemma this round */
   bool d_hasAddedLemma;
-  /** list of all instantiations produced for each quantifier */
-  std::map< Node, inst::InstMatchTrie > d_inst_match_trie;
+  /** scheduler for instantiation lemmas (if --inst-budget is set) */
+  quantifiers::InstScheduler* d_inst_sched;
+  /** number of scheduled lemmas sent this round */
+  int d_num_sched_sent;
+  /** set of all instantiations produced for each quantifier */
+  std::map< Node, inst::InstMatchSet > d_inst_match_set;
+  /** whether instantiations are collected to be filtered by --inst-conflict-first rather than added */
+  bool d_inst_batch_active;
+  /** the quantifiers with instantiations in the current batch, in order */
+  std::vector< Node > d_inst_batch_quants;
+  /** the instantiations in the current batch for each quantifier, with their modEq flag */
+  std::map< Node, std::vector< std::pair< InstMatch, bool > > > d_inst_batch;
+  /** set of instantiations in the current batch for each quantifier */
+  std::map< Node, inst::InstMatchSet > d_inst_batch_set;
   /** term database */
   quantifiers::TermDb* d_term_db;
   /** all triggers will be stored in this trie */
   inst::TriggerTrie* d_tr_trie;
+  /** code tree for matching single triggers */
+  inst::MatchCodeTree* d_code_tree;
   /** all triggers for rewrite rules will be stored in this trie */
   rrinst::TriggerTrie* d_rr_tr_trie;
   /** extended model object */
@@ -170,6 +186,35 @@ private:
   bool addInstantiation( Node f, std::vector< Node >& vars, std::vector< Node >& terms );
   /** set instantiation level attr */
   void setInstantiationLevelAttr( Node n, uint64_t level );
+  /** record that the instantiation of f with terms, whose body is body, is sent */
+  void recordInstantiation( Node f, Node body, std::vector< Node >& terms );
+  /** add the complete instantiation m, which is not a duplicate */
+  bool commitInstantiation( Node f, InstMatch& m, bool modEq );
+  /** status of an instantiation in the current context */
+  enum {
+    inst_status_conflict,
+    inst_status_propagate,
+    inst_status_other,
+  };
+  /** get the status of the instantiation of f by m */
+  int getInstantiationStatus( Node f, InstMatch& m );
+  /** is n a literal, that is, an atom or its negation, and not a Boolean connective */
+  static bool isLiteral( Node n );
+  /** get the representative of ground term n, possibly by congruence, or null if unknown */
+  Node getEvaluatedRepresentative( Node n );
+  /** evaluator for ground formulas in the current context */
+  class GroundEvaluator : public BooleanEvaluator {
+  private:
+    QuantifiersEngine* d_qe;
+  protected:
+    int evaluateLiteral( Node n, int& dep ) { return d_qe->evaluateLiteral( n ); }
+  public:
+    GroundEvaluator( QuantifiersEngine* qe ) : d_qe( qe ){}
+  };
+  /** evaluate ground literal n in the current context */
+  int evaluateLiteral( Node n );
+  /** evaluate n in the current context: 1 if true, -1 if false, 0 if unknown */
+  int evaluate( Node n );
 public:
   /** get instantiation */
   Node getInstantiation( Node f, std::vector< Node >& vars, std::vector< Node >& terms );
@@ -179,14 +224,20 @@ public:
   bool existsInstantiation( Node f, InstMatch& m, bool modEq = true, bool modInst = false );
   /** add lemma lem */
   bool addLemma( Node lem );
+  /** add lemma lem, the instantiation of f with terms whose body is body, to the scheduler */
+  bool addScheduledLemma( Node lem, Node f, Node body, std::vector< Node >& terms );
   /** do instantiation specified by m */
   bool addInstantiation( Node f, InstMatch& m, bool modEq = true, bool modInst = false, bool mkRep = true );
+  /** start collecting instantiations in a batch, so that --inst-conflict-first can filter them */
+  void beginInstantiationBatch();
+  /** add the instantiations of the current batch that pass the --inst-conflict-first filter, return the number added */
+  int commitInstantiationBatch();
   /** split on node n */
   bool addSplit( Node n, bool reqPhase = false, bool reqPhasePol = true );
   /** add split equality */
   bool addSplitEquality( Node n1, Node n2, bool reqPhase = false, bool reqPhasePol = true );
   /** has added lemma */
-  bool hasAddedLemma() { return !d_lemmas_waiting.empty() || d_hasAddedLemma; }
+  bool hasAddedLemma();
   /** flush lemmas */
   void flushLemmas( OutputChannel* out );
   /** get number of waiting lemmas */
@@ -203,6 +254,8 @@ public:
   quantifiers::TermDb* getTermDatabase() { return d_term_db; }
   /** get trigger database */
   inst::TriggerTrie* getTriggerDatabase() { return d_tr_trie; }
+  /** get code tree for matching single triggers */
+  inst::MatchCodeTree* getMatchCodeTree() { return d_code_tree; }
   /** get rewrite trigger database */
   rrinst::TriggerTrie* getRRTriggerDatabase() { return d_rr_tr_trie; }
   /** add term to database */
@@ -222,6 +275,9 @@ public:
     IntStat d_total_inst_var_unspec;
     IntStat d_inst_unspec;
     IntStat d_inst_duplicate;
+    IntStat d_inst_batch_max;
+    IntStat d_inst_conflict;
+    IntStat d_inst_propagate;
     IntStat d_lit_phase_req;
     IntStat d_lit_phase_nreq;
     IntStat d_triggers;
@@ -274,6 +330,8 @@ public:
   ~EqualityQueryQuantifiersEngine(){}
   /** reset */
   void reset();
+  /** get the number of calls to reset */
+  int getResetCount() { return d_reset_count; }
   /** general queries about equality */
   bool hasTerm( Node a );
   Node getRepresentative( Node a );
@@ -45,11 +45,11 @@ void EqClassInfo::setMember( Node n, quantifiers::TermDb* db ){
     d_funs.insertAtContextLevelZero(n.getOperator(),true);
   }
   //add parent functions
-  for( std::hash_map< Node, std::hash_map< int, std::vector< Node >  >, NodeHashFunction >::iterator it = db->d_parents[n].begin();
-    it != db->d_parents[n].end(); ++it ){
+  const std::vector< Node >& pops = db->getParentOps( n );
+  for( size_t i=0; i<pops.size(); i++ ){
     //TODO Is it true to do it at level 0? That depend when SetMember is called
     // At worst it is a good overapproximation
-    d_pfuns.insertAtContextLevelZero( it->first, true);
+    d_pfuns.insertAtContextLevelZero( pops[i], true);
   }
 }
 
@@ -22,6 +22,7 @@
 #include "theory/rewriterules/theory_rewriterules_preprocess.h"
 #include "theory/rewriter.h"
 #include "theory/rewriterules/options.h"
+#include "theory/quantifiers/match_code_tree.h"
 
 
 using namespace std;
@@ -133,7 +134,8 @@ TheoryRewriteRules::TheoryRewriteRules(context::Context* c,
                                        QuantifiersEngine* qe) :
   Theory(THEORY_REWRITERULES, c, u, out, valuation, logicInfo, qe),
   d_rules(c), d_ruleinsts(c), d_guardeds(c), d_checkLevel(c,0),
-  d_explanations(c), d_ruleinsts_to_add(), d_ppAssert_on(false)
+  d_explanations(c), d_guard_literals(u),
+  d_ruleinsts_to_add(), d_ppAssert_on(false)
   {
   d_true = NodeManager::currentNM()->mkConst<bool>(true);
   d_false = NodeManager::currentNM()->mkConst<bool>(false);
@@ -143,6 +145,7 @@ void TheoryRewriteRules::addMatchRuleTrigger(const RewriteRule * r,
                                              InstMatch & im,
                                              bool delay){
   ++r->nb_matched;
+  ++r->d_statistics.d_matched;
   ++d_statistics.d_match_found;
   if(rewrite_instantiation) im.applyRewrite();
   if(representative_instantiation)
@@ -204,11 +207,39 @@ void TheoryRewriteRules::check(Effort level) {
 
   Debug("rewriterules::check") << "RewriteRules::Check start " << d_checkLevel << (level==EFFORT_FULL? " EFFORT_FULL":"") << std::endl;
 
+  /** The compiled rules are all matched by the first getMatches */
+  inst::MatchCodeTree * ct = getQuantifiersEngine()->getMatchCodeTree();
+  int someCodeId = -1;
+  for(size_t rid = 0, end = d_rules.size(); rid < end; ++rid) {
+    RewriteRule * r = d_rules[rid];
+    if (level!=EFFORT_FULL && r->d_split) continue;
+    if (r->d_code_id >= 0){
+      ct->resetPattern(r->d_code_id);
+      someCodeId = r->d_code_id;
+    }
+  }
+  /** The shared pass is timed apart from the rules */
+  if(someCodeId >= 0){
+    CodeTimer codeTreeTimer(d_statistics.d_code_tree_match_time);
+    ct->getMatches(someCodeId);
+  }
+
   /** Test each rewrite rule */
   for(size_t rid = 0, end = d_rules.size(); rid < end; ++rid) {
     RewriteRule * r = d_rules[rid];
     if (level!=EFFORT_FULL && r->d_split) continue;
     Debug("rewriterules::check") << "RewriteRules::Check  rule: " << *r << std::endl;
+    CodeTimer ruleTimer(r->d_statistics.d_match_time);
+    if(r->d_code_id >= 0){
+      std::vector< std::vector<Node> > & matches = ct->getMatches(r->d_code_id);
+      const std::vector<Node> & vars = ct->getVariables(r->d_code_id);
+      for(size_t i = 0; i < matches.size(); ++i){
+        InstMatch im;
+        for(size_t j = 0; j < vars.size(); ++j) im.set(vars[j], matches[i][j]);
+        addMatchRuleTrigger(r, im, true);
+      }
+      continue;
+    }
     Trigger & tr = r->trigger;
     //reset instantiation round for trigger (set up match production)
     tr.resetInstantiationRound();
@@ -334,7 +365,15 @@ void TheoryRewriteRules::notification(GList * const lpropa, bool b){
 Answer TheoryRewriteRules::addWatchIfDontKnow(Node g0, const RuleInst* ri,
                                               const size_t gid){
   /** Currently create a node with a literal */
-  Node g = getValuation().ensureLiteral(g0);
+  Node g;
+  GuardLiteralMap::const_iterator gl_i = d_guard_literals.find(g0);
+  if( gl_i == d_guard_literals.end() ){
+    g = getValuation().ensureLiteral(g0);
+    d_guard_literals.insert(g0, g);
+  } else {
+    g = (*gl_i).second;
+    ++d_statistics.d_guard_literal_hit;
+  }
   GuardedMap::iterator l_i = d_guardeds.find(g);
   GList* l;
   if( l_i == d_guardeds.end() ) {
@@ -450,6 +489,7 @@ void TheoryRewriteRules::propagateRule(const RuleInst * inst, TCache cache){
   Debug("rewriterules::propagate") << "propagateRule" << *inst << std::endl;
   const RewriteRule * rule = inst->rule;
   ++rule->nb_applied;
+  ++rule->d_statistics.d_fired;
   // Can be more something else than an equality in fact (eg. propagation rule)
   Node equality = skolemizeBody(inst->substNode(*this,rule->body,cache));
   if(propagate_as_lemma){
@@ -614,7 +654,9 @@ TheoryRewriteRules::Statistics::Statistics():
   d_poll("TheoryRewriteRules::Poll", 0),
   d_match_found("TheoryRewriteRules::MatchFound", 0),
   d_cache_hit("TheoryRewriteRules::CacheHit", 0),
-  d_cache_miss("TheoryRewriteRules::CacheMiss", 0)
+  d_cache_miss("TheoryRewriteRules::CacheMiss", 0),
+  d_guard_literal_hit("TheoryRewriteRules::GuardLiteralHit", 0),
+  d_code_tree_match_time("TheoryRewriteRules::CodeTreeMatchTime")
 {
   StatisticsRegistry::registerStat(&d_num_rewriterules);
   StatisticsRegistry::registerStat(&d_check);
@@ -623,6 +665,8 @@ TheoryRewriteRules::Statistics::Statistics():
   StatisticsRegistry::registerStat(&d_match_found);
   StatisticsRegistry::registerStat(&d_cache_hit);
   StatisticsRegistry::registerStat(&d_cache_miss);
+  StatisticsRegistry::registerStat(&d_guard_literal_hit);
+  StatisticsRegistry::registerStat(&d_code_tree_match_time);
 }
 
 TheoryRewriteRules::Statistics::~Statistics(){
@@ -633,6 +677,8 @@ TheoryRewriteRules::Statistics::~Statistics(){
   StatisticsRegistry::unregisterStat(&d_match_found);
   StatisticsRegistry::unregisterStat(&d_cache_hit);
   StatisticsRegistry::unregisterStat(&d_cache_miss);
+  StatisticsRegistry::unregisterStat(&d_guard_literal_hit);
+  StatisticsRegistry::unregisterStat(&d_code_tree_match_time);
 }
 
 
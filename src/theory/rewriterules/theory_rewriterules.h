@@ -71,6 +71,10 @@ typedef std::hash_map<TNode, TNode, TNodeHashFunction> TCache;
 
     const bool directrr;
 
+    /** id of the pattern in the match code tree, -1 if the rule is
+        matched by its trigger */
+    int d_code_id;
+
     RewriteRule(TheoryRewriteRules & re,
                 Trigger & tr, ApplyMatcher * tr2,
                 std::vector<Node> & g, Node b, TNode nt,
@@ -90,6 +94,19 @@ typedef std::hash_map<TNode, TNode, TNodeHashFunction> TCache;
     mutable size_t nb_applied;
     mutable size_t nb_propagated;
 
+    /** per rule statistics class */
+    class Statistics {
+    public:
+      IntStat d_matched;
+      IntStat d_fired;
+      /** time spent matching this rule, without the shared pass of the
+          match code tree (see TheoryRewriteRules::CodeTreeMatchTime) */
+      TimerStat d_match_time;
+      Statistics(size_t id);
+      ~Statistics();
+    };
+    mutable Statistics d_statistics;
+
   };
 
   class RuleInst{
@@ -181,6 +198,11 @@ private:
   typedef context::CDHashMap<Node, RuleInst , NodeHashFunction> ExplanationMap;
   ExplanationMap d_explanations;
 
+  /** guard (already substituted) -> its literal, user context
+      dependent since the literals are registered until a pop */
+  typedef context::CDHashMap<Node, Node, NodeHashFunction> GuardLiteralMap;
+  GuardLiteralMap d_guard_literals;
+
   /** new instantiation must be cleared at each conflict used only
       inside check */
   typedef std::vector< RuleInst* > QRuleInsts;
@@ -275,6 +297,9 @@ private:
     IntStat d_match_found;
     IntStat d_cache_hit;
     IntStat d_cache_miss;
+    IntStat d_guard_literal_hit;
+    /** time of the pass matching all the compiled rules at once */
+    TimerStat d_code_tree_match_time;
     Statistics();
     ~Statistics();
   };
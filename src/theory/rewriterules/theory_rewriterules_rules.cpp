@@ -22,6 +22,9 @@
 #include "theory/rewriterules/options.h"
 
 #include "theory/quantifiers/term_database.h"
+#include "theory/quantifiers/match_code_tree.h"
+
+#include <sstream>
 
 using namespace std;
 using namespace CVC4;
@@ -273,6 +276,13 @@ void TheoryRewriteRules::addRewriteRule(const Node r)
                                      guards, body, new_terms,
                                      vars, inst_constants, to_remove,
                                      directrr);
+  /** Compile the single pattern rules, except the direct ones which
+      need the matched term */
+  if(options::rrCodeTree() && !directrr && pattern.size() == 1 &&
+     inst::MatchCodeTree::isCompilable(pattern[0])){
+    rr->d_code_id =
+      getQuantifiersEngine()->getMatchCodeTree()->addPattern(pattern[0]);
+  }
   /** other -> rr */
   if(compute_opt && !rr->d_split) computeMatchBody(rr);
   d_rules.push_back(rr);
@@ -319,7 +329,9 @@ RewriteRule::RewriteRule(TheoryRewriteRules & re,
   id(++id_next), d_split(willDecide(b)),
   trigger(tr), body(b), new_terms(nt), free_vars(), inst_vars(),
   body_match(re.getSatContext()),trigger_for_body_match(applymatcher),
-  d_cache(re.getSatContext(),re.getQuantifiersEngine()), directrr(drr){
+  d_cache(re.getSatContext(),re.getQuantifiersEngine()), directrr(drr),
+  d_code_id(-1), nb_matched(0), nb_applied(0), nb_propagated(0),
+  d_statistics(id){
   free_vars.swap(fv); inst_vars.swap(iv); guards.swap(g); to_remove.swap(to_r);
 };
 
@@ -356,6 +368,28 @@ RewriteRule::~RewriteRule(){
   delete(trigger_for_body_match);
 }
 
+static std::string ruleStatName(size_t id, const char * name){
+  std::stringstream ss;
+  ss << "TheoryRewriteRules::Rule" << id << "::" << name;
+  return ss.str();
+}
+
+RewriteRule::Statistics::Statistics(size_t id):
+  d_matched(ruleStatName(id,"Matched"), 0),
+  d_fired(ruleStatName(id,"Fired"), 0),
+  d_match_time(ruleStatName(id,"MatchTime"))
+{
+  StatisticsRegistry::registerStat(&d_matched);
+  StatisticsRegistry::registerStat(&d_fired);
+  StatisticsRegistry::registerStat(&d_match_time);
+}
+
+RewriteRule::Statistics::~Statistics(){
+  StatisticsRegistry::unregisterStat(&d_matched);
+  StatisticsRegistry::unregisterStat(&d_fired);
+  StatisticsRegistry::unregisterStat(&d_match_time);
+}
+
 bool TheoryRewriteRules::addRewritePattern(TNode pattern, TNode body,
                                            rewriter::Subst & pvars,
                                            rewriter::Subst & vars){
@@ -64,6 +64,54 @@ void UfModelTreeNode::setValue( TheoryModel* m, Node n, Node v, std::vector< int
   }
 }
 
+Node UfModelTreeNode::getUniformValue( TheoryModel* m, Node op, std::vector< Node >& args, std::vector< int >& indexOrder, int& splitArg, int argIndex ){
+  if( argIndex==(int)indexOrder.size() || ( !d_value.isNull() && isTotal( op, argIndex ) ) ){
+    return d_value.isNull() ? d_value : m->getRepresentative( d_value );
+  }else{
+    Node a = args[ indexOrder[argIndex] ];
+    if( a.isNull() ){
+      //the argument may have any value: the value must be the same for each child,
+      //  and there must be a default for the values that are not children
+      if( d_data.find( Node::null() )==d_data.end() ){
+        splitArg = indexOrder[argIndex];
+        return Node::null();
+      }
+      Node val;
+      for( std::map< Node, UfModelTreeNode >::iterator it = d_data.begin(); it != d_data.end(); ++it ){
+        int childSplitArg = -1;
+        Node v = it->second.getUniformValue( m, op, args, indexOrder, childSplitArg, argIndex+1 );
+        if( v.isNull() || ( !val.isNull() && v!=val ) ){
+          splitArg = ( v.isNull() && childSplitArg!=-1 ) ? childSplitArg : indexOrder[argIndex];
+          return Node::null();
+        }
+        val = v;
+      }
+      return val;
+    }else{
+      //first check the argument, then check default
+      for( int i=0; i<2; i++ ){
+        Node r;
+        if( i==0 ){
+          r = m->getRepresentative( a );
+        }
+        std::map< Node, UfModelTreeNode >::iterator it = d_data.find( r );
+        if( it!=d_data.end() ){
+          int childSplitArg = -1;
+          Node v = it->second.getUniformValue( m, op, args, indexOrder, childSplitArg, argIndex+1 );
+          if( !v.isNull() ){
+            return v;
+          }else if( childSplitArg!=-1 ){
+            //whether the value is defined here depends on a null argument
+            splitArg = childSplitArg;
+            return Node::null();
+          }
+        }
+      }
+      return Node::null();
+    }
+  }
+}
+
 //get value function
 Node UfModelTreeNode::getValue( TheoryModel* m, Node n, std::vector< int >& indexOrder, int& depIndex, int argIndex ){
   if( !d_value.isNull() && isTotal( n.getOperator(), argIndex ) ){
@@ -43,6 +43,8 @@ public:
   /**  getValue function */
   Node getValue( TheoryModel* m, Node n, std::vector< int >& indexOrder, int& depIndex, int argIndex );
   Node getValue( TheoryModel* m, Node n, std::vector< int >& indexOrder, std::vector< int >& depIndex, int argIndex );
+  /** getUniformValue function */
+  Node getUniformValue( TheoryModel* m, Node op, std::vector< Node >& args, std::vector< int >& indexOrder, int& splitArg, int argIndex );
   /** getConstant Value function */
   Node getConstantValue( TheoryModel* m, Node n, std::vector< int >& indexOrder, int argIndex );
   /** getFunctionValue */
@@ -108,6 +110,20 @@ public:
   Node getValue( TheoryModel* m, Node n, std::vector< int >& depIndex ){
     return d_tree.getValue( m, n, d_index_order, depIndex, 0 );
   }
+  /** getUniformValue function
+    *
+    *  args are the values of the arguments, where a null argument stands for any value.
+    *  Returns the representative of the value of the function if it is the same
+    *    for all values of the null arguments.
+    *  Otherwise, returns null, and splitArg is a null argument the value depends on
+    *    (or -1 if the value is undefined).
+    *  For example, if g( x_0, x_1 ) := lambda x_0 x_1. if( x_0==a ) b else c,
+    *    then g( null, a ) returns null with splitArg = 0, while g( a, null ) returns b.
+    *
+    */
+  Node getUniformValue( TheoryModel* m, std::vector< Node >& args, int& splitArg ){
+    return d_tree.getUniformValue( m, d_op, args, d_index_order, splitArg, 0 );
+  }
   /** getConstantValue function
     *
     * given term n, where n may contain "all value" arguments, aka model basis arguments
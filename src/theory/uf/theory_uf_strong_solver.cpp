@@ -1630,7 +1630,7 @@ int TermDisambiguator::disambiguateTerms( OutputChannel* out ){
   int lemmaAdded = 0;
   //otherwise, determine ambiguous pairs of ground terms for relevant sorts
   quantifiers::TermDb* db = d_qe->getTermDatabase();
-  for( std::map< Node, std::vector< Node > >::iterator it = db->d_op_map.begin(); it != db->d_op_map.end(); ++it ){
+  for( quantifiers::TermDb::OpMap::iterator it = db->d_op_map.begin(); it != db->d_op_map.end(); ++it ){
     Debug("uf-ss-disamb") << "Check " << it->first << std::endl;
     if( it->second.size()>1 ){
       if(involvesRelevantType( it->second[0] ) ){
@@ -20,6 +20,7 @@
 #ifndef __CVC4__INTEGER_H
 #define __CVC4__INTEGER_H
 
+#include <climits>
 #include <string>
 #include <iostream>
 
@@ -306,7 +307,12 @@ public:
    */
   Integer gcd(const Integer& y) const {
     mpz_class result;
-    mpz_gcd(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(mpz_cmpabs_ui(y.d_value.get_mpz_t(), ULONG_MAX) <= 0) {
+      // the single word case, which is the common one, avoids the general gcd
+      mpz_gcd_ui(result.get_mpz_t(), d_value.get_mpz_t(), mpz_get_ui(y.d_value.get_mpz_t()));
+    } else {
+      mpz_gcd(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    }
     return Integer(result);
   }
 
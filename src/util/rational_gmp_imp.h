@@ -21,6 +21,7 @@
 #define __CVC4__RATIONAL_H
 
 #include <gmp.h>
+#include <stdint.h>
 #include <string>
 
 #include "util/integer.h"
@@ -37,6 +38,12 @@ namespace CVC4 {
  ** literature.) A consequence is that that the numerator and denominator may be
  ** different than the values used to construct the Rational.
  **
+ ** Rationals whose numerator and denominator fit in 31 bits are kept inline
+ ** as a pair of machine integers and only the others are backed by a GMP
+ ** rational, so that the small coefficients and values that make up most of
+ ** the arithmetic do not need heap allocation.  The arithmetic on small
+ ** rationals falls back to GMP whenever the result does not fit.
+ **
  ** NOTE: The correct way to create a Rational from an int is to use one of the
  ** int numerator/int denominator constructors with the denominator 1.  Trying
  ** to construct a Rational with a single int, e.g., Rational(0), will put you
@@ -46,10 +53,85 @@ namespace CVC4 {
 class CVC4_PUBLIC Rational {
 private:
   /**
-   * Stores the value of the rational is stored in a C++ GMP rational class.
-   * Using this instead of mpq_t allows for easier destruction.
+   * The numerator and the denominator of a small rational. The denominator
+   * is positive and both are at most SMALL_MAX in absolute value, so the
+   * products of two of them fit in 64 bits.
+   */
+  int64_t d_num;
+  int64_t d_den;
+
+  /**
+   * Stores the value of a rational that is not small in a C++ GMP rational
+   * class, NULL for small rationals.  Each value has a single
+   * representation: a GMP rational is never small.
+   */
+  mpq_class* d_big;
+
+  static const int64_t SMALL_MAX = 2147483647;
+
+  static bool isSmall(int64_t n) {
+    return -SMALL_MAX <= n && n <= SMALL_MAX;
+  }
+
+  static int64_t gcd(int64_t a, int64_t b) {
+    while(b != 0) {
+      int64_t t = a % b;
+      a = b;
+      b = t;
+    }
+    return a;
+  }
+
+  /**
+   * Sets a small value from a numerator and a positive denominator that
+   * are the result of the arithmetic on small values. Returns false if the
+   * normalized value is not small.
+   */
+  bool setSmall(int64_t n, int64_t d) {
+    int64_t g = gcd(n < 0 ? -n : n, d);
+    if(g > 1) {
+      n /= g;
+      d /= g;
+    }
+    if(!isSmall(n) || d > SMALL_MAX) {
+      return false;
+    }
+    d_num = n;
+    d_den = d;
+    return true;
+  }
+
+  /**
+   * Initializes from a GMP rational in canonical form, using the small
+   * representation if possible.
    */
-  mpq_class d_value;
+  void initFrom(const mpq_class& q) {
+    if(mpz_cmpabs_ui(q.get_num_mpz_t(), SMALL_MAX) <= 0 &&
+       mpz_cmp_ui(q.get_den_mpz_t(), SMALL_MAX) <= 0) {
+      d_num = mpz_get_si(q.get_num_mpz_t());
+      d_den = mpz_get_si(q.get_den_mpz_t());
+      d_big = NULL;
+    } else {
+      d_num = 0;
+      d_den = 1;
+      d_big = new mpq_class(q);
+    }
+  }
+
+  void initSmall(int64_t n, int64_t d) {
+    d_num = n;
+    d_den = d;
+    d_big = NULL;
+  }
+
+  /** Returns the value as a GMP rational (makes a copy) */
+  mpq_class getMpq() const {
+    if(d_big == NULL) {
+      return mpq_class((signed long int)d_num, (signed long int)d_den);
+    } else {
+      return *d_big;
+    }
+  }
 
   /**
    * Constructs a Rational from a mpq_class object.
@@ -57,7 +139,13 @@ private:
    * Assumes that the value is in canonical form, and thus does not
    * have to call canonicalize() on the value.
    */
-  Rational(const mpq_class& val) : d_value(val) {  }
+  Rational(const mpq_class& val) { initFrom(val); }
+
+  /** Helpers for the construction from a (canonicalized) GMP rational */
+  static mpq_class canonical(mpq_class q) {
+    q.canonicalize();
+    return q;
+  }
 
 public:
 
@@ -70,9 +158,7 @@ public:
   static Rational fromDecimal(const std::string& dec);
 
   /** Constructs a rational with the value 0/1. */
-  Rational() : d_value(0){
-    d_value.canonicalize();
-  }
+  Rational() : d_num(0), d_den(1), d_big(NULL) {}
 
   /**
    * Constructs a Rational from a C string in a given base (defaults to 10).
@@ -80,89 +166,114 @@ public:
    * For more information about what is a valid rational string,
    * see GMP's documentation for mpq_set_str().
    */
-  explicit Rational(const char* s, unsigned base = 10): d_value(s, base) {
-    d_value.canonicalize();
+  explicit Rational(const char* s, unsigned base = 10) {
+    initFrom(canonical(mpq_class(s, base)));
   }
-  Rational(const std::string& s, unsigned base = 10) : d_value(s, base) {
-    d_value.canonicalize();
+  Rational(const std::string& s, unsigned base = 10) {
+    initFrom(canonical(mpq_class(s, base)));
   }
 
   /**
    * Creates a Rational from another Rational, q, by performing a deep copy.
    */
-  Rational(const Rational& q) : d_value(q.d_value) {
-    d_value.canonicalize();
-  }
+  Rational(const Rational& q) :
+    d_num(q.d_num), d_den(q.d_den),
+    d_big(q.d_big == NULL ? NULL : new mpq_class(*q.d_big))
+  {}
 
   /**
    * Constructs a canonical Rational from a numerator.
    */
-  Rational(signed int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(signed int n) {
+    if(isSmall(n)) {
+      initSmall(n, 1);
+    } else {
+      initFrom(mpq_class(n, 1));
+    }
   }
-  Rational(unsigned int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(unsigned int n) {
+    if(n <= (unsigned int)SMALL_MAX) {
+      initSmall(n, 1);
+    } else {
+      initFrom(mpq_class(n, 1u));
+    }
   }
-  Rational(signed long int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(signed long int n) {
+    if(isSmall(n)) {
+      initSmall(n, 1);
+    } else {
+      initFrom(mpq_class(n, 1l));
+    }
   }
-  Rational(unsigned long int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(unsigned long int n) {
+    if(n <= (unsigned long int)SMALL_MAX) {
+      initSmall(n, 1);
+    } else {
+      initFrom(mpq_class(n, 1ul));
+    }
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n) : d_value(static_cast<long>(n), 1) {
-    d_value.canonicalize();
+  Rational(int64_t n) {
+    if(isSmall(n)) {
+      initSmall(n, 1);
+    } else {
+      initFrom(mpq_class(static_cast<long>(n), 1l));
+    }
   }
-  Rational(uint64_t n) : d_value(static_cast<unsigned long>(n), 1) {
-    d_value.canonicalize();
+  Rational(uint64_t n) {
+    if(n <= (uint64_t)SMALL_MAX) {
+      initSmall(n, 1);
+    } else {
+      initFrom(mpq_class(static_cast<unsigned long>(n), 1ul));
+    }
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
   /**
    * Constructs a canonical Rational from a numerator and denominator.
    */
-  Rational(signed int n, signed int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(signed int n, signed int d) {
+    initFrom(canonical(mpq_class(n, d)));
   }
-  Rational(unsigned int n, unsigned int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(unsigned int n, unsigned int d) {
+    initFrom(canonical(mpq_class(n, d)));
   }
-  Rational(signed long int n, signed long int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(signed long int n, signed long int d) {
+    initFrom(canonical(mpq_class(n, d)));
   }
-  Rational(unsigned long int n, unsigned long int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(unsigned long int n, unsigned long int d) {
+    initFrom(canonical(mpq_class(n, d)));
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n, int64_t d) : d_value(static_cast<long>(n), static_cast<long>(d)) {
-    d_value.canonicalize();
+  Rational(int64_t n, int64_t d) {
+    initFrom(canonical(mpq_class(static_cast<long>(n), static_cast<long>(d))));
   }
-  Rational(uint64_t n, uint64_t d) : d_value(static_cast<unsigned long>(n), static_cast<unsigned long>(d)) {
-    d_value.canonicalize();
+  Rational(uint64_t n, uint64_t d) {
+    initFrom(canonical(mpq_class(static_cast<unsigned long>(n), static_cast<unsigned long>(d))));
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
-  Rational(const Integer& n, const Integer& d) :
-    d_value(n.get_mpz(), d.get_mpz())
-  {
-    d_value.canonicalize();
+  Rational(const Integer& n, const Integer& d) {
+    initFrom(canonical(mpq_class(n.get_mpz(), d.get_mpz())));
   }
-  Rational(const Integer& n) :
-    d_value(n.get_mpz())
-  {
-    d_value.canonicalize();
+  Rational(const Integer& n) {
+    initFrom(mpq_class(n.get_mpz()));
+  }
+  ~Rational() {
+    delete d_big;
   }
-  ~Rational() {}
-
 
   /**
    * Returns the value of numerator of the Rational.
    * Note that this makes a deep copy of the numerator.
    */
   Integer getNumerator() const {
-    return Integer(d_value.get_num());
+    if(d_big == NULL) {
+      return Integer((signed long int)d_num);
+    }
+    return Integer(d_big->get_num());
   }
 
   /**
@@ -170,7 +281,10 @@ public:
    * Note that this makes a deep copy of the denominator.
    */
   Integer getDenominator() const {
-    return Integer(d_value.get_den());
+    if(d_big == NULL) {
+      return Integer((signed long int)d_den);
+    }
+    return Integer(d_big->get_den());
   }
 
   /**
@@ -179,21 +293,37 @@ public:
    * infinity, and underflow may result in zero.
    */
   double getDouble() const {
-    return d_value.get_d();
+    if(d_big == NULL) {
+      return ((double)d_num) / ((double)d_den);
+    }
+    return d_big->get_d();
   }
 
   Rational inverse() const {
+    if(d_big == NULL && d_num != 0) {
+      Rational res;
+      res.initSmall(d_num < 0 ? -d_den : d_den, d_num < 0 ? -d_num : d_num);
+      return res;
+    }
     return Rational(getDenominator(), getNumerator());
   }
 
   int cmp(const Rational& x) const {
+    if(d_big == NULL && x.d_big == NULL) {
+      int64_t l = d_num * x.d_den;
+      int64_t r = x.d_num * d_den;
+      return l < r ? -1 : (l == r ? 0 : 1);
+    }
     //Don't use mpq_class's cmp() function.
     //The name ends up conflicting with this function.
-    return mpq_cmp(d_value.get_mpq_t(), x.d_value.get_mpq_t());
+    return mpq_cmp(getMpq().get_mpq_t(), x.getMpq().get_mpq_t());
   }
 
   int sgn() const {
-    return mpq_sgn(d_value.get_mpq_t());
+    if(d_big == NULL) {
+      return d_num < 0 ? -1 : (d_num == 0 ? 0 : 1);
+    }
+    return mpq_sgn(d_big->get_mpq_t());
   }
 
   bool isZero() const {
@@ -201,11 +331,11 @@ public:
   }
 
   bool isOne() const {
-    return mpq_cmp_si(d_value.get_mpq_t(), 1, 1) == 0;
+    return d_big == NULL && d_num == 1 && d_den == 1;
   }
 
   bool isNegativeOne() const {
-    return mpq_cmp_si(d_value.get_mpq_t(), -1, 1) == 0;
+    return d_big == NULL && d_num == -1 && d_den == 1;
   }
 
   Rational abs() const {
@@ -217,87 +347,152 @@ public:
   }
 
   Integer floor() const {
+    if(d_big == NULL) {
+      int64_t q = d_num / d_den;
+      if(d_num < 0 && q * d_den != d_num) {
+        --q;
+      }
+      return Integer((signed long int)q);
+    }
     mpz_class q;
-    mpz_fdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_fdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
   Integer ceiling() const {
+    if(d_big == NULL) {
+      int64_t q = d_num / d_den;
+      if(d_num > 0 && q * d_den != d_num) {
+        ++q;
+      }
+      return Integer((signed long int)q);
+    }
     mpz_class q;
-    mpz_cdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_cdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
   Rational& operator=(const Rational& x){
     if(this == &x) return *this;
-    d_value = x.d_value;
+    if(x.d_big == NULL) {
+      delete d_big;
+      d_big = NULL;
+      d_num = x.d_num;
+      d_den = x.d_den;
+    } else if(d_big == NULL) {
+      d_big = new mpq_class(*x.d_big);
+    } else {
+      *d_big = *x.d_big;
+    }
     return *this;
   }
 
   Rational operator-() const{
-    return Rational(-(d_value));
+    if(d_big == NULL) {
+      Rational res;
+      res.initSmall(-d_num, d_den);
+      return res;
+    }
+    return Rational(-(*d_big));
   }
 
   bool operator==(const Rational& y) const {
-    return d_value == y.d_value;
+    if(d_big == NULL || y.d_big == NULL) {
+      return d_big == y.d_big && d_num == y.d_num && d_den == y.d_den;
+    }
+    return *d_big == *y.d_big;
   }
 
   bool operator!=(const Rational& y) const {
-    return d_value != y.d_value;
+    return !(*this == y);
   }
 
   bool operator< (const Rational& y) const {
-    return d_value < y.d_value;
+    return cmp(y) < 0;
   }
 
   bool operator<=(const Rational& y) const {
-    return d_value <= y.d_value;
+    return cmp(y) <= 0;
   }
 
   bool operator> (const Rational& y) const {
-    return d_value > y.d_value;
+    return cmp(y) > 0;
   }
 
   bool operator>=(const Rational& y) const {
-    return d_value >= y.d_value;
+    return cmp(y) >= 0;
   }
 
   Rational operator+(const Rational& y) const{
-    return Rational( d_value + y.d_value );
+    if(d_big == NULL && y.d_big == NULL) {
+      Rational res;
+      if(d_den == 1 && y.d_den == 1) {
+        if(res.setSmall(d_num + y.d_num, 1)) return res;
+      } else if(res.setSmall(d_num * y.d_den + y.d_num * d_den, d_den * y.d_den)) {
+        return res;
+      }
+    }
+    return Rational( getMpq() + y.getMpq() );
   }
   Rational operator-(const Rational& y) const {
-    return Rational( d_value - y.d_value );
+    if(d_big == NULL && y.d_big == NULL) {
+      Rational res;
+      if(d_den == 1 && y.d_den == 1) {
+        if(res.setSmall(d_num - y.d_num, 1)) return res;
+      } else if(res.setSmall(d_num * y.d_den - y.d_num * d_den, d_den * y.d_den)) {
+        return res;
+      }
+    }
+    return Rational( getMpq() - y.getMpq() );
   }
 
   Rational operator*(const Rational& y) const {
-    return Rational( d_value * y.d_value );
+    if(d_big == NULL && y.d_big == NULL) {
+      Rational res;
+      if(res.setSmall(d_num * y.d_num, d_den * y.d_den)) {
+        return res;
+      }
+    }
+    return Rational( getMpq() * y.getMpq() );
   }
   Rational operator/(const Rational& y) const {
-    return Rational( d_value / y.d_value );
+    if(d_big == NULL && y.d_big == NULL && y.d_num != 0) {
+      Rational res;
+      int64_t n = d_num * y.d_den;
+      int64_t d = d_den * y.d_num;
+      if(d < 0) {
+        n = -n;
+        d = -d;
+      }
+      if(res.setSmall(n, d)) {
+        return res;
+      }
+    }
+    return Rational( getMpq() / y.getMpq() );
   }
 
   Rational& operator+=(const Rational& y){
-    d_value += y.d_value;
-    return (*this);
+    return (*this) = (*this) + y;
   }
 
   Rational& operator*=(const Rational& y){
-    d_value *= y.d_value;
-    return (*this);
+    return (*this) = (*this) * y;
   }
 
   Rational& operator/=(const Rational& y){
-    d_value /= y.d_value;
-    return (*this);
+    return (*this) = (*this) / y;
   }
 
   bool isIntegral() const{
-    return getDenominator() == 1;
+    if(d_big == NULL) {
+      return d_den == 1;
+    }
+    return mpz_cmp_ui(d_big->get_den_mpz_t(), 1) == 0;
   }
 
   /** Returns a string representing the rational in the given base. */
   std::string toString(int base = 10) const {
-    return d_value.get_str(base);
+    return getMpq().get_str(base);
   }
 
   /**
@@ -305,8 +500,12 @@ public:
    * denominator.
    */
   size_t hash() const {
-    size_t numeratorHash = gmpz_hash(d_value.get_num_mpz_t());
-    size_t denominatorHash = gmpz_hash(d_value.get_den_mpz_t());
+    if(d_big == NULL) {
+      // agrees with gmpz_hash() on single limb values
+      return ((size_t)(d_num < 0 ? -d_num : d_num)) xor ((size_t)d_den);
+    }
+    size_t numeratorHash = gmpz_hash(d_big->get_num_mpz_t());
+    size_t denominatorHash = gmpz_hash(d_big->get_den_mpz_t());
 
     return numeratorHash xor denominatorHash;
   }
@@ -0,0 +1,16 @@
+; COMMAND-LINE: --approx-simplex
+; EXPECT: sat
+(set-logic QF_LRA)
+(declare-fun x () Real)
+(declare-fun y () Real)
+(declare-fun z () Real)
+(assert (>= x 0))
+(assert (>= y 0))
+(assert (= (+ (* 2 x) (* 3 y)) (/ 5 3)))
+(assert (>= (+ x y) (/ 1 3)))
+(assert (<= (- x y) (/ 1 7)))
+(assert (<= (+ (* 3 x) (* 7 y)) 10))
+(assert (= z (+ x (* (/ 1 3) y))))
+(assert (> z (/ 1 10)))
+(check-sat)
+(exit)
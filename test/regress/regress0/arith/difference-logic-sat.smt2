@@ -0,0 +1,14 @@
+; COMMAND-LINE: --dl-solver
+; EXPECT: sat
+(set-logic QF_RDL)
+(declare-fun s1 () Real)
+(declare-fun s2 () Real)
+(declare-fun s3 () Real)
+(declare-fun e () Real)
+(assert (>= s1 0))
+(assert (< (- s1 s2) (- 2)))
+(assert (or (< (- s2 s3) (- 3)) (< (- s3 s2) (- 1))))
+(assert (<= (- s3 e) (- 1)))
+(assert (<= e 5))
+(check-sat)
+(exit)
@@ -0,0 +1,11 @@
+; EXPECT: unsat
+(set-logic QF_IDL)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(declare-fun w () Int)
+(assert (< (- x y) 1))
+(assert (< (- y z) 1))
+(assert (or (>= (- x z) 1) (and (<= (- z w) (- 3)) (<= (- w x) 2))))
+(check-sat)
+(exit)
@@ -0,0 +1,14 @@
+; EXPECT: unsat
+(set-logic QF_LIA)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(declare-fun w () Int)
+(assert (= x y))
+(assert (= y z))
+(assert (= x z))
+(assert (>= x 0))
+(assert (<= x 10))
+(assert (= (+ (* 2 z) (* 4 w)) 3))
+(check-sat)
+(exit)
@@ -0,0 +1,16 @@
+; COMMAND-LINE: --gomory-cuts --branch-tightest
+; EXPECT: unsat
+(set-logic QF_LIA)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (>= x 0))
+(assert (<= x 100))
+(assert (>= y 0))
+(assert (<= y 100))
+(assert (>= (- (* 3 x) (* 3 y)) 1))
+(assert (<= (- (* 3 x) (* 3 y)) 2))
+(assert (>= (+ x y z) 5))
+(assert (<= (* 2 z) 7))
+(check-sat)
+(exit)
@@ -0,0 +1,12 @@
+; COMMAND-LINE: --lazy-unate-lemmas
+; EXPECT: unsat
+(set-logic QF_LRA)
+(declare-fun x () Real)
+(declare-fun y () Real)
+(assert (or (<= x 1.0) (<= x 3.0) (= x 5.0)))
+(assert (or (>= x 7.0) (= x 2.0) (>= y 4.0)))
+(assert (or (< y 2.0) (= y 6.0)))
+(assert (or (> x 4.0) (>= (+ x y) 10.0)))
+(assert (<= (+ x y) 3.0))
+(check-sat)
+(exit)
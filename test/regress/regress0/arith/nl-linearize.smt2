@@ -0,0 +1,10 @@
+; COMMAND-LINE: --nl-linearize
+; EXPECT: unsat
+(set-logic QF_NRA)
+(declare-fun x () Real)
+(declare-fun y () Real)
+(assert (or (< (* x x) 0.0)
+            (and (> (* x y) 0.0) (> x 0.0) (< y 0.0))
+            (and (>= x 1.0) (>= y 2.0) (< (* x y) 2.0))))
+(check-sat)
+(exit)
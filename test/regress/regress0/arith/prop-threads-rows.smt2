@@ -0,0 +1,153 @@
+; COMMAND-LINE: --prop-threads=2 --prop-row-length=64
+; EXPECT: unsat
+;; enough rows are propagated at once for the row bounds to be computed
+;; on two threads: x(i+1) = 1 - x(i), so x47 = 1 - x0 = 0.7 (the equalities
+;; are split into bounds so that they are not solved before the simplex)
+(set-logic QF_LRA)
+(declare-fun x0 () Real)
+(declare-fun x1 () Real)
+(declare-fun x2 () Real)
+(declare-fun x3 () Real)
+(declare-fun x4 () Real)
+(declare-fun x5 () Real)
+(declare-fun x6 () Real)
+(declare-fun x7 () Real)
+(declare-fun x8 () Real)
+(declare-fun x9 () Real)
+(declare-fun x10 () Real)
+(declare-fun x11 () Real)
+(declare-fun x12 () Real)
+(declare-fun x13 () Real)
+(declare-fun x14 () Real)
+(declare-fun x15 () Real)
+(declare-fun x16 () Real)
+(declare-fun x17 () Real)
+(declare-fun x18 () Real)
+(declare-fun x19 () Real)
+(declare-fun x20 () Real)
+(declare-fun x21 () Real)
+(declare-fun x22 () Real)
+(declare-fun x23 () Real)
+(declare-fun x24 () Real)
+(declare-fun x25 () Real)
+(declare-fun x26 () Real)
+(declare-fun x27 () Real)
+(declare-fun x28 () Real)
+(declare-fun x29 () Real)
+(declare-fun x30 () Real)
+(declare-fun x31 () Real)
+(declare-fun x32 () Real)
+(declare-fun x33 () Real)
+(declare-fun x34 () Real)
+(declare-fun x35 () Real)
+(declare-fun x36 () Real)
+(declare-fun x37 () Real)
+(declare-fun x38 () Real)
+(declare-fun x39 () Real)
+(declare-fun x40 () Real)
+(declare-fun x41 () Real)
+(declare-fun x42 () Real)
+(declare-fun x43 () Real)
+(declare-fun x44 () Real)
+(declare-fun x45 () Real)
+(declare-fun x46 () Real)
+(declare-fun x47 () Real)
+(assert (and (>= x0 0) (<= x0 1)))
+(assert (and (>= x1 0) (<= x1 1)))
+(assert (and (>= x2 0) (<= x2 1)))
+(assert (and (>= x3 0) (<= x3 1)))
+(assert (and (>= x4 0) (<= x4 1)))
+(assert (and (>= x5 0) (<= x5 1)))
+(assert (and (>= x6 0) (<= x6 1)))
+(assert (and (>= x7 0) (<= x7 1)))
+(assert (and (>= x8 0) (<= x8 1)))
+(assert (and (>= x9 0) (<= x9 1)))
+(assert (and (>= x10 0) (<= x10 1)))
+(assert (and (>= x11 0) (<= x11 1)))
+(assert (and (>= x12 0) (<= x12 1)))
+(assert (and (>= x13 0) (<= x13 1)))
+(assert (and (>= x14 0) (<= x14 1)))
+(assert (and (>= x15 0) (<= x15 1)))
+(assert (and (>= x16 0) (<= x16 1)))
+(assert (and (>= x17 0) (<= x17 1)))
+(assert (and (>= x18 0) (<= x18 1)))
+(assert (and (>= x19 0) (<= x19 1)))
+(assert (and (>= x20 0) (<= x20 1)))
+(assert (and (>= x21 0) (<= x21 1)))
+(assert (and (>= x22 0) (<= x22 1)))
+(assert (and (>= x23 0) (<= x23 1)))
+(assert (and (>= x24 0) (<= x24 1)))
+(assert (and (>= x25 0) (<= x25 1)))
+(assert (and (>= x26 0) (<= x26 1)))
+(assert (and (>= x27 0) (<= x27 1)))
+(assert (and (>= x28 0) (<= x28 1)))
+(assert (and (>= x29 0) (<= x29 1)))
+(assert (and (>= x30 0) (<= x30 1)))
+(assert (and (>= x31 0) (<= x31 1)))
+(assert (and (>= x32 0) (<= x32 1)))
+(assert (and (>= x33 0) (<= x33 1)))
+(assert (and (>= x34 0) (<= x34 1)))
+(assert (and (>= x35 0) (<= x35 1)))
+(assert (and (>= x36 0) (<= x36 1)))
+(assert (and (>= x37 0) (<= x37 1)))
+(assert (and (>= x38 0) (<= x38 1)))
+(assert (and (>= x39 0) (<= x39 1)))
+(assert (and (>= x40 0) (<= x40 1)))
+(assert (and (>= x41 0) (<= x41 1)))
+(assert (and (>= x42 0) (<= x42 1)))
+(assert (and (>= x43 0) (<= x43 1)))
+(assert (and (>= x44 0) (<= x44 1)))
+(assert (and (>= x45 0) (<= x45 1)))
+(assert (and (>= x46 0) (<= x46 1)))
+(assert (and (>= x47 0) (<= x47 1)))
+(assert (and (>= (+ x0 x1) 1) (<= (+ x0 x1) 1)))
+(assert (and (>= (+ x1 x2) 1) (<= (+ x1 x2) 1)))
+(assert (and (>= (+ x2 x3) 1) (<= (+ x2 x3) 1)))
+(assert (and (>= (+ x3 x4) 1) (<= (+ x3 x4) 1)))
+(assert (and (>= (+ x4 x5) 1) (<= (+ x4 x5) 1)))
+(assert (and (>= (+ x5 x6) 1) (<= (+ x5 x6) 1)))
+(assert (and (>= (+ x6 x7) 1) (<= (+ x6 x7) 1)))
+(assert (and (>= (+ x7 x8) 1) (<= (+ x7 x8) 1)))
+(assert (and (>= (+ x8 x9) 1) (<= (+ x8 x9) 1)))
+(assert (and (>= (+ x9 x10) 1) (<= (+ x9 x10) 1)))
+(assert (and (>= (+ x10 x11) 1) (<= (+ x10 x11) 1)))
+(assert (and (>= (+ x11 x12) 1) (<= (+ x11 x12) 1)))
+(assert (and (>= (+ x12 x13) 1) (<= (+ x12 x13) 1)))
+(assert (and (>= (+ x13 x14) 1) (<= (+ x13 x14) 1)))
+(assert (and (>= (+ x14 x15) 1) (<= (+ x14 x15) 1)))
+(assert (and (>= (+ x15 x16) 1) (<= (+ x15 x16) 1)))
+(assert (and (>= (+ x16 x17) 1) (<= (+ x16 x17) 1)))
+(assert (and (>= (+ x17 x18) 1) (<= (+ x17 x18) 1)))
+(assert (and (>= (+ x18 x19) 1) (<= (+ x18 x19) 1)))
+(assert (and (>= (+ x19 x20) 1) (<= (+ x19 x20) 1)))
+(assert (and (>= (+ x20 x21) 1) (<= (+ x20 x21) 1)))
+(assert (and (>= (+ x21 x22) 1) (<= (+ x21 x22) 1)))
+(assert (and (>= (+ x22 x23) 1) (<= (+ x22 x23) 1)))
+(assert (and (>= (+ x23 x24) 1) (<= (+ x23 x24) 1)))
+(assert (and (>= (+ x24 x25) 1) (<= (+ x24 x25) 1)))
+(assert (and (>= (+ x25 x26) 1) (<= (+ x25 x26) 1)))
+(assert (and (>= (+ x26 x27) 1) (<= (+ x26 x27) 1)))
+(assert (and (>= (+ x27 x28) 1) (<= (+ x27 x28) 1)))
+(assert (and (>= (+ x28 x29) 1) (<= (+ x28 x29) 1)))
+(assert (and (>= (+ x29 x30) 1) (<= (+ x29 x30) 1)))
+(assert (and (>= (+ x30 x31) 1) (<= (+ x30 x31) 1)))
+(assert (and (>= (+ x31 x32) 1) (<= (+ x31 x32) 1)))
+(assert (and (>= (+ x32 x33) 1) (<= (+ x32 x33) 1)))
+(assert (and (>= (+ x33 x34) 1) (<= (+ x33 x34) 1)))
+(assert (and (>= (+ x34 x35) 1) (<= (+ x34 x35) 1)))
+(assert (and (>= (+ x35 x36) 1) (<= (+ x35 x36) 1)))
+(assert (and (>= (+ x36 x37) 1) (<= (+ x36 x37) 1)))
+(assert (and (>= (+ x37 x38) 1) (<= (+ x37 x38) 1)))
+(assert (and (>= (+ x38 x39) 1) (<= (+ x38 x39) 1)))
+(assert (and (>= (+ x39 x40) 1) (<= (+ x39 x40) 1)))
+(assert (and (>= (+ x40 x41) 1) (<= (+ x40 x41) 1)))
+(assert (and (>= (+ x41 x42) 1) (<= (+ x41 x42) 1)))
+(assert (and (>= (+ x42 x43) 1) (<= (+ x42 x43) 1)))
+(assert (and (>= (+ x43 x44) 1) (<= (+ x43 x44) 1)))
+(assert (and (>= (+ x44 x45) 1) (<= (+ x44 x45) 1)))
+(assert (and (>= (+ x45 x46) 1) (<= (+ x45 x46) 1)))
+(assert (and (>= (+ x46 x47) 1) (<= (+ x46 x47) 1)))
+(assert (and (>= x0 (/ 3 10)) (<= x0 (/ 3 10))))
+(assert (<= x47 (/ 1 2)))
+(check-sat)
+(exit)
@@ -0,0 +1,16 @@
+; COMMAND-LINE: --prop-threads=2 --prop-row-length=64
+; EXPECT: unsat
+(set-logic QF_LRA)
+(declare-fun a () Real)
+(declare-fun b () Real)
+(declare-fun c () Real)
+(declare-fun d () Real)
+(declare-fun e () Real)
+(assert (and (>= a 0) (<= a 1)))
+(assert (and (>= b 0) (<= b 1)))
+(assert (and (>= c 0) (<= c 1)))
+(assert (and (>= d 0) (<= d 1)))
+(assert (and (>= e 0) (<= e 1)))
+(assert (or (>= (+ a b c d e) 6) (<= (- (+ a b) (+ c d e)) (- 4))))
+(check-sat)
+(exit)
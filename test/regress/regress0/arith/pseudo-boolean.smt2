@@ -0,0 +1,13 @@
+; COMMAND-LINE: --pb-propagation
+; EXPECT: unsat
+(set-logic QF_LIA)
+(declare-fun a () Bool)
+(declare-fun b () Bool)
+(declare-fun c () Bool)
+(declare-fun d () Bool)
+(define-fun one ((p Bool)) Int (ite p 1 0))
+(assert (>= (+ (one a) (one b) (one c) (one d)) 3))
+(assert (<= (+ (* 2 (one a)) (* 3 (one b)) (one c)) 3))
+(assert (or (not c) (not d)))
+(check-sat)
+(exit)
@@ -0,0 +1,13 @@
+; COMMAND-LINE: --bv-abstract-mult
+; EXPECT: sat
+; EXIT: 10
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 32))
+(assert (bvugt x #x00000001))
+(assert (bvugt y #x00000001))
+(assert (bvult x #x00000010))
+(assert (bvult y #x00000010))
+(assert (= (bvmul x y) #x00000006))
+(check-sat)
+(exit)
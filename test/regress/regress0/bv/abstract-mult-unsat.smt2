@@ -0,0 +1,14 @@
+; COMMAND-LINE: --bv-abstract-mult
+; EXPECT: unsat
+; EXIT: 20
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 32))
+(declare-fun z () (_ BitVec 32))
+(assert (bvult x #x00000008))
+(assert (bvult y #x00000008))
+(assert (= (bvmul x y) #x00000040))
+(assert (bvugt z #x00000000))
+(assert (bvuge (bvurem x z) z))
+(check-sat)
+(exit)
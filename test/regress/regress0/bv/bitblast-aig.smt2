@@ -0,0 +1,14 @@
+; COMMAND-LINE: --bitblast-aig
+; EXPECT: unsat
+; EXIT: 20
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(declare-fun z () (_ BitVec 8))
+(assert (= z (bvxor x y)))
+(assert (or (not (= (bvadd x y) (bvadd y x)))
+            (not (= (bvmul x y) (bvmul y x)))
+            (not (= (bvxor z y) x))
+            (bvult (bvand x y) (bvand (bvand x y) x))))
+(check-sat)
+(exit)
@@ -0,0 +1,24 @@
+; COMMAND-LINE: --incremental --bv-minimize-cores --bv-cache-cores
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXIT: 20
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 16))
+(declare-fun y () (_ BitVec 16))
+(declare-fun z () (_ BitVec 16))
+(assert (bvult z #x0100))
+(assert (= (bvand y #x00ff) #x0011))
+(check-sat)
+(push 1)
+(assert (= (bvmul x #x0003) #x0009))
+(assert (= (bvadd x y) #x0014))
+(assert (bvugt y #x0011))
+(check-sat)
+(pop 1)
+(assert (= (bvmul x #x0003) #x0009))
+(check-sat)
+(assert (= (bvadd x y) #x0014))
+(assert (bvugt y #x0011))
+(check-sat)
@@ -0,0 +1,11 @@
+; COMMAND-LINE: --bv-propagation-solver
+; EXPECT: unsat
+; EXIT: 20
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(assert (= ((_ extract 7 4) x) #x3))
+(assert (bvult y #x10))
+(assert (bvult (bvadd (concat #x0 ((_ extract 3 0) y)) x) #x20))
+(check-sat)
+(exit)
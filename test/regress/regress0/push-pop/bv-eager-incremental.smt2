@@ -0,0 +1,25 @@
+; COMMAND-LINE: --incremental --bitblast-eager
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXIT: 10
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(assert (= (bvadd x y) #x0a))
+(check-sat)
+(push 1)
+(assert (= x #x03))
+(assert (= y #x03))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= x #x03))
+(check-sat)
+(assert (not (= y #x07)))
+(check-sat)
+(pop 1)
+(assert (bvult x #x03))
+(check-sat)
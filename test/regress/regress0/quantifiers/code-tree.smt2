@@ -0,0 +1,18 @@
+; COMMAND-LINE: --quant-code-tree
+; EXPECT: unsat
+(set-logic UF)
+(set-info :status unsat)
+(declare-sort U 0)
+(declare-fun f (U U) U)
+(declare-fun g (U) U)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun d () U)
+(declare-fun P (U) Bool)
+(assert (forall ((x U) (y U)) (P (f x (g y)))))
+(assert (forall ((z U)) (not (P (f z (g a))))))
+(assert (= c (g b)))
+(assert (= d (f c c)))
+(assert (= b a))
+(check-sat)
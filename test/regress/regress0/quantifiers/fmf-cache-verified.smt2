@@ -0,0 +1,14 @@
+; COMMAND-LINE: --finite-model-find --fmf-cache-verified
+; EXPECT: sat
+(set-logic UF)
+(set-info :status sat)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(assert (not (= a b)))
+(assert (forall ((x U)) (or (= x a) (= x b))))
+(assert (forall ((x U)) (not (= (f x) x))))
+(assert (forall ((x U)) (= (P x) (not (P (f x))))))
+(check-sat)
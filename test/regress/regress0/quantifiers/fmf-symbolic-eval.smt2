@@ -0,0 +1,15 @@
+; COMMAND-LINE: --finite-model-find --fmf-symbolic-eval
+; EXPECT: sat
+(set-logic UF)
+(set-info :status sat)
+(declare-sort U 0)
+(declare-fun f (U U) U)
+(declare-fun R (U U U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(assert (not (= a b)))
+(assert (forall ((x U)) (or (= x a) (= x b))))
+(assert (forall ((x U) (y U)) (= (f x y) a)))
+(assert (forall ((x U) (y U) (z U)) (or (not (R x y z)) (= (f x z) a))))
+(assert (R a b a))
+(check-sat)
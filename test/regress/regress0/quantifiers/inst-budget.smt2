@@ -0,0 +1,15 @@
+; COMMAND-LINE: --inst-budget=2
+; EXPECT: unsat
+(set-logic UF)
+(set-info :status unsat)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(assert (forall ((x U)) (P (f x))))
+(assert (forall ((x U)) (=> (P x) (P (f (f x))))))
+(assert (forall ((x U) (y U)) (=> (= (f x) (f y)) (= x y))))
+(assert (= (f a) (f b)))
+(assert (or (not (P (f (f (f a))))) (not (= a b))))
+(check-sat)
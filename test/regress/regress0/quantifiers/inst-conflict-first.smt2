@@ -0,0 +1,21 @@
+; COMMAND-LINE: --inst-conflict-first
+; EXPECT: unsat
+(set-logic UF)
+(set-info :status unsat)
+(declare-sort U 0)
+(declare-fun f (U U) U)
+(declare-fun P (U) Bool)
+(declare-fun Q (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun d () U)
+(declare-fun e () U)
+; many instances of the quantifier match, only the one for (f a b) is in
+; conflict, and it alone closes the proof
+(assert (forall ((x U) (y U)) (or (P (f x y)) (Q y))))
+(assert (not (P (f a b))))
+(assert (not (Q b)))
+(assert (distinct (f a a) (f a c) (f b c) (f c d) (f d e) (f e a)))
+(assert (distinct (f b b) (f c c) (f d d) (f e e) (f b a) (f d c)))
+(check-sat)
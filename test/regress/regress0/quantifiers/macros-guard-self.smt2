@@ -0,0 +1,13 @@
+; COMMAND-LINE: --macros-quant
+; EXPECT: unsat
+;; the guard of the definition of f mentions f, so it is not a macro
+(set-logic UFLIA)
+(set-info :status unsat)
+(declare-fun f (Int) Int)
+(declare-fun s (Int) Int)
+(declare-fun P (Int) Bool)
+(declare-fun a () Int)
+(assert (forall ((x Int)) (or (P (f x)) (= (f x) (s x)))))
+(assert (not (P (f a))))
+(assert (not (= (f a) (s a))))
+(check-sat)
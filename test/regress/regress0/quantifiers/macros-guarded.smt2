@@ -0,0 +1,15 @@
+; COMMAND-LINE: --macros-quant
+; EXPECT: unsat
+;; f is defined using g, and h by a guarded definition
+(set-logic UFLIA)
+(set-info :status unsat)
+(declare-fun f (Int) Int)
+(declare-fun g (Int) Int)
+(declare-fun h (Int) Int)
+(declare-fun a () Int)
+(assert (forall ((x Int)) (= (f x) (+ (g x) 1))))
+(assert (forall ((x Int)) (= (g x) (* 2 x))))
+(assert (forall ((x Int)) (=> (> x 0) (= (h x) (f x)))))
+(assert (> a 0))
+(assert (not (= (h a) (+ (* 2 a) 1))))
+(check-sat)
@@ -0,0 +1,28 @@
+; COMMAND-LINE: --rr-code-tree
+; EXPECT: unsat
+;; length_trick.smt2 with the rules matched by the code tree, and a
+;; guarded rule
+
+(set-logic AUFLIA)
+(set-info :status unsat)
+
+(declare-sort list 0)
+
+(declare-fun cons (Int list) list)
+(declare-fun nil  ()         list)
+
+(declare-fun length (list) Int)
+(declare-fun pos (list) Bool)
+
+(assert (= (length nil) 0))
+
+(assert (forall ((?e Int) (?l list)) (! (= (length (cons ?e ?l)) (+ (length ?l) 1)) :rewrite-rule)))
+
+(assert (forall ((?e Int) (?l list)) (! (=> (> ?e 0) (= (pos (cons ?e ?l)) true)) :rewrite-rule)))
+
+(assert (or (not (= (length (cons 1 (cons  2 (cons 3 nil)))) 3))
+            (not (pos (cons 2 nil)))))
+
+(check-sat)
+
+(exit)
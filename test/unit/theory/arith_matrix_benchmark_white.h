@@ -0,0 +1,135 @@
+/*********************                                                        */
+/*! \file arith_matrix_benchmark_white.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Timing of the row operations of the arithmetic Tableau.
+ **
+ ** Timing of pivot() and rowPlusRowTimesConstant() on a random sparse
+ ** tableau.  This is not part of "make check"; build and run it with
+ ** "make theory/arith_matrix_benchmark_white" in test/unit.  The number of
+ ** rows is taken from CVC4_MATRIX_BENCHMARK (default 50).
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include "theory/arith/matrix.h"
+#include "util/rational.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::arith;
+using namespace std;
+
+/** Exposes the row addition of the Tableau to the benchmark. */
+class BenchmarkTableau : public Tableau {
+public:
+  void rowPlusRowTimesConstant(RowIndex to, const Rational& c, RowIndex from){
+    loadRowIntoBuffer(from);
+    rowPlusBufferTimesConstant(to, c);
+    clearBuffer();
+  }
+};
+
+class ArithMatrixBenchmarkWhite : public CxxTest::TestSuite {
+
+  BenchmarkTableau* d_tableau;
+  vector<ArithVar> d_basics;
+
+  /** Returns a nonbasic variable on the row of basic, or ARITHVAR_SENTINEL. */
+  ArithVar someNonbasicOnRow(ArithVar basic, unsigned skip){
+    const RowVector<Rational>& row = d_tableau->getRow(d_tableau->basicToRowIndex(basic));
+    vector<ArithVar> candidates;
+    for(RowVector<Rational>::const_iterator i = row.begin(); !i.atEnd(); ++i){
+      if((*i).getColVar() != basic){
+        candidates.push_back((*i).getColVar());
+      }
+    }
+    return candidates.empty() ? ARITHVAR_SENTINEL : candidates[skip % candidates.size()];
+  }
+
+  /**
+   * Builds a random tableau with the given number of rows over twice as
+   * many structural variables, each row having about density entries.
+   */
+  void randomTableau(uint32_t rows, uint32_t density){
+    uint32_t structural = 2 * rows;
+    for(uint32_t i = 0; i < structural + rows; ++i){
+      d_tableau->increaseSize();
+    }
+    for(uint32_t r = 0; r < rows; ++r){
+      vector<Rational> coeffs;
+      vector<ArithVar> vars;
+      for(uint32_t v = 0; v < structural; ++v){
+        if(rand() % structural < density){
+          vars.push_back(v);
+          int n = rand() % 19 - 9;
+          coeffs.push_back(Rational(n == 0 ? 1 : n, rand() % 5 + 1));
+        }
+      }
+      if(vars.empty()){
+        vars.push_back(r);
+        coeffs.push_back(Rational(1));
+      }
+      d_tableau->addRow(structural + r, coeffs, vars);
+      d_basics.push_back(structural + r);
+    }
+  }
+
+public:
+
+  void setUp() {
+    srand(1);
+    d_tableau = new BenchmarkTableau();
+  }
+
+  void tearDown() {
+    delete d_tableau;
+    d_basics.clear();
+  }
+
+  void testBenchmarkRowOperations() {
+    const char* size = getenv("CVC4_MATRIX_BENCHMARK");
+    uint32_t rows = size == NULL ? 50 : atoi(size);
+    uint32_t pivots = 4 * rows;
+    randomTableau(rows, 8);
+
+    clock_t start = clock();
+    for(unsigned p = 0; p < pivots; ++p){
+      ArithVar oldBasic = d_basics[rand() % d_basics.size()];
+      ArithVar newBasic = someNonbasicOnRow(oldBasic, rand());
+      if(newBasic == ARITHVAR_SENTINEL){ continue; }
+      d_tableau->pivot(oldBasic, newBasic);
+      for(unsigned k = 0; k < d_basics.size(); ++k){
+        if(d_basics[k] == oldBasic){ d_basics[k] = newBasic; }
+      }
+    }
+    clock_t pivotTime = clock() - start;
+
+    start = clock();
+    for(unsigned k = 0; k < pivots; ++k){
+      RowIndex to = d_tableau->basicToRowIndex(d_basics[rand() % d_basics.size()]);
+      RowIndex from = d_tableau->basicToRowIndex(d_basics[rand() % d_basics.size()]);
+      if(to != from){
+        d_tableau->rowPlusRowTimesConstant(to, Rational(rand() % 7 + 1, 3), from);
+      }
+    }
+    clock_t rowTime = clock() - start;
+
+    cout << endl << "tableau " << rows << " rows, " << d_tableau->size() << " entries: "
+         << pivots << " pivots in " << double(pivotTime) / CLOCKS_PER_SEC << "s, "
+         << pivots << " row additions in " << double(rowTime) / CLOCKS_PER_SEC << "s"
+         << endl;
+  }
+};
@@ -0,0 +1,281 @@
+/*********************                                                        */
+/*! \file arith_matrix_white.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief White box testing of the arithmetic Tableau.
+ **
+ ** White box testing of the arithmetic Tableau. The sparse rows are checked
+ ** against a dense copy after every pivot.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include "theory/arith/matrix.h"
+#include "util/rational.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::arith;
+using namespace std;
+
+/** Exposes the row operations of the Tableau to the tests. */
+class TestTableau : public Tableau {
+public:
+  void rowPlusRowTimesConstant(RowIndex to, const Rational& c, RowIndex from){
+    loadRowIntoBuffer(from);
+    rowPlusBufferTimesConstant(to, c);
+    clearBuffer();
+  }
+
+  bool consistent() const {
+    uint32_t rowEntries = 0;
+    for(RowIndex r = 0; r < getNumRows(); ++r){
+      for(RowIterator i = getRow(r).begin(); !i.atEnd(); ++i){
+        const Entry& entry = *i;
+        if(entry.getRowIndex() != r || entry.getCoefficient().isZero()){
+          return false;
+        }
+        // the column occurrence must point back at this entry
+        const MatrixPosition& pos = getColumn(entry.getColVar())[entry.getColOffset()];
+        if(pos.d_rowIndex != r || pos.d_rowOffset != i.getOffset()){
+          return false;
+        }
+        ++rowEntries;
+      }
+    }
+    uint32_t colEntries = 0;
+    for(ArithVar v = 0; v < getNumColumns(); ++v){
+      for(ColIterator i = colIterator(v); !i.atEnd(); ++i){
+        if((*i).getColVar() != v){
+          return false;
+        }
+        ++colEntries;
+      }
+    }
+    return rowEntries == size() && colEntries == size();
+  }
+};
+
+class ArithMatrixWhite : public CxxTest::TestSuite {
+
+  typedef vector< vector<Rational> > DenseRows;
+
+  TestTableau* d_tableau;
+
+  /** Dense copy of the tableau, indexed by basic variable and then column. */
+  vector<ArithVar> d_basics;
+  DenseRows d_dense;
+
+  void declare(uint32_t n){
+    for(uint32_t i = 0; i < n; ++i){
+      d_tableau->increaseSize();
+    }
+  }
+
+  /** Adds the row basic = sum coeffs[i]*vars[i] and its dense copy. */
+  void addRow(ArithVar basic, const vector<Rational>& coeffs, const vector<ArithVar>& vars){
+    d_tableau->addRow(basic, coeffs, vars);
+    vector<Rational> dense(d_tableau->getNumColumns(), Rational(0));
+    for(unsigned i = 0; i < vars.size(); ++i){
+      dense[vars[i]] = coeffs[i];
+    }
+    dense[basic] = Rational(-1);
+    d_basics.push_back(basic);
+    d_dense.push_back(dense);
+  }
+
+  void densePivot(ArithVar oldBasic, ArithVar newBasic){
+    unsigned r = 0;
+    while(d_basics[r] != oldBasic){ ++r; }
+    Rational scale = -(d_dense[r][newBasic].inverse());
+    for(unsigned j = 0; j < d_dense[r].size(); ++j){
+      d_dense[r][j] *= scale;
+    }
+    for(unsigned k = 0; k < d_dense.size(); ++k){
+      Rational c = d_dense[k][newBasic];
+      if(k != r && !c.isZero()){
+        for(unsigned j = 0; j < d_dense[k].size(); ++j){
+          d_dense[k][j] += c * d_dense[r][j];
+        }
+      }
+    }
+    d_basics[r] = newBasic;
+  }
+
+  bool matchesDense() const {
+    for(unsigned r = 0; r < d_basics.size(); ++r){
+      RowIndex ridx = d_tableau->basicToRowIndex(d_basics[r]);
+      uint32_t nonzeros = 0;
+      for(ArithVar v = 0; v < d_dense[r].size(); ++v){
+        if(!d_dense[r][v].isZero()){
+          ++nonzeros;
+          const Tableau::Entry& entry = d_tableau->findEntry(ridx, v);
+          if(entry.blank() || entry.getCoefficient() != d_dense[r][v]){
+            return false;
+          }
+        }
+      }
+      if(nonzeros != d_tableau->getRowLength(ridx)){
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Returns a nonbasic variable on the row of basic, or ARITHVAR_SENTINEL. */
+  ArithVar someNonbasicOnRow(ArithVar basic, unsigned skip){
+    const RowVector<Rational>& row = d_tableau->getRow(d_tableau->basicToRowIndex(basic));
+    vector<ArithVar> candidates;
+    for(RowVector<Rational>::const_iterator i = row.begin(); !i.atEnd(); ++i){
+      if((*i).getColVar() != basic){
+        candidates.push_back((*i).getColVar());
+      }
+    }
+    return candidates.empty() ? ARITHVAR_SENTINEL : candidates[skip % candidates.size()];
+  }
+
+  /**
+   * Builds a random tableau with the given number of rows over twice as
+   * many structural variables, each row having about density entries.
+   */
+  void randomTableau(uint32_t rows, uint32_t density, bool keepDense){
+    uint32_t structural = 2 * rows;
+    declare(structural + rows);
+    for(uint32_t r = 0; r < rows; ++r){
+      vector<Rational> coeffs;
+      vector<ArithVar> vars;
+      for(uint32_t v = 0; v < structural; ++v){
+        if(rand() % structural < density){
+          vars.push_back(v);
+          int n = rand() % 19 - 9;
+          coeffs.push_back(Rational(n == 0 ? 1 : n, rand() % 5 + 1));
+        }
+      }
+      if(vars.empty()){
+        vars.push_back(r);
+        coeffs.push_back(Rational(1));
+      }
+      if(keepDense){
+        addRow(structural + r, coeffs, vars);
+      }else{
+        d_tableau->addRow(structural + r, coeffs, vars);
+        d_basics.push_back(structural + r);
+      }
+    }
+  }
+
+public:
+
+  void setUp() {
+    srand(1);
+    d_tableau = new TestTableau();
+  }
+
+  void tearDown() {
+    delete d_tableau;
+    d_basics.clear();
+    d_dense.clear();
+  }
+
+  void testAddRow() {
+    declare(4);
+    vector<Rational> coeffs;
+    vector<ArithVar> vars;
+    coeffs.push_back(Rational(2)); vars.push_back(0);
+    coeffs.push_back(Rational(-1, 3)); vars.push_back(1);
+    addRow(3, coeffs, vars);
+
+    TS_ASSERT(d_tableau->isBasic(3));
+    TS_ASSERT_EQUALS(d_tableau->size(), 3u);
+    TS_ASSERT_EQUALS(d_tableau->getColLength(0), 1u);
+    TS_ASSERT_EQUALS(d_tableau->getColLength(2), 0u);
+    TS_ASSERT(d_tableau->findEntry(d_tableau->basicToRowIndex(3), 2).blank());
+    TS_ASSERT(matchesDense());
+    TS_ASSERT(d_tableau->consistent());
+  }
+
+  void testRowOperationsCancel() {
+    declare(5);
+    vector<Rational> coeffs;
+    vector<ArithVar> vars;
+    coeffs.push_back(Rational(1)); vars.push_back(0);
+    coeffs.push_back(Rational(2)); vars.push_back(1);
+    d_tableau->addRow(3, coeffs, vars);
+    coeffs.clear(); vars.clear();
+    coeffs.push_back(Rational(2)); vars.push_back(0);
+    coeffs.push_back(Rational(1)); vars.push_back(2);
+    d_tableau->addRow(4, coeffs, vars);
+
+    // row(4) - 2*row(3) cancels x_0 and brings in x_1 and x_3
+    RowIndex r3 = d_tableau->basicToRowIndex(3);
+    RowIndex r4 = d_tableau->basicToRowIndex(4);
+    d_tableau->rowPlusRowTimesConstant(r4, Rational(-2), r3);
+
+    TS_ASSERT(d_tableau->findEntry(r4, 0).blank());
+    TS_ASSERT_EQUALS(d_tableau->findEntry(r4, 1).getCoefficient(), Rational(-4));
+    TS_ASSERT_EQUALS(d_tableau->findEntry(r4, 3).getCoefficient(), Rational(2));
+    TS_ASSERT_EQUALS(d_tableau->getRowLength(r4), 4u);
+    TS_ASSERT_EQUALS(d_tableau->getColLength(0), 1u);
+    TS_ASSERT(d_tableau->consistent());
+  }
+
+  void testPivotsMatchDenseTableau() {
+    randomTableau(12, 4, true);
+    TS_ASSERT(matchesDense());
+    for(unsigned p = 0; p < 200; ++p){
+      ArithVar oldBasic = d_basics[rand() % d_basics.size()];
+      ArithVar newBasic = someNonbasicOnRow(oldBasic, rand());
+      if(newBasic == ARITHVAR_SENTINEL){ continue; }
+      d_tableau->pivot(oldBasic, newBasic);
+      densePivot(oldBasic, newBasic);
+      TS_ASSERT(d_tableau->isBasic(newBasic));
+      TS_ASSERT(!d_tableau->isBasic(oldBasic));
+      TS_ASSERT_EQUALS(d_tableau->getColLength(newBasic), 1u);
+    }
+    TS_ASSERT(matchesDense());
+    TS_ASSERT(d_tableau->consistent());
+  }
+
+  void testCopyIsIndependent() {
+    randomTableau(8, 3, true);
+    Tableau copy = *d_tableau;
+    DenseRows copyDense = d_dense;
+    vector<ArithVar> copyBasics = d_basics;
+    for(unsigned p = 0; p < 20; ++p){
+      ArithVar oldBasic = d_basics[p % d_basics.size()];
+      ArithVar newBasic = someNonbasicOnRow(oldBasic, p);
+      if(newBasic == ARITHVAR_SENTINEL){ continue; }
+      d_tableau->pivot(oldBasic, newBasic);
+      densePivot(oldBasic, newBasic);
+    }
+    TS_ASSERT(matchesDense());
+
+    Tableau& restored = *d_tableau;
+    restored = copy;
+    d_dense = copyDense;
+    d_basics = copyBasics;
+    TS_ASSERT(matchesDense());
+    TS_ASSERT(d_tableau->consistent());
+  }
+
+  void testRemoveBasicRow() {
+    randomTableau(6, 3, false);
+    uint32_t before = d_tableau->size();
+    RowIndex r = d_tableau->basicToRowIndex(d_basics[0]);
+    uint32_t length = d_tableau->getRowLength(r);
+    d_tableau->removeBasicRow(d_basics[0]);
+    TS_ASSERT_EQUALS(d_tableau->size(), before - length);
+    TS_ASSERT(!d_tableau->isBasic(d_basics[0]));
+    TS_ASSERT(d_tableau->consistent());
+  }
+};
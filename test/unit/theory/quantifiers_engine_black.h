@@ -0,0 +1,130 @@
+/*********************                                                        */
+/*! \file quantifiers_engine_black.h
+ ** \verbatim
+ ** Original author: agent
+ ** Major contributors: none
+ ** Minor contributors (to current version): none
+ ** This file is part of the CVC4 prototype.
+ ** Copyright (c) 2009-2012  New York University and The University of Iowa
+ ** See the file COPYING in the top-level source directory for licensing
+ ** information.\endverbatim
+ **
+ ** \brief Black box testing of CVC4::theory::QuantifiersEngine
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <vector>
+
+#include "expr/expr.h"
+#include "expr/expr_manager.h"
+#include "options/options.h"
+#include "smt/smt_engine.h"
+#include "theory/quantifiers/options.h"
+#include "util/configuration.h"
+#include "util/result.h"
+#include "util/sexpr.h"
+
+using namespace CVC4;
+using namespace CVC4::kind;
+using namespace std;
+
+class QuantifiersEngineBlack : public CxxTest::TestSuite {
+private:
+
+  Options d_options;
+  ExprManager* d_em;
+  SmtEngine* d_smt;
+  Type d_u;
+  Type d_pred;
+
+  int getIntStat(const std::string& name) {
+    SExpr s = d_smt->getStatistic(name);
+    TS_ASSERT(s.isInteger());
+    return s.getIntegerValue().getLong();
+  }
+
+  Expr mkForall(Expr x, Expr body) {
+    vector<Expr> vars;
+    vars.push_back(x);
+    return d_em->mkExpr(FORALL, d_em->mkExpr(BOUND_VAR_LIST, vars), body);
+  }
+
+public:
+
+  void setUp() {
+    d_options.set(options::instConflictFirst, true);
+    d_em = new ExprManager(d_options);
+    d_smt = new SmtEngine(d_em);
+    d_smt->setLogic("UF");
+    d_u = d_em->mkSort("U");
+    d_pred = d_em->mkFunctionType(d_u, d_em->booleanType());
+  }
+
+  void tearDown() {
+    delete d_smt;
+    delete d_em;
+  }
+
+  /* Only instances in conflict are added, and the one for a closes the proof. */
+  void testConflictingInstance() {
+    if(!Configuration::isStatisticsBuild()) {
+      return;
+    }
+    Expr p = d_em->mkVar("P", d_pred);
+    Expr a = d_em->mkVar("a", d_u);
+    Expr b = d_em->mkVar("b", d_u);
+    Expr c = d_em->mkVar("c", d_u);
+    Expr x = d_em->mkBoundVar("x", d_u);
+    d_smt->assertFormula(mkForall(x, d_em->mkExpr(APPLY_UF, p, x)));
+    d_smt->assertFormula(d_em->mkExpr(NOT, d_em->mkExpr(APPLY_UF, p, a)));
+    d_smt->assertFormula(d_em->mkExpr(OR, d_em->mkExpr(APPLY_UF, p, b),
+                                          d_em->mkExpr(APPLY_UF, p, c)));
+    TS_ASSERT_EQUALS(d_smt->checkSat().isSat(), Result::UNSAT);
+    int numConflict = getIntStat("QuantifiersEngine::Inst_Conflict");
+    TS_ASSERT_LESS_THAN_EQUALS(1, numConflict);
+    TS_ASSERT_LESS_THAN_EQUALS(getIntStat("QuantifiersEngine::Instantiations_Total"), numConflict);
+  }
+
+  /* The instance for a propagates S(a), whose instance of the second
+     quantifier is then in conflict. */
+  void testPropagatingInstance() {
+    if(!Configuration::isStatisticsBuild()) {
+      return;
+    }
+    Expr q = d_em->mkVar("Q", d_pred);
+    Expr s = d_em->mkVar("S", d_pred);
+    Expr a = d_em->mkVar("a", d_u);
+    Expr x = d_em->mkBoundVar("x", d_u);
+    Expr y = d_em->mkBoundVar("y", d_u);
+    d_smt->assertFormula(mkForall(x, d_em->mkExpr(OR,
+                                                  d_em->mkExpr(NOT, d_em->mkExpr(APPLY_UF, q, x)),
+                                                  d_em->mkExpr(APPLY_UF, s, x))));
+    d_smt->assertFormula(mkForall(y, d_em->mkExpr(NOT, d_em->mkExpr(APPLY_UF, s, y))));
+    d_smt->assertFormula(d_em->mkExpr(APPLY_UF, q, a));
+    TS_ASSERT_EQUALS(d_smt->checkSat().isSat(), Result::UNSAT);
+    TS_ASSERT_LESS_THAN_EQUALS(1, getIntStat("QuantifiersEngine::Inst_Propagate"));
+  }
+
+  /* The instance for a is unknown, but is not a clause, so it neither
+     conflicts nor propagates. */
+  void testNonClausalInstance() {
+    if(!Configuration::isStatisticsBuild()) {
+      return;
+    }
+    Expr p = d_em->mkVar("P", d_pred);
+    Expr q = d_em->mkVar("Q", d_pred);
+    Expr r = d_em->mkVar("R", d_pred);
+    Expr a = d_em->mkVar("a", d_u);
+    Expr x = d_em->mkBoundVar("x", d_u);
+    d_smt->assertFormula(mkForall(x, d_em->mkExpr(IFF,
+                                                  d_em->mkExpr(APPLY_UF, p, x),
+                                                  d_em->mkExpr(APPLY_UF, q, x))));
+    d_smt->assertFormula(d_em->mkExpr(OR, d_em->mkExpr(APPLY_UF, p, a),
+                                          d_em->mkExpr(APPLY_UF, r, a)));
+    d_smt->checkSat();
+    TS_ASSERT_LESS_THAN_EQUALS(1, getIntStat("QuantifiersEngine::Instantiations_Total"));
+    TS_ASSERT_EQUALS(getIntStat("QuantifiersEngine::Inst_Propagate"), 0);
+  }
+
+};/* class QuantifiersEngineBlack */
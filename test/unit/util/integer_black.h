@@ -314,6 +314,20 @@ public:
     TS_ASSERT_EQUALS( Integer(-1000), Integer(-10).pow(3) );
   }
 
+  void testGcd() {
+    TS_ASSERT_EQUALS( Integer(6), Integer(12).gcd(Integer(18)) );
+    TS_ASSERT_EQUALS( Integer(6), Integer(-12).gcd(Integer(18)) );
+    TS_ASSERT_EQUALS( Integer(6), Integer(12).gcd(Integer(-18)) );
+    TS_ASSERT_EQUALS( Integer(5), Integer(0).gcd(Integer(-5)) );
+    TS_ASSERT_EQUALS( Integer(5), Integer(-5).gcd(Integer(0)) );
+    TS_ASSERT_EQUALS( Integer(0), Integer(0).gcd(Integer(0)) );
+
+    Integer big = Integer(2).pow(100) * Integer(3);
+    TS_ASSERT_EQUALS( Integer(3), big.gcd(Integer(9)) );
+    TS_ASSERT_EQUALS( Integer(3), Integer(9).gcd(big) );
+    TS_ASSERT_EQUALS( big, big.gcd(-big) );
+  }
+
   void testOverlyLong() {
     unsigned long ul = numeric_limits<unsigned long>::max();
     Integer i(ul);
@@ -44,4 +44,31 @@ public:
     TS_ASSERT_THROWS( Rational::fromDecimal("Hello, world!");, const std::invalid_argument& );
   }
 
+  void testArithmeticAcrossWordSize() {
+    // values around the largest numerators and denominators kept in machine words
+    Rational large(2147483647, 1);
+    Rational larger = large + Rational(1, 1);
+    TS_ASSERT_EQUALS( larger, Rational("2147483648") );
+    TS_ASSERT_EQUALS( larger - Rational(1, 1), large );
+    TS_ASSERT_EQUALS( (larger - large).hash(), Rational(1, 1).hash() );
+
+    Rational product = large * large;
+    TS_ASSERT_EQUALS( product, Rational("4611686014132420609") );
+    TS_ASSERT_EQUALS( product / large, large );
+    TS_ASSERT( product > large );
+    TS_ASSERT( -product < -large );
+
+    Rational smallFraction(1, 2147483647);
+    TS_ASSERT_EQUALS( smallFraction * smallFraction, Rational("1/4611686014132420609") );
+    TS_ASSERT_EQUALS( (smallFraction * smallFraction) * product, Rational(1, 1) );
+    TS_ASSERT_EQUALS( smallFraction.inverse(), large );
+
+    TS_ASSERT_EQUALS( Rational(-7, 2).floor(), Integer(-4) );
+    TS_ASSERT_EQUALS( Rational(-7, 2).ceiling(), Integer(-3) );
+    TS_ASSERT_EQUALS( Rational(7, 2).floor(), Integer(3) );
+    TS_ASSERT_EQUALS( Rational(7, 2).ceiling(), Integer(4) );
+    TS_ASSERT_EQUALS( Rational(6, -4), Rational(-3, 2) );
+    TS_ASSERT_EQUALS( Rational(6, -4).toString(), "-3/2" );
+  }
+
 };